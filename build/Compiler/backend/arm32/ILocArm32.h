@@ -94,11 +94,6 @@ class ILocArm32 {
     /// @brief 符号表
     Module * module;
 
-    /// @brief 加载立即数 ldr r0,=#100
-    /// @param rs_reg_no 结果寄存器号
-    /// @param num 立即数
-    void load_imm(int rs_reg_no, int num);
-
     /// @brief 加载符号值 ldr r0,=g; ldr r0,[r0]
     /// @param rsReg 结果寄存器号
     /// @param name Label名字
@@ -111,6 +106,11 @@ class ILocArm32 {
     void leaStack(int rs_reg_no, int base_reg_no, int offset);
 
 public:
+    /// @brief 加载立即数 ldr r0,=#100
+    /// @param rs_reg_no 结果寄存器号
+    /// @param num 立即数
+    void load_imm(int rs_reg_no, int num);
+
     /// @brief 构造函数
     /// @param _module 符号表-模块
     ILocArm32(Module * _module);
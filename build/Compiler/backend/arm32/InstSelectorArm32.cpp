@@ -29,6 +29,7 @@
 #include "FuncCallInstruction.h"
 #include "MoveInstruction.h"
 #include "BinaryInstruction.h"
+#include "ConstInt.h"
 
 static char *cmpmap[] = {"eq", "ne", "gt", "ge", "lt", "le"};
 
@@ -336,21 +337,141 @@ void InstSelectorArm32::translate_mul_int32(Instruction * inst) {
 }
 
 void InstSelectorArm32::translate_div_int32(Instruction * inst) {
+    if (translate_div_const(inst, false)) {
+        return;
+    }
     translate_two_operator(inst, "sdiv");
 }
 
 void InstSelectorArm32::translate_rem_int32(Instruction * inst) {
-    //BinaryInstruction *bi = (BinaryInstruction*)inst;
-    //Value * lv = bi->getOperand(0);
-    /*int p;
-    if (lv->getType()==IntegerType::getTypeInt() && p>0 && __builtin_popcount(p+1)==1) {
-        // p=2^n-1
-        translate_two_operator(new BinaryInstruction(func, IROP(AND), ));
+    if (translate_div_const(inst, true)) {
+        return;
+    }
+
+    // sdiv q,a,b; mls r,q,b,a
+    Value * arg1 = inst->getOperand(0);
+    Value * arg2 = inst->getOperand(1);
+    int32_t a = arg1->getRegId();
+    if (a == -1) {
+        a = simpleRegisterAllocator.Allocate(arg1);
+        iloc.load_var(a, arg1);
+    }
+    int32_t b = arg2->getRegId();
+    if (b == -1) {
+        b = simpleRegisterAllocator.Allocate(arg2);
+        iloc.load_var(b, arg2);
+    }
+    int32_t res = inst->getRegId() != -1 ? inst->getRegId() : simpleRegisterAllocator.Allocate(inst);
+    int32_t q = simpleRegisterAllocator.Allocate();
+
+    iloc.inst("sdiv", PlatformArm32::regName[q], PlatformArm32::regName[a], PlatformArm32::regName[b]);
+    iloc.inst("mls",
+              PlatformArm32::regName[res],
+              PlatformArm32::regName[q],
+              PlatformArm32::regName[b] + "," + PlatformArm32::regName[a]);
+    if (inst->getRegId() == -1) {
+        iloc.store_var(res, inst, ARM32_TMP_REG_NO);
+    }
+
+    simpleRegisterAllocator.free(q);
+    simpleRegisterAllocator.free(arg1);
+    simpleRegisterAllocator.free(arg2);
+    simpleRegisterAllocator.free(inst);
+}
+
+/// @brief 除数为常量的整数除法与求余，2的幂改为移位，其它改为乘以魔数取高位
+/// @param inst IR指令
+/// @param rem true求余，false除法
+/// @return true 已翻译，false 除数不是常量或者为0、INT32_MIN，仍用sdiv
+bool InstSelectorArm32::translate_div_const(Instruction * inst, bool rem) {
+    ConstInt * divisor = dynamic_cast<ConstInt *>(inst->getOperand(1));
+    if (!divisor || divisor->getVal() == 0 || divisor->getVal() == INT32_MIN) {
+        return false;
+    }
+
+    Value * arg1 = inst->getOperand(0);
+    int32_t d = divisor->getVal();
+    int32_t ad = d < 0 ? -d : d;
+
+    int32_t n = arg1->getRegId();
+    if (n == -1) {
+        n = simpleRegisterAllocator.Allocate(arg1);
+        iloc.load_var(n, arg1);
+    }
+    int32_t res = inst->getRegId() != -1 ? inst->getRegId() : simpleRegisterAllocator.Allocate(inst);
+
+    // smull的低32位与高32位
+    int32_t lo = simpleRegisterAllocator.Allocate();
+    int32_t hi = simpleRegisterAllocator.Allocate();
+    std::string rn = PlatformArm32::regName[n];
+    std::string rl = PlatformArm32::regName[lo];
+    std::string rh = PlatformArm32::regName[hi];
+    std::string rr = PlatformArm32::regName[res];
+
+    if (ad == 1) {
+        // x/1=x，x/-1=-x，余数为0
+        if (rem) {
+            iloc.inst("mov", rr, "#0");
+        } else if (d > 0) {
+            iloc.inst("mov", rr, rn);
+        } else {
+            iloc.inst("rsb", rr, rn, "#0");
+        }
+    } else if ((ad & (ad - 1)) == 0) {
+        // 负数先加上2^k-1再算术右移，使商向0取整
+        int32_t k = __builtin_ctz(ad);
+        if (k == 1) {
+            iloc.inst("add", rh, rn, rn + ",lsr #31");
+        } else {
+            iloc.inst("asr", rh, rn, "#31");
+            iloc.inst("add", rh, rn, rh + ",lsr #" + std::to_string(32 - k));
+        }
+        iloc.inst("asr", rh, rh, "#" + std::to_string(k));
+
+        if (rem) {
+            // x - (q << k)
+            iloc.inst("sub", rr, rn, rh + ",lsl #" + std::to_string(k));
+        } else if (d > 0) {
+            iloc.inst("mov", rr, rh);
+        } else {
+            iloc.inst("rsb", rr, rh, "#0");
+        }
     } else {
-        // __aeabi_idivmod
-        FuncCallInstruction *finst = new FuncCallInstruction(func, __aeabi_idivmod, {1,2,3}, IntegerType::getTypeInt());
-        translate_call(finst);
-    }*/
+        // 商为x*magic的高32位算术右移，被除数为负时再加1
+        int32_t magic, shift;
+        signedDivMagic(ad, &magic, &shift);
+        iloc.load_imm(lo, magic);
+        iloc.inst("smull", rl, rh, rn + "," + rl);
+        if (magic < 0) {
+            // 魔数超过INT32_MAX时按负数相乘，高位少了一个被除数
+            iloc.inst("add", rh, rh, rn);
+        }
+        if (shift) {
+            iloc.inst("asr", rh, rh, "#" + std::to_string(shift));
+        }
+        iloc.inst("sub", rh, rh, rn + ",asr #31");
+
+        if (rem) {
+            // 余数x - q*|d|与除数的符号无关
+            iloc.load_imm(lo, ad);
+            iloc.inst("mls", rr, rh, rl + "," + rn);
+        } else if (d > 0) {
+            iloc.inst("mov", rr, rh);
+        } else {
+            iloc.inst("rsb", rr, rh, "#0");
+        }
+    }
+
+    if (inst->getRegId() == -1) {
+        iloc.store_var(res, inst, ARM32_TMP_REG_NO);
+    }
+
+    simpleRegisterAllocator.free(lo);
+    simpleRegisterAllocator.free(hi);
+    simpleRegisterAllocator.free(arg1);
+    simpleRegisterAllocator.free(inst);
+
+    return true;
 }
 
 void InstSelectorArm32::translate_bi_op(Instruction *inst) {
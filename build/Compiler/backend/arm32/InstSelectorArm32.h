@@ -82,6 +82,12 @@ protected:
 
     void translate_rem_int32(Instruction * inst);
 
+    /// @brief 除数为常量的整数除法与求余，2的幂改为移位，其它改为乘以魔数取高位
+    /// @param inst IR指令
+    /// @param rem true求余，false除法
+    /// @return true 已翻译，false 除数不是常量或者为0、INT32_MIN，仍用sdiv
+    bool translate_div_const(Instruction * inst, bool rem);
+
     /// @brief 二元操作指令翻译成ARM32汇编
     /// @param inst IR指令
     /// @param operator_name 操作码
@@ -18,6 +18,8 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <unordered_map>
 
 #include "Function.h"
 #include "Module.h"
@@ -32,6 +34,16 @@
 #include "MoveInstruction.h"
 #include "PlatformArm64.h"
 #include "ArrayType.h"
+#include "ConstFloat.h"
+#include "Use.h"
+#include "GotoInstruction.h"
+#include "GraphColoringRegisterAllocator.h"
+#include "LivenessArm64.h"
+#include "LiveRangeSplitter.h"
+#include "ShrinkWrapArm64.h"
+#include "PeepholeArm64.h"
+#include "DominatorTree.h"
+#include "LoopInfo.h"
 
 #define DEBUG 1
 #ifdef DEBUG
@@ -41,10 +53,10 @@
 #endif
 
 static int allocateStackSlot(Function *, Type *);
-static void expireOldRanges(std::vector<LiveRange> &active, std::vector<int> &freeRegs, int pos);
-static int findLastUse(Value *val, const std::vector<Instruction*> &insts, int startPos);
-static void extendRangeIfExists(std::vector<LiveRange> &ranges, Value *value, int currentPos);
-static const std::vector<LiveRange> &calculateLiveRanges(Function *func);
+static bool isAddress(Value *);
+static std::vector<LiveRange> calculateLiveRanges(Function *func, LivenessArm64 &liveness, LoopInfo &loopInfo);
+static void scanLiveRanges(std::vector<LiveRange> &ranges, const std::vector<int32_t> &pool,
+                           const std::vector<int32_t> &floatPool);
 
 /// @brief 构造函数
 /// @param tab 符号表
@@ -70,32 +82,84 @@ void CodeGeneratorArm64::genHeader()
           ".endm\n", fp);
 }
 
+/// @brief 数组是否只被读取，即只作为GEP或取地址指令的基址以及读取的地址使用，没有被改写，地址也没有传出
+/// @param val 数组或者其元素的地址
+/// @return true 只被读取
+/// @return false 可能被改写
+static bool onlyLoaded(Value * val)
+{
+    for (auto use: val->getUseList()) {
+        Instanceof(inst, Instruction *, use->getUser());
+        if (!inst) {
+            return false;
+        }
+        if (inst->isDead() || inst->getOp() == IRInstOperator::IRINST_OP_LOAD) {
+            continue;
+        }
+        bool isBase = inst->getOp() == IRInstOperator::IRINST_OP_GEP || inst->getOp() == IRInstOperator::IRINST_OP_ADDR;
+        if (!isBase || inst->getOperand(0) != val || !onlyLoaded(inst)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /// @brief 全局变量Section，主要包含初始化的和未初始化过的
 void CodeGeneratorArm64::genDataSection()
 {
-
     // 可直接操作文件指针fp进行写操作
 
-    // 目前不支持全局变量和静态变量，以及字符串常量
-    // 全局变量分两种情况：初始化的全局变量和未初始化的全局变量
-    // TODO 这里先处理未初始化的全局变量
+    // 全局变量分两种情况：初值全为0的全局变量和有非0初值的全局变量
     for (auto var: module->getGlobalVariables()) {
+        std::string name = var->getName();
 
         if (var->isInBSSSection()) {
 
             // 在BSS段的全局变量，可以包含初值全是0的变量
-            fprintf(fp, ".comm %s, %d, %d\n", var->getName().c_str(), var->getType()->getSize(), var->getAlignment());
-        } else {
+            fprintf(fp, ".comm %s, %d, %d\n", name.c_str(), var->getType()->getSize(), var->getAlignment());
+            continue;
+        }
+
+        // 有初值的全局变量，没有被改写的数组放在只读数据段
+        bool isArray = var->getType()->isArrayType();
+        fputs(isArray && onlyLoaded(var) ? ".section .rodata\n" : ".data\n", fp);
+        fprintf(fp, ".globl %s\n", name.c_str());
+        fprintf(fp, ".type %s, @object\n", name.c_str());
+        fprintf(fp, ".align 2\n");
+        fprintf(fp, "%s:\n", name.c_str());
 
-            // 有初值的全局变量
-            fprintf(fp, ".type %s, @object\n", var->getName().c_str());
-            fputs(".data\n", fp);
-            fprintf(fp, ".globl %s\n", var->getName().c_str());
-            fprintf(fp, ".align 2\n");
-            fprintf(fp, "%s:\n", var->getName().c_str());
+        if (!isArray) {
             fprintf(fp, ".word 0x%x\n", var->intVal);
-            // TODO 数组初值
+        } else {
+            // 连续的非0初值每行最多8个，连续的0合并为.zero
+            bool isFloat = static_cast<const ArrayType *>(var->getType())->getBaseElementType()->isFloatType();
+            std::vector<Value *> & vals = var->arrayInit;
+            for (size_t k = 0; k < vals.size();) {
+                size_t end = k;
+                if (!vals[k]) {
+                    while (end < vals.size() && !vals[end]) {
+                        end++;
+                    }
+                    fprintf(fp, ".zero %d\n", (int32_t) (end - k) * 4);
+                } else {
+                    std::string line;
+                    while (end < vals.size() && vals[end] && end - k < 8) {
+                        char buf[32];
+                        if (isFloat) {
+                            snprintf(buf, sizeof(buf), "%.9g", static_cast<ConstFloat *>(vals[end])->getVal());
+                        } else {
+                            snprintf(buf, sizeof(buf), "%d", static_cast<ConstInt *>(vals[end])->getVal());
+                        }
+                        line += (line.empty() ? "" : ",") + std::string(buf);
+                        end++;
+                    }
+                    fprintf(fp, "%s %s\n", isFloat ? ".float" : ".word", line.c_str());
+                }
+                k = end;
+            }
         }
+        fprintf(fp, ".size %s, %d\n", name.c_str(), var->getType()->getSize());
     }
 }
 
@@ -145,7 +209,8 @@ void CodeGeneratorArm64::genCodeSection(Function * func)
 
     // 汇编指令输出前要确保Label的名字有效，必须是程序级别的唯一，而不是函数内的唯一。要全局编号。
     for (auto inst: IrInsts) {
-        if (inst->getOp() == IRInstOperator::IRINST_OP_LABEL) {
+        // 内存块清零的循环也需要Label
+        if (inst->getOp() == IRInstOperator::IRINST_OP_LABEL || inst->getOp() == IRInstOperator::IRINST_OP_MEMSET) {
             inst->setName(IR_LABEL_PREFIX + std::to_string(labelIndex++));
         }
     }
@@ -159,6 +224,10 @@ void CodeGeneratorArm64::genCodeSection(Function * func)
     //this->showLinearIR);
     instSelector.run();
 
+    // 汇编指令序列上的窥孔优化
+    PeepholeArm64 peephole(iloc.getCode());
+    peephole.run();
+
     // 删除无用的Label指令
     iloc.deleteUsedLabel();
 
@@ -218,15 +287,26 @@ void CodeGeneratorArm64::registerAllocation(Function * func)
         protectedRegNo.push_back(ARM64_LR_REG_NO);
     }
 
-    // 1. 计算活跃区间
-    std::vector<LiveRange> ranges = calculateLiveRanges(func);
+    // 局部数组分配在栈内
+    for (auto var : func->getVarValues()) {
+        if (var->getType()->isArrayType()) {
+            var->setMemoryAddr(ARM64_FP_REG_NO, allocateStackSlot(func, var->getType()));
+        }
+    }
+
+    // 1. 活跃变量分析，需要控制流图，分配后恢复线性IR指令序列
+    func->buildBlocks();
+    LivenessArm64 liveness(func);
 
-    // 2. 按起始位置排序
-    std::sort(ranges.begin(), ranges.end(), 
-        [](const LiveRange &a, const LiveRange &b) { return a.start < b.start; });
+    if (graphColoring) {
+        // 2-3. 图着色分配寄存器
+        graphColoringRegisterAllocation(func, liveness);
+    } else {
+        // 2-3. 线性扫描分配寄存器
+        linearScanRegisterAllocation(func, liveness);
+    }
 
-    // 3. 分配寄存器
-    linearScanRegisterAllocation(ranges, func);
+    func->linearizeBlocks();
 
     // 4. 处理剩余逻辑（如保护寄存器）
     adjustFuncCallInsts(func);
@@ -237,6 +317,15 @@ void CodeGeneratorArm64::registerAllocation(Function * func)
 
     adjustFormalParamInsts(func);
 
+    // 6. 栈内没有变量且没有栈传递的形参时不需要fp寄存器，叶子函数可以完全不建立栈帧
+    if (!ILocArm64::useFramePointer(func)) {
+        protectedRegNo.erase(std::find(protectedRegNo.begin(), protectedRegNo.end(), ARM64_FP_REG_NO));
+    }
+
+    // 7. 栈帧的建立与恢复下沉到需要栈帧的基本块
+    ShrinkWrapArm64 shrinkWrap(func);
+    shrinkWrap.run();
+
 #if 0
     // 临时输出调整后的IR指令，用于查看当前的寄存器分配、栈内变量分配、实参入栈等信息的正确性
     std::string irCodeStr;
@@ -254,46 +343,37 @@ void CodeGeneratorArm64::adjustFormalParamInsts(Function * func)
     // 如果不是不能使用这里的代码
     auto & params = func->getParams();
 
-    // 形参的前8个通过寄存器来传值R0-R7
-    // 先排除需要函数调用的参数，这些参数需要重新分配寄存器
-    //int k = std::max((int)func->getExistFuncCall(), func->getMaxFuncCallArgCnt());
-    int pm = func->getExistFuncCall()?params.size():0;
-    int k;
-    std::vector<Instruction*> moves(std::min(8, pm));
-    for (k = 0; k < std::min(8, pm); k++) {
-        moves[k] = new MoveInstruction(func, params[k], PlatformArm64::intRegVal[k]);
-    }
-    auto &insts = func->getInterCode().getInsts();
-    insts.insert(insts.begin()+1, moves.begin(), moves.end());
-
+    // 形参通过寄存器来传值，整数形参使用x0-x7，浮点形参使用s0-s7，分别编号
+    // 有函数调用时传参寄存器会被改写，形参已分配了别的寄存器，入口处从传参寄存器Move过去
+    // 没有函数调用时直接使用传参寄存器
+    std::vector<Instruction*> moves;
     auto &protects = func->getProtectedReg();
-    pm = params.size();
-
-    for (int j = std::min(pm, 8); k < j; k++) {
+    int32_t intCnt = 0, floatCnt = 0;
 
-        // 前8个设置分配寄存器
-        int32_t reg = params[k]->getRegId();
-        if (ARM64_CALLER_SAVE(reg)) {
-            std::remove(protects.begin(), protects.end(), reg);
-        }
-        params[k]->setRegId(k);
+    // 根据ARM64版C语言的调用约定，传参寄存器之外的实参进行值传递，在保护的寄存器之上，逆序入栈
+    int32_t intSaved = 0, floatSaved = 0;
+    for (auto reg : protects) {
+        ARM64_IS_FREG(reg) ? floatSaved++ : intSaved++;
     }
-
-    // 根据ARM64版C语言的调用约定，除前8个外的实参进行值传递，逆序入栈
-    int64_t fp_esp = func->getMaxDep() + (func->getProtectedReg().size() * 4);
-    for (; k < pm; k++) {
-
-        // 目前假定变量大小都是4字节。实际要根据类型来计算
-        int32_t reg = params[k]->getRegId();
-        if (ARM64_CALLER_SAVE(reg)) {
-            std::remove(protects.begin(), protects.end(), reg);
-            params[k]->setRegId(-1);
+    int64_t fp_esp = func->getMaxDep() + ((intSaved + 1) / 2 + (floatSaved + 1) / 2) * 16;
+
+    for (auto param : params) {
+        int32_t reg = PlatformArm64::argRegNo(param, intCnt, floatCnt);
+        if (reg == -1) {
+            // 目前假定变量大小都是4字节。实际要根据类型来计算
+            param->setMemoryAddr(ARM64_FP_REG_NO, fp_esp);
+
+            // 增加4字节
+            fp_esp += 4;
+        } else if (func->getExistFuncCall()) {
+            moves.push_back(new MoveInstruction(func, param, PlatformArm64::regVal(reg)));
+        } else {
+            param->setRegId(reg);
         }
-        params[k]->setMemoryAddr(ARM64_FP_REG_NO, fp_esp);
-
-        // 增加4字节
-        fp_esp += 4;
     }
+
+    auto &insts = func->getInterCode().getInsts();
+    insts.insert(insts.begin()+1, moves.begin(), moves.end());
 }
 
 /// @brief 寄存器分配前对函数内的指令进行调整，以便方便寄存器分配
@@ -311,16 +391,18 @@ void CodeGeneratorArm64::adjustFuncCallInsts(Function * func)
         // 检查是否是函数调用指令，并且含有返回值
         if (Instanceof(callInst, FuncCallInstruction *, *pIter)) {
 
-            // 实参前8个要寄存器传值，其它参数通过栈传递
-            // 前8个的后面参数采用栈传递
+            // 整数实参的前8个用x0-x7，浮点实参的前8个用s0-s7，其它参数通过栈传递
+            // 先处理栈传递的参数，以免改写已经设置好的传参寄存器
             int esp = 0;
-            for (int32_t k = 8, l = callInst->getOperandsNum(); k < l; k++) {
+            int32_t intCnt = 0, floatCnt = 0;
+            for (int32_t k = 0, l = callInst->getOperandsNum(); k < l; k++) {
 
                 auto arg = callInst->getOperand(k);
                 if (arg == callInst) break;
+                if (PlatformArm64::argRegNo(arg, intCnt, floatCnt) != -1) continue;
 
                 // 新建一个内存变量，用于栈传值到形参变量中
-                LocalVariable * newVal = func->newLocalVarValue(IntegerType::getTypeInt());
+                LocalVariable * newVal = func->newLocalVarValue(arg->getType());
                 newVal->setMemoryAddr(ARM64_SP_REG_NO, esp);
                 esp += 4;
 
@@ -333,7 +415,8 @@ void CodeGeneratorArm64::adjustFuncCallInsts(Function * func)
                 pIter++;
             }
 
-            for (int k = 0, l = std::min(callInst->getOperandsNum(), 8); k < l; k++) {
+            intCnt = floatCnt = 0;
+            for (int k = 0, l = callInst->getOperandsNum(); k < l; k++) {
 
                 // 检查实参的类型是否是临时变量。
                 // 如果是临时变量，该变量可更改为寄存器变量即可，或者设置寄存器号
@@ -341,16 +424,19 @@ void CodeGeneratorArm64::adjustFuncCallInsts(Function * func)
                 auto arg = callInst->getOperand(k);
                 if (arg == callInst) break;
 
-                if (arg->getRegId() == k) {
+                int32_t reg = PlatformArm64::argRegNo(arg, intCnt, floatCnt);
+                if (reg == -1) {
+                    continue;
+                } else if (arg->getRegId() == reg) {
                     // 则说明寄存器已经是实参传递的寄存器，不用创建赋值指令
                     continue;
                 } else {
                     // 创建临时变量，指定寄存器
 
                     Instruction * assignInst =
-                        new MoveInstruction(func, PlatformArm64::intRegVal[k], callInst->getOperand(k));
+                        new MoveInstruction(func, PlatformArm64::regVal(reg), callInst->getOperand(k));
 
-                    callInst->setOperand(k, PlatformArm64::intRegVal[k]);
+                    callInst->setOperand(k, PlatformArm64::regVal(reg));
 
                     // 函数调用指令前插入后，pIter仍指向函数调用指令
                     pIter = insts.insert(pIter, assignInst);
@@ -370,16 +456,17 @@ void CodeGeneratorArm64::adjustFuncCallInsts(Function * func)
             // 有arg指令后可不用参数，展示不删除
             // args.clear();
 
-            // 赋值指令
+            // 赋值指令，浮点返回值在s0中
             if (callInst->hasResultValue()) {
 
-                if (callInst->getRegId() == 0) {
+                int32_t retReg = PlatformArm64::isFloatValue(callInst) ? ARM64_FREG(0) : 0;
+                if (callInst->getRegId() == retReg) {
                     // 结果变量的寄存器和返回值寄存器一样，则什么都不需要做
                     ;
                 } else {
                     // 其它情况，需要产生赋值指令
                     // 新建一个赋值操作
-                    Instruction * assignInst = new MoveInstruction(func, callInst, PlatformArm64::intRegVal[0]);
+                    Instruction * assignInst = new MoveInstruction(func, callInst, PlatformArm64::regVal(retReg));
 
                     // 函数调用指令的下一个指令的前面插入指令，因为有Exit指令，+1肯定有效
                     pIter = insts.insert(pIter + 1, assignInst);
@@ -462,121 +549,369 @@ void CodeGeneratorArm64::stackAlloc(Function * func)
     func->setMaxDep(sp_esp);
 }
 
-const std::vector<LiveRange> &calculateLiveRanges(Function *func) {
-    auto ranges = new std::vector<LiveRange>();
-    const auto &insts = func->getInterCode().getInsts();
-
-    // 遍历指令，记录变量的定义和使用位置
-    for (int pos = 0, l = insts.size(); pos < l; ++pos) {
-        Instruction *inst = insts[pos];
-        
-        // 处理定义（赋值）
-        if (inst->hasResultValue()) {
-            LiveRange range;
-            range.value = inst;
-            range.start = pos;
-            range.end = findLastUse(inst, insts, pos);
-            ranges->push_back(range);
+// 根据基本块出口的活跃集合逆序扫描指令，得到每个值带空洞的活跃区间。
+// 第i条指令读操作数的位置为2i，写结果的位置为2i+1，最后一次使用与新的定义可以共用寄存器。
+// 同时统计溢出权重，循环内的定义与使用按10的嵌套深度次方计算，再除以区间长度，长而少用的区间权重低。
+// 函数调用写结果的位置上仍活跃的其它值跨越了该调用，记录下来用于选择调用者或被调用者保存的寄存器。
+std::vector<LiveRange> calculateLiveRanges(Function *func, LivenessArm64 &liveness, LoopInfo &loopInfo) {
+    int n = liveness.getValueCount();
+    std::vector<double> weights(n, 0);
+
+    // 函数调用指令、所在位置以及循环权重
+    struct CallSite {
+        Instruction *inst;
+        int pos;
+        double weight;
+    };
+    std::vector<CallSite> callSites;
+    std::vector<std::vector<Value *>> hints(n);
+
+    // 区间段按位置从大到小生成，逆序保存，最后再反转
+    std::vector<std::vector<std::pair<int, int>>> segs(n);
+    auto addRange = [&](int v, int from, int to) {
+        auto &s = segs[v];
+        if (!s.empty() && s.back().first <= to) {
+            s.back().first = std::min(s.back().first, from);
+        } else {
+            s.emplace_back(from, to);
+        }
+    };
+
+    auto &blocks = func->getBlocks();
+    std::vector<int> blockFrom(blocks.size());
+    int pos = 0;
+    for (auto block : blocks) {
+        blockFrom[block->getIndex()] = pos;
+        pos += 2 * (int) block->getInsts().size();
+    }
+
+    std::vector<int32_t> defs, uses, liveOut;
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+        BasicBlock *block = *it;
+        int from = blockFrom[block->getIndex()];
+        auto &insts = block->getInsts();
+        int to = from + 2 * (int) insts.size();
+        double weight = std::pow(10.0, std::min(loopInfo.getLoopDepth(block), 6));
+
+        // 出口活跃的值先假定整个基本块都活跃，遇到定义时再截断
+        liveness.getLiveOut(block, liveOut);
+        for (int v : liveOut) {
+            addRange(v, from, to);
         }
 
-        // 处理操作数（使用）
-        for (int i = 0; i < inst->getOperandsNum(); ++i) {
-            Value *operand = inst->getOperand(i);
-            if (operand==inst) continue;
-            if (dynamic_cast<Instruction*>(operand)
-             || dynamic_cast<LocalVariable*>(operand)
-             || dynamic_cast<FormalParam*>(operand)) {
-                extendRangeIfExists(*ranges, operand, pos);
+        for (int k = (int) insts.size() - 1; k >= 0; --k) {
+            Instruction *inst = insts[k];
+            if (inst->isDead()) continue;
+            int usePos = from + 2 * k, defPos = usePos + 1;
+
+            if (inst->getOp() == IRInstOperator::IRINST_OP_FUNC_CALL) {
+                callSites.push_back({inst, defPos, weight});
+            } else if (inst->getOp() == IRInstOperator::IRINST_OP_ASSIGN) {
+                int dst = liveness.getIndex(inst->getOperand(0)), src = liveness.getIndex(inst->getOperand(1));
+                if (dst != -1 && src != -1 && dst != src) {
+                    hints[dst].push_back(inst->getOperand(1));
+                    hints[src].push_back(inst->getOperand(0));
+                }
+            }
+
+            liveness.getDefs(inst, defs);
+            for (int v : defs) {
+                weights[v] += weight;
+                auto &s = segs[v];
+                if (!s.empty() && s.back().first <= defPos) {
+                    s.back().first = defPos;
+                } else {
+                    // 定义后没有使用，也要占用寄存器
+                    s.emplace_back(defPos, defPos + 1);
+                }
+            }
+
+            liveness.getUses(inst, uses);
+            for (int v : uses) {
+                weights[v] += weight;
+                addRange(v, from, usePos + 1);
+            }
+        }
+    }
+
+    std::vector<LiveRange> ranges;
+    for (int v = 0; v < n; ++v) {
+        if (segs[v].empty() || !liveness.isAllocatable(v)) continue;
+        LiveRange range;
+        range.value = liveness.getValue(v);
+        range.segments.assign(segs[v].rbegin(), segs[v].rend());
+        range.start = range.segments.front().first;
+        range.end = range.segments.back().second;
+        range.weight = weights[v] / (range.end - range.start);
+        range.spillCost = weights[v];
+        range.hints = hints[v];
+        for (auto &call : callSites) {
+            if (call.inst != range.value && range.covers(call.pos)) {
+                range.calls.push_back(call.inst);
+                range.saveCost += 2 * call.weight;
             }
         }
+        ranges.push_back(range);
     }
-    return *ranges;
+    return ranges;
 }
 
-void CodeGeneratorArm64::linearScanRegisterAllocation(
-    std::vector<LiveRange> &ranges, Function *func) 
+/// @brief 线性扫描寄存器分配，溢出的值在循环边界处拆分后重新分配，最后溢出的值分配在栈内
+/// @param func 要处理的函数，要求已经划分了基本块
+/// @param liveness 函数的活跃变量分析结果，拆分后重新计算
+void CodeGeneratorArm64::linearScanRegisterAllocation(Function *func, LivenessArm64 &liveness)
 {
-    // 使用被调用者保留寄存器
-    std::vector<int32_t> freeRegs = {19, 20, 21, 22, 23, 24, 25, 26, 27, 28}; // x9-x15
-    if (!func->getExistFuncCall()) {
-        freeRegs.insert(freeRegs.end(), {9, 10, 11, 12, 13, 14, 15}); // x9-x15
+    // 被调用者保留寄存器x19-x28，以及调用者保存的x9-x15，不跨越函数调用的区间可直接使用后者
+    std::vector<int32_t> pool = {19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 9, 10, 11, 12, 13, 14, 15};
+
+    // 浮点值单独使用浮点寄存器，被调用者保留s8-s15，调用者保存的s18-s31
+    std::vector<int32_t> floatPool;
+    for (int32_t k = 8; k <= 15; k++) {
+        floatPool.push_back(ARM64_FREG(k));
+    }
+    for (int32_t k = 18; k <= 31; k++) {
+        floatPool.push_back(ARM64_FREG(k));
     }
-    std::vector<LiveRange> active;
-    auto &protects = func->getProtectedReg();
 
-    for (auto &range : ranges) {
-        // 1. 过期已结束的区间
-        expireOldRanges(active, freeRegs, range.start);
-
-        // 2. 分配寄存器
-        if (!(range.value->getType()->isArrayType() || freeRegs.empty())) {
-            range.reg = freeRegs.back();
-            freeRegs.pop_back();
-            active.push_back(range);
-        } else {
-            // 3. 溢出到栈
-            range.stackOffset = allocateStackSlot(func, range.value->getType());
+    // 拆分只在已有的基本块内插入复制指令，控制流图不变，循环分析一直有效
+    DominatorTree domTree(func);
+    LoopInfo loopInfo(func, domTree);
+    LiveRangeSplitter splitter(func, loopInfo);
+
+    // 每轮拆分后内层循环的部分若仍溢出，下一轮再到更内层的循环拆分
+    const int maxSplitRounds = 4;
+
+    std::vector<LiveRange> ranges;
+    for (int round = 0;; round++) {
+        // 计算带空洞的活跃区间，按起始位置排序
+        ranges = calculateLiveRanges(func, liveness, loopInfo);
+        std::sort(ranges.begin(), ranges.end(),
+            [](const LiveRange &a, const LiveRange &b) { return a.start < b.start; });
+
+        scanLiveRanges(ranges, pool, floatPool);
+
+        std::vector<Value *> spilled;
+        for (const auto &range : ranges) {
+            if (range.reg == -1) {
+                spilled.push_back(range.value);
+            }
         }
+        if (spilled.empty() || round == maxSplitRounds || !splitter.run(spilled, liveness)) {
+            break;
+        }
+
+        liveness = LivenessArm64(func);
     }
 
-    // 4. 更新变量的寄存器或栈偏移
-    for (const auto &range : ranges) {
+    // 更新变量的寄存器或栈偏移
+    auto &protects = func->getProtectedReg();
+    std::unordered_map<Instruction *, std::vector<std::pair<Value *, LocalVariable *>>> saves;
+    for (auto &range : ranges) {
         if (range.reg != -1) {
             range.value->setRegId(range.reg);
-            if (ARM64_CALLER_SAVE(range.reg) && std::find(protects.begin(), protects.end(), range.reg)==protects.end())
-                protects.push_back(range.reg);
-        } else {
+            if (ARM64_CALLER_SAVE(range.reg) || ARM64_FREG_SAVE(range.reg)) {
+                if (std::find(protects.begin(), protects.end(), range.reg) == protects.end())
+                    protects.push_back(range.reg);
+            } else if (!range.calls.empty() && isAddress(range.value)) {
+                // 全局数组与GEP的地址不必保存，在使用处重新计算
+                range.value->setRegId(-1);
+            } else if (!range.calls.empty()) {
+                // 跨越函数调用的调用者保存寄存器，在栈内保存
+                LocalVariable *slot = func->newLocalVarValue(range.value->getType());
+                slot->setMemoryAddr(ARM64_FP_REG_NO, allocateStackSlot(func, range.value->getType()));
+                for (auto call : range.calls) {
+                    saves[call].emplace_back(range.value, slot);
+                }
+            }
+        } else if (!isAddress(range.value)) {
+            range.stackOffset = allocateStackSlot(func, range.value->getType());
             range.value->setMemoryAddr(ARM64_FP_REG_NO, range.stackOffset);
         }
     }
+
+    // 函数调用前保存，调用后恢复
+    for (auto block : func->getBlocks()) {
+        auto &insts = block->getInsts();
+        for (auto it = insts.begin(); it != insts.end(); ++it) {
+            auto found = saves.find(*it);
+            if (found == saves.end()) continue;
+            for (auto &save : found->second) {
+                it = insts.insert(it, new MoveInstruction(func, save.second, save.first));
+                ++it;
+            }
+            for (auto &save : found->second) {
+                it = insts.insert(it + 1, new MoveInstruction(func, save.first, save.second));
+            }
+        }
+    }
 }
 
-// 查找变量的最后一次使用
-int findLastUse(Value *val, const std::vector<Instruction*> &insts, int startPos) {
-    for (int i = insts.size() - 1; i >= startPos; --i) {
-        for (int j = 0; j < insts[i]->getOperandsNum(); ++j) {
-            if (insts[i]->getOperand(j) == val) {
-                return i;
+// 按起始位置扫描活跃区间分配寄存器。没有空闲寄存器时，与占用寄存器的区间比较溢出权重，
+// 权重小的一方溢出，避免循环内频繁使用的值因为来得晚而溢出。
+// 不跨越函数调用的区间优先使用调用者保存的寄存器，跨越函数调用的区间优先使用被调用者保存的寄存器，
+// 没有时若在调用前后保存、恢复的代价比溢出小，也可以使用调用者保存的寄存器。
+// 与已分配的区间通过Move指令相互复制时，优先使用其寄存器。
+void scanLiveRanges(std::vector<LiveRange> &ranges, const std::vector<int32_t> &pool,
+                    const std::vector<int32_t> &floatPool)
+{
+    std::unordered_map<Value *, LiveRange *> rangeOf;
+    for (auto &range : ranges) {
+        rangeOf[range.value] = &range;
+    }
+
+    // active为当前位置活跃的区间，inactive为已开始但当前位置处于空洞中的区间
+    std::vector<LiveRange *> active, inactive;
+
+    for (auto &range : ranges) {
+        int pos = range.start;
+
+        // 1. 结束的区间释放寄存器，进入或离开空洞的区间在active与inactive之间移动
+        for (auto it = active.begin(); it != active.end(); ) {
+            if ((*it)->end <= pos) {
+                it = active.erase(it);
+            } else if (!(*it)->covers(pos)) {
+                inactive.push_back(*it);
+                it = active.erase(it);
+            } else {
+                ++it;
             }
         }
+        for (auto it = inactive.begin(); it != inactive.end(); ) {
+            if ((*it)->end <= pos) {
+                it = inactive.erase(it);
+            } else if ((*it)->covers(pos)) {
+                active.push_back(*it);
+                it = inactive.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // 2. 活跃区间的寄存器不可用，空洞中的区间与当前区间重叠时其寄存器也不可用
+        bool crossCall = !range.calls.empty();
+        bool allowCallerSave = !crossCall || range.saveCost < range.spillCost;
+        std::vector<int32_t> freeRegs;
+        LiveRange *victim = nullptr;
+        for (int32_t reg : PlatformArm64::isFloatValue(range.value) ? floatPool : pool) {
+            bool calleeSave = ARM64_CALLER_SAVE(reg) || ARM64_FREG_SAVE(reg);
+            if (!calleeSave && !allowCallerSave) {
+                continue;
+            }
+            LiveRange *holder = nullptr;
+            bool blocked = false;
+            for (auto other : active) {
+                if (other->reg == reg) {
+                    holder = other;
+                }
+            }
+            for (auto other : inactive) {
+                blocked = blocked || (other->reg == reg && other->overlaps(range));
+            }
+            if (!holder && !blocked) {
+                freeRegs.push_back(reg);
+            } else if (holder && !blocked && (!victim || holder->weight < victim->weight)) {
+                // 只被一个活跃区间占用的寄存器，可以让该区间溢出后使用
+                victim = holder;
+            }
+        }
+
+        // 3. 分配寄存器，没有则溢出权重小的区间。寄存器池中被调用者保存的在前，从后面取是优先调用者保存的
+        int32_t freeReg = -1;
+        if (!freeRegs.empty()) {
+            // 复制到跨越函数调用的值时同样优先被调用者保存的寄存器，以便对方沿用
+            bool preferCallee = crossCall;
+            for (auto hint : range.hints) {
+                auto other = rangeOf.find(hint);
+                preferCallee = preferCallee || (other != rangeOf.end() && !other->second->calls.empty());
+            }
+            freeReg = freeRegs.back();
+            if (preferCallee) {
+                auto callee = std::find_if(freeRegs.begin(), freeRegs.end(),
+                    [](int32_t reg) { return ARM64_CALLER_SAVE(reg) || ARM64_FREG_SAVE(reg); });
+                if (callee != freeRegs.end()) {
+                    freeReg = *callee;
+                }
+            }
+            for (auto hint : range.hints) {
+                auto other = rangeOf.find(hint);
+                if (other != rangeOf.end() && other->second->reg != -1
+                    && std::find(freeRegs.begin(), freeRegs.end(), other->second->reg) != freeRegs.end()) {
+                    freeReg = other->second->reg;
+                    break;
+                }
+            }
+        }
+
+        // 跨越函数调用却只剩调用者保存的寄存器时，保存、恢复的代价比溢出别的区间大则溢出别的区间
+        bool evict = victim && victim->weight < range.weight;
+        bool saveAroundCalls = freeReg != -1 && crossCall && !ARM64_CALLER_SAVE(freeReg) && !ARM64_FREG_SAVE(freeReg);
+        if (freeReg != -1 && !(saveAroundCalls && evict && victim->spillCost < range.saveCost)) {
+            range.reg = freeReg;
+            active.push_back(&range);
+        } else if (evict) {
+            range.reg = victim->reg;
+            victim->reg = -1;
+            active.erase(std::find(active.begin(), active.end(), victim));
+            active.push_back(&range);
+        }
     }
-    return startPos;
 }
 
-// 释放已结束的区间
-void expireOldRanges(std::vector<LiveRange> &active, std::vector<int> &freeRegs, int pos) {
-    for (auto it = active.begin(); it != active.end(); ) {
-        if (it->end <= pos) {
-            freeRegs.push_back(it->reg);
-            it = active.erase(it);
-        } else {
-            ++it;
+/// @brief 图着色寄存器分配，溢出的值分配在栈内
+/// @param func 要处理的函数，要求已经划分了基本块
+/// @param liveness 函数的活跃变量分析结果
+void CodeGeneratorArm64::graphColoringRegisterAllocation(Function * func, LivenessArm64 & liveness)
+{
+    // 与线性扫描相同的寄存器池，没有函数调用时x9-x15不需要保护，优先使用
+    std::vector<int32_t> regs;
+    if (!func->getExistFuncCall()) {
+        regs = {9, 10, 11, 12, 13, 14, 15};
+    }
+    regs.insert(regs.end(), {19, 20, 21, 22, 23, 24, 25, 26, 27, 28});
+
+    // 浮点寄存器单独着色，没有函数调用时s18-s31不需要保护，优先使用
+    std::vector<int32_t> floatRegs;
+    if (!func->getExistFuncCall()) {
+        for (int32_t k = 18; k <= 31; k++) {
+            floatRegs.push_back(ARM64_FREG(k));
+        }
+    }
+    for (int32_t k = 8; k <= 15; k++) {
+        floatRegs.push_back(ARM64_FREG(k));
+    }
+
+    auto &protects = func->getProtectedReg();
+    for (bool floatClass : {false, true}) {
+        GraphColoringRegisterAllocator allocator(func, liveness, floatClass ? floatRegs : regs, floatClass);
+        allocator.run();
+
+        for (auto &assign : allocator.getAssignment()) {
+            Value *val = assign.first;
+            int32_t reg = assign.second;
+            if (reg != -1) {
+                val->setRegId(reg);
+                if ((ARM64_CALLER_SAVE(reg) || ARM64_FREG_SAVE(reg))
+                    && std::find(protects.begin(), protects.end(), reg) == protects.end())
+                    protects.push_back(reg);
+            } else if (!isAddress(val)) {
+                val->setMemoryAddr(ARM64_FP_REG_NO, allocateStackSlot(func, val->getType()));
+            }
         }
     }
 }
 
+/// @brief 是否为全局数组的取地址指令或GEP，没有寄存器时在使用处重新计算地址，不需要栈槽
+/// @param val 值
+/// @return true 是取地址指令或GEP
+/// @return false 不是
+bool isAddress(Value *val) {
+    Instanceof(inst, Instruction *, val);
+    return inst && (inst->getOp() == IRInstOperator::IRINST_OP_ADDR || inst->getOp() == IRInstOperator::IRINST_OP_GEP);
+}
+
 // 分配栈槽
 int allocateStackSlot(Function *func, Type *type) {
     int offset = func->getMaxDep();
     func->setMaxDep(offset + type->getSize()); // 假设4字节对齐
     return offset;
 }
-
-void extendRangeIfExists(std::vector<LiveRange> &ranges, Value *value, int currentPos) {
-    for (auto &range : ranges) {
-        if (range.value == value) {
-            // 扩展活跃范围到当前指令位置
-            range.end = std::max(range.end, currentPos);
-            return;
-        }
-    }
-    // 如果未找到匹配的LiveRange，新的定义
-    //Instanceof(cz, ConstInt*, value);
-    if (!dynamic_cast<ConstInt*>(value)) {
-        LiveRange lr;
-        lr.value = value;
-        lr.start = dynamic_cast<FormalParam*>(value)==nullptr?currentPos:0;
-        lr.end = currentPos;
-        ranges.push_back(lr);
-    }
-}
@@ -3,15 +3,43 @@
 #include "Instruction.h"
 #include <vector>
 
+class LivenessArm64;
+
 struct LiveRange {
     Value *value;     // 关联的变量/临时值
-    int start;        // 起始指令位置（按指令序号）
-    int end;          // 结束指令位置
+    int start;        // 起始位置，即第一段的起点
+    int end;          // 结束位置（不含），即最后一段的终点
+    std::vector<std::pair<int, int>> segments; // 活跃的区间段[起点,终点)，从小到大，段之间是空洞
     int reg = -1;     // 分配的寄存器编号（-1表示未分配）
     int stackOffset = -1; // 溢出时的栈偏移
+    double weight = 0;    // 溢出权重，定义与使用按10的循环深度次方累加后除以区间长度
+    double spillCost = 0; // 溢出代价，定义与使用按10的循环深度次方累加
+    double saveCost = 0;  // 使用调用者保存的寄存器时在跨越的函数调用前后保存、恢复的代价
+    std::vector<Instruction *> calls; // 跨越的函数调用，即调用前后都活跃
+    std::vector<Value *> hints;       // 通过Move指令相互复制的值，分配相同的寄存器可消除复制
+
+    // 位置pos处是否活跃
+    [[nodiscard]] bool covers(int pos) const {
+        for (auto &seg : segments) {
+            if (pos < seg.first) return false;
+            if (pos < seg.second) return true;
+        }
+        return false;
+    }
 
+    // 两个区间是否有同时活跃的位置，空洞处不算
     [[nodiscard]] bool overlaps(const LiveRange &other) const {
-        return !(end < other.start || start > other.end);
+        size_t i = 0, j = 0;
+        while (i < segments.size() && j < other.segments.size()) {
+            if (segments[i].second <= other.segments[j].first) {
+                i++;
+            } else if (other.segments[j].second <= segments[i].first) {
+                j++;
+            } else {
+                return true;
+            }
+        }
+        return false;
     }
 };
 
@@ -58,11 +86,32 @@ protected:
     ///
     void getIRValueStr(Value * val, std::string & str);
 
-    void linearScanRegisterAllocation(std::vector<LiveRange> &ranges, Function *func);
+    /// @brief 线性扫描寄存器分配，溢出的值在循环边界处拆分后重新分配，最后溢出的值分配在栈内
+    /// @param func 要处理的函数，要求已经划分了基本块
+    /// @param liveness 函数的活跃变量分析结果，拆分后重新计算
+    void linearScanRegisterAllocation(Function * func, LivenessArm64 & liveness);
+
+    /// @brief 图着色寄存器分配，溢出的值分配在栈内
+    /// @param func 要处理的函数，要求已经划分了基本块
+    /// @param liveness 函数的活跃变量分析结果
+    void graphColoringRegisterAllocation(Function * func, LivenessArm64 & liveness);
+
+public:
+    /// @brief 设置是否采用图着色寄存器分配，否则采用线性扫描
+    /// @param enable true：图着色，false：线性扫描
+    void setGraphColoring(bool enable)
+    {
+        this->graphColoring = enable;
+    }
 
 private:
     ///
     /// @brief 简单的朴素寄存器分配方法
     ///
     SimpleRegisterAllocator simpleRegisterAllocator;
+
+    ///
+    /// @brief 是否采用图着色寄存器分配
+    ///
+    bool graphColoring = false;
 };
@@ -0,0 +1,342 @@
+///
+/// @file GraphColoringRegisterAllocator.cpp
+/// @brief 基于图着色的寄存器分配
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+#include "GraphColoringRegisterAllocator.h"
+#include "LivenessArm64.h"
+#include "DominatorTree.h"
+#include "LoopInfo.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "PlatformArm64.h"
+
+///
+/// @brief 构造函数
+/// @param _func 函数，要求已经划分了基本块
+/// @param _liveness 函数的活跃变量分析结果
+/// @param _regs 可用的寄存器，越靠前越优先使用
+/// @param _floatClass 为浮点值还是其它值分配寄存器，两类寄存器互不冲突，分别着色
+///
+GraphColoringRegisterAllocator::GraphColoringRegisterAllocator(Function * _func,
+                                                               LivenessArm64 & _liveness,
+                                                               const std::vector<int32_t> & _regs,
+                                                               bool _floatClass)
+    : func(_func), regs(_regs), liveness(_liveness), floatClass(_floatClass)
+{}
+
+///
+/// @brief 进行寄存器分配
+///
+void GraphColoringRegisterAllocator::run()
+{
+    int32_t n = liveness.getValueCount();
+    allocatable.assign(n, false);
+    for (int32_t k = 0; k < n; k++) {
+        allocatable[k] =
+            liveness.isAllocatable(k) && PlatformArm64::isFloatValue(liveness.getValue(k)) == floatClass;
+    }
+    adjSet.assign(n, {});
+    spillCost.assign(n, 0);
+    alias.resize(n);
+    for (int32_t k = 0; k < n; k++) {
+        alias[k] = k;
+    }
+    color.assign(n, -1);
+
+    build();
+    coalesce();
+    simplify();
+    select();
+
+    assignment.clear();
+    for (int32_t k = 0; k < n; k++) {
+        if (allocatable[k]) {
+            assignment.emplace_back(liveness.getValue(k), color[getAlias(k)]);
+        }
+    }
+}
+
+///
+/// @brief 获取分配结果
+/// @return std::vector<std::pair<Value *, int32_t>>& 值以及分配的寄存器，溢出的值寄存器为-1
+///
+std::vector<std::pair<Value *, int32_t>> & GraphColoringRegisterAllocator::getAssignment()
+{
+    return assignment;
+}
+
+///
+/// @brief 增加冲突边
+/// @param a 结点
+/// @param b 结点
+///
+void GraphColoringRegisterAllocator::addEdge(int32_t a, int32_t b)
+{
+    if (a != b && allocatable[a] && allocatable[b]) {
+        adjSet[a].insert(b);
+        adjSet[b].insert(a);
+    }
+}
+
+///
+/// @brief 建立冲突图，同时统计溢出代价以及Move指令
+///
+void GraphColoringRegisterAllocator::build()
+{
+    DominatorTree domTree(func);
+    LoopInfo loopInfo(func, domTree);
+
+    std::vector<int32_t> defs, uses, liveOut;
+    for (auto block: func->getBlocks()) {
+
+        // 循环内的定义与使用按10的嵌套深度次方计算代价
+        double weight = std::pow(10.0, std::min(loopInfo.getLoopDepth(block), 6));
+
+        liveness.getLiveOut(block, liveOut);
+        std::set<int32_t> live(liveOut.begin(), liveOut.end());
+
+        auto & insts = block->getInsts();
+        for (auto it = insts.rbegin(); it != insts.rend(); ++it) {
+            Instruction * inst = *it;
+            if (inst->isDead()) {
+                continue;
+            }
+
+            liveness.getDefs(inst, defs);
+            liveness.getUses(inst, uses);
+
+            for (int32_t v: defs) {
+                spillCost[v] += weight;
+            }
+            for (int32_t v: uses) {
+                spillCost[v] += weight;
+            }
+
+            // Move指令的源与目标值相同，不必冲突，记录下来以便合并
+            if (inst->getOp() == IRInstOperator::IRINST_OP_ASSIGN && defs.size() == 1 && uses.size() == 1) {
+                if (allocatable[defs[0]] && allocatable[uses[0]]) {
+                    moves.push_back({defs[0], uses[0], weight});
+                }
+                live.erase(uses[0]);
+            }
+
+            for (int32_t d: defs) {
+                for (int32_t l: live) {
+                    addEdge(d, l);
+                }
+                for (int32_t o: defs) {
+                    addEdge(d, o);
+                }
+            }
+
+            for (int32_t d: defs) {
+                live.erase(d);
+            }
+            live.insert(uses.begin(), uses.end());
+        }
+    }
+}
+
+///
+/// @brief 查找合并后的代表结点
+/// @param n 结点
+/// @return int32_t 代表结点
+///
+int32_t GraphColoringRegisterAllocator::getAlias(int32_t n)
+{
+    while (alias[n] != n) {
+        alias[n] = alias[alias[n]];
+        n = alias[n];
+    }
+    return n;
+}
+
+///
+/// @brief Briggs条件：合并后度数不小于K的邻居个数小于K
+/// @param a 结点
+/// @param b 结点
+/// @return true 可合并
+/// @return false 不可合并
+///
+bool GraphColoringRegisterAllocator::briggs(int32_t a, int32_t b)
+{
+    size_t k = regs.size();
+    size_t significant = 0;
+
+    for (int32_t m: adjSet[a]) {
+        // 同时与两者冲突的邻居合并后度数减1
+        size_t degree = adjSet[m].size() - (adjSet[b].count(m) ? 1 : 0);
+        if (degree >= k) {
+            significant++;
+        }
+    }
+    for (int32_t m: adjSet[b]) {
+        if (!adjSet[a].count(m) && adjSet[m].size() >= k) {
+            significant++;
+        }
+    }
+
+    return significant < k;
+}
+
+///
+/// @brief 结点b合并到结点a
+/// @param a 结点
+/// @param b 结点
+///
+void GraphColoringRegisterAllocator::combine(int32_t a, int32_t b)
+{
+    alias[b] = a;
+    for (int32_t m: adjSet[b]) {
+        adjSet[m].erase(b);
+        addEdge(a, m);
+    }
+    adjSet[b].clear();
+    spillCost[a] += spillCost[b];
+}
+
+///
+/// @brief 保守合并Move指令的两端
+///
+void GraphColoringRegisterAllocator::coalesce()
+{
+    // 执行次数多的Move指令优先合并
+    std::stable_sort(moves.begin(), moves.end(), [](const MoveInfo & x, const MoveInfo & y) {
+        return x.weight > y.weight;
+    });
+
+    // 合并后邻居的度数降低，之前不满足条件的Move指令可能又可以合并了
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto & move: moves) {
+            int32_t a = getAlias(move.dst), b = getAlias(move.src);
+            if (a == b || adjSet[a].count(b) || !briggs(a, b)) {
+                continue;
+            }
+            combine(a, b);
+            changed = true;
+        }
+    }
+}
+
+///
+/// @brief 简化，结点依次压栈
+///
+void GraphColoringRegisterAllocator::simplify()
+{
+    size_t k = regs.size();
+    int32_t n = (int32_t) alias.size();
+
+    std::vector<size_t> degree(n, 0);
+    std::vector<bool> removed(n, true);
+    std::vector<int32_t> remaining, lowDegree;
+    for (int32_t v = 0; v < n; v++) {
+        if (allocatable[v] && getAlias(v) == v) {
+            degree[v] = adjSet[v].size();
+            removed[v] = false;
+            remaining.push_back(v);
+            if (degree[v] < k) {
+                lowDegree.push_back(v);
+            }
+        }
+    }
+
+    auto removeNode = [&](int32_t v) {
+        removed[v] = true;
+        selectStack.push_back(v);
+        for (int32_t m: adjSet[v]) {
+            if (!removed[m] && degree[m]-- == k) {
+                lowDegree.push_back(m);
+            }
+        }
+    };
+
+    size_t left = remaining.size();
+    while (left > 0) {
+        if (!lowDegree.empty()) {
+            int32_t v = lowDegree.back();
+            lowDegree.pop_back();
+            if (!removed[v]) {
+                removeNode(v);
+                left--;
+            }
+            continue;
+        }
+
+        // 所有结点的度数都不小于K，选代价与度数之比最小的结点作为溢出候选者，乐观地压栈
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](int32_t v) { return removed[v]; }),
+                        remaining.end());
+        int32_t victim = remaining.front();
+        for (int32_t v: remaining) {
+            if (spillCost[v] / degree[v] < spillCost[victim] / degree[victim]) {
+                victim = v;
+            }
+        }
+        removeNode(victim);
+        left--;
+    }
+}
+
+///
+/// @brief 出栈着色
+///
+void GraphColoringRegisterAllocator::select()
+{
+    // 各代表结点相关的Move指令的另一端，着色时优先选用相同的寄存器
+    std::vector<std::vector<int32_t>> partners(alias.size());
+    for (auto & move: moves) {
+        int32_t a = getAlias(move.dst), b = getAlias(move.src);
+        if (a != b) {
+            partners[a].push_back(b);
+            partners[b].push_back(a);
+        }
+    }
+
+    while (!selectStack.empty()) {
+        int32_t v = selectStack.back();
+        selectStack.pop_back();
+
+        std::unordered_set<int32_t> used;
+        for (int32_t m: adjSet[v]) {
+            if (color[m] != -1) {
+                used.insert(color[m]);
+            }
+        }
+
+        int32_t reg = -1;
+        for (int32_t p: partners[v]) {
+            if (color[p] != -1 && !used.count(color[p])) {
+                reg = color[p];
+                break;
+            }
+        }
+        if (reg == -1) {
+            for (int32_t r: regs) {
+                if (!used.count(r)) {
+                    reg = r;
+                    break;
+                }
+            }
+        }
+
+        // 没有可用的寄存器则溢出
+        color[v] = reg;
+    }
+}
@@ -0,0 +1,180 @@
+///
+/// @file GraphColoringRegisterAllocator.h
+/// @brief 基于图着色的寄存器分配
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+class Function;
+class Value;
+class LivenessArm64;
+
+///
+/// @brief Chaitin-Briggs图着色寄存器分配
+///
+/// 根据活跃变量分析建立冲突图，Move指令的两端在不冲突且满足Briggs条件时保守合并，
+/// 然后反复删除度数小于可用寄存器数的结点，删不动时按循环深度加权的使用次数除以度数
+/// 选出溢出候选者乐观地压栈，出栈着色时优先选用与Move指令另一端相同的寄存器。
+/// 最终没有着上色的值溢出到栈内，由指令选择借助临时寄存器进行访问。
+///
+class GraphColoringRegisterAllocator {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _func 函数，要求已经划分了基本块
+    /// @param _liveness 函数的活跃变量分析结果
+    /// @param _regs 可用的寄存器，越靠前越优先使用
+    /// @param _floatClass 为浮点值还是其它值分配寄存器，两类寄存器互不冲突，分别着色
+    ///
+    GraphColoringRegisterAllocator(Function * _func,
+                                   LivenessArm64 & _liveness,
+                                   const std::vector<int32_t> & _regs,
+                                   bool _floatClass = false);
+
+    ///
+    /// @brief 进行寄存器分配
+    ///
+    void run();
+
+    ///
+    /// @brief 获取分配结果
+    /// @return std::vector<std::pair<Value *, int32_t>>& 值以及分配的寄存器，溢出的值寄存器为-1
+    ///
+    std::vector<std::pair<Value *, int32_t>> & getAssignment();
+
+private:
+    ///
+    /// @brief 建立冲突图，同时统计溢出代价以及Move指令
+    ///
+    void build();
+
+    ///
+    /// @brief 增加冲突边
+    /// @param a 结点
+    /// @param b 结点
+    ///
+    void addEdge(int32_t a, int32_t b);
+
+    ///
+    /// @brief 查找合并后的代表结点
+    /// @param n 结点
+    /// @return int32_t 代表结点
+    ///
+    int32_t getAlias(int32_t n);
+
+    ///
+    /// @brief 保守合并Move指令的两端
+    ///
+    void coalesce();
+
+    ///
+    /// @brief Briggs条件：合并后度数不小于K的邻居个数小于K
+    /// @param a 结点
+    /// @param b 结点
+    /// @return true 可合并
+    /// @return false 不可合并
+    ///
+    bool briggs(int32_t a, int32_t b);
+
+    ///
+    /// @brief 结点b合并到结点a
+    /// @param a 结点
+    /// @param b 结点
+    ///
+    void combine(int32_t a, int32_t b);
+
+    ///
+    /// @brief 简化，结点依次压栈
+    ///
+    void simplify();
+
+    ///
+    /// @brief 出栈着色
+    ///
+    void select();
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func;
+
+    ///
+    /// @brief 可用的寄存器
+    ///
+    std::vector<int32_t> regs;
+
+    ///
+    /// @brief 活跃变量分析
+    ///
+    LivenessArm64 & liveness;
+
+    ///
+    /// @brief 是否为浮点值分配寄存器
+    ///
+    bool floatClass;
+
+    ///
+    /// @brief 结点是否参与分配
+    ///
+    std::vector<bool> allocatable;
+
+    ///
+    /// @brief 冲突图的邻接集合
+    ///
+    std::vector<std::unordered_set<int32_t>> adjSet;
+
+    ///
+    /// @brief 溢出代价，定义与使用按10的循环深度次方加权
+    ///
+    std::vector<double> spillCost;
+
+    ///
+    /// @brief Move指令的两端以及权重
+    ///
+    struct MoveInfo {
+        int32_t dst;
+        int32_t src;
+        double weight;
+    };
+
+    ///
+    /// @brief 两端都参与分配的Move指令
+    ///
+    std::vector<MoveInfo> moves;
+
+    ///
+    /// @brief 合并后的代表结点，未合并时为自己
+    ///
+    std::vector<int32_t> alias;
+
+    ///
+    /// @brief 简化时的结点栈
+    ///
+    std::vector<int32_t> selectStack;
+
+    ///
+    /// @brief 结点着的颜色，即寄存器编号，-1表示溢出
+    ///
+    std::vector<int32_t> color;
+
+    ///
+    /// @brief 分配结果
+    ///
+    std::vector<std::pair<Value *, int32_t>> assignment;
+};
@@ -14,13 +14,17 @@
 /// </table>
 ///
 #include <cstdio>
+#include <cstring>
 #include <string>
+#include <unordered_set>
 
 #include "ILocArm64.h"
 #include "Common.h"
 #include "Function.h"
 #include "PlatformArm64.h"
+#include "PeepholeArm64.h"
 #include "Module.h"
+#include "ConstFloat.h"
 
 #define emit(...) code.push_back(new ArmInst(__VA_ARGS__))
 
@@ -42,27 +46,20 @@ ILocArm64::~ILocArm64()
 /// @brief 删除无用的Label指令
 void ILocArm64::deleteUsedLabel()
 {
-    ArmInsts labelInsts;
-    //ArmInst *arm;
+    // 先收集所有跳转指令的目标，再删除不是目标的Label
+    std::unordered_set<std::string> targets;
     for (auto arm:code) {
-        if ((!arm->dead) && (arm->opcode[0] == '.') && (arm->result == ":")) {
-            labelInsts.push_back(arm);
-        }
-    }
-
-    for (ArmInst * labelArm: labelInsts) {
-        bool labelUsed = false;
-
-        for (auto arm:code) {
-            // TODO 转移语句的指令标识符根据定义修改判断
-            if ((!arm->dead) && (arm->opcode[0] == 'b') && (arm->result == labelArm->opcode)) {
-                labelUsed = true;
-                break;
+        if (!arm->dead) {
+            std::string target = PeepholeArm64::branchTarget(arm);
+            if (!target.empty()) {
+                targets.insert(target);
             }
         }
+    }
 
-        if (!labelUsed) {
-            labelArm->setDead();
+    for (auto arm:code) {
+        if ((!arm->dead) && (arm->opcode[0] == '.') && (arm->result == ":") && !targets.count(arm->opcode)) {
+            arm->setDead();
         }
     }
 }
@@ -203,7 +200,8 @@ void ILocArm64::load_symbol(int rs_reg_no, cstr name)
     //emit("movt", PlatformArm64::regName[rs_reg_no], "#:upper16:" + name);
     // adrp x0, a
     // ldr w0, [x0, :loc12:a]
-    std::string x = xregs(rs_reg_no);
+    // 浮点寄存器不能作为基址，借助临时寄存器保存地址
+    std::string x = xregs(ARM64_IS_FREG(rs_reg_no) ? ARM64_TMP_REG_NO : rs_reg_no);
     emit("adrp", x, name);
     std::string adr = "[";
     adr += x;
@@ -231,11 +229,14 @@ void ILocArm64::load_base(int rs_reg_no, int base_reg_no, int offset)
         }
     } else {
 
+        // 浮点寄存器不能保存偏移，借助临时寄存器
+        int32_t off_reg_no = ARM64_IS_FREG(rs_reg_no) ? ARM64_TMP_REG_NO : rs_reg_no;
+
         // ldr r8,=-4096
-        load_imm(rs_reg_no, offset);
+        load_imm(off_reg_no, offset);
 
         // fp,r8
-        base += "," + rsReg;
+        base += "," + PlatformArm64::regName[off_reg_no];
     }
 
     // 内存寻址
@@ -243,6 +244,7 @@ void ILocArm64::load_base(int rs_reg_no, int base_reg_no, int offset)
 
     // ldr r8,[fp,#-16]
     // ldr r8,[fp,r8]
+    // ldr s16,[fp,#-16]
     emit("ldr", rsReg, base);
 }
 
@@ -282,12 +284,35 @@ void ILocArm64::store_base(int src_reg_no, int base_reg_no, int disp, int tmp_re
     emit("str", PlatformArm64::regName[src_reg_no], base);
 }
 
-/// @brief 寄存器Mov操作
+/// @brief 寄存器Mov操作，涉及浮点寄存器时用fmov
 /// @param rs_reg_no 结果寄存器
 /// @param src_reg_no 源寄存器
 void ILocArm64::mov_reg(int rs_reg_no, int src_reg_no)
 {
-    emit("mov", PlatformArm64::regName[rs_reg_no], PlatformArm64::regName[src_reg_no]);
+    // 浮点寄存器之间以及与通用寄存器之间的传送用fmov
+    if (ARM64_IS_FREG(rs_reg_no) || ARM64_IS_FREG(src_reg_no)) {
+        emit("fmov", PlatformArm64::regName[rs_reg_no], PlatformArm64::regName[src_reg_no]);
+    } else {
+        emit("mov", PlatformArm64::regName[rs_reg_no], PlatformArm64::regName[src_reg_no]);
+    }
+}
+
+/// @brief 加载浮点常量，按位模式经通用寄存器传送 mov w16,#bits; fmov s0,w16
+/// @param rs_reg_no 结果寄存器
+/// @param constant 浮点常量
+void ILocArm64::load_float_imm(int rs_reg_no, float constant)
+{
+    int32_t bits;
+    memcpy(&bits, &constant, sizeof(bits));
+
+    if (!ARM64_IS_FREG(rs_reg_no)) {
+        load_imm(rs_reg_no, bits);
+    } else if (bits == 0) {
+        emit("fmov", PlatformArm64::regName[rs_reg_no], "wzr");
+    } else {
+        load_imm(ARM64_TMP_REG_NO, bits);
+        emit("fmov", PlatformArm64::regName[rs_reg_no], PlatformArm64::regName[ARM64_TMP_REG_NO]);
+    }
 }
 
 /// @brief 加载变量到寄存器，保证将变量放到reg中
@@ -302,6 +327,9 @@ void ILocArm64::load_var(int rs_reg_no, Value * src_var)
         // TODO 目前只考虑整数类型 100
         // ldr r8,#100
         load_imm(rs_reg_no, constVal->getVal());
+    } else if (Instanceof(constFloat, ConstFloat *, src_var)) {
+        // 浮点常量
+        load_float_imm(rs_reg_no, constFloat->getVal());
     } else if (src_var->getRegId() != -1) {
 
         // 源操作数为寄存器变量
@@ -310,11 +338,20 @@ void ILocArm64::load_var(int rs_reg_no, Value * src_var)
         if (src_regId != rs_reg_no) {
 
             // mov r8,r2 | 这里有优化空间——消除r8
-            emit("mov", PlatformArm64::regName[rs_reg_no], PlatformArm64::regName[src_regId]);
+            mov_reg(rs_reg_no, src_regId);
         }
     } else if (Instanceof(globalVar, GlobalVariable *, src_var)) {
         // 全局变量
 
+        if (globalVar->getType()->isArrayType()) {
+            // 全局数组作为实参时传递的是数组的地址
+            // adrp x0, a; add x0, x0, :lo12:a
+            std::string x = xregs(rs_reg_no);
+            emit("adrp", x, globalVar->getName());
+            emit("add", x, x, ":lo12:" + globalVar->getName());
+            return;
+        }
+
         // 读取全局变量的地址
         // movw r8, #:lower16:a
         // movt r8, #:lower16:a
@@ -387,7 +424,7 @@ void ILocArm64::store_var(int src_reg_no, Value * dest_var, int tmp_reg_no)
         if (src_reg_no != dest_reg_id) {
 
             // mov r2,r8 | 这里有优化空间——消除r8
-            emit("mov", PlatformArm64::regName[dest_reg_id], PlatformArm64::regName[src_reg_no]);
+            mov_reg(dest_reg_id, src_reg_no);
         }
 
     } else if (Instanceof(globalVar, GlobalVariable *, dest_var)) {
@@ -447,20 +484,19 @@ void ILocArm64::leaStack(int rs_reg_no, int base_reg_no, int off)
 /// @param tmp_reg_No
 void ILocArm64::allocStack(Function * func, int tmp_reg_no)
 {
-    // 超过四个的函数调用参数个数，多余8个，则需要栈传值
-    int funcCallArgCnt = func->getMaxFuncCallArgCnt() - 8;
-    if (funcCallArgCnt < 0) {
-        funcCallArgCnt = 0;
-    }
-
     // 计算栈帧大小
-    int off = func->getMaxDep();
+    int off = stackSize(func);
 
-    off += funcCallArgCnt * 8;
+    // 不需要在栈内额外分配空间，且没有栈传递的形参，则什么都不做
+    bool useFp = useFramePointer(func);
+    if (0 == off && !useFp)
+        return;
 
-    // 不需要在栈内额外分配空间，则什么都不做
-    if (0 == off)
+    if (0 == off) {
+        // 栈传递的形参通过fp寻址
+        inst("mov", ARM64_FP, "sp");
         return;
+    }
 
     if (PlatformArm64::constExpr(off)) {
         // sub sp,sp,#16
@@ -473,8 +509,49 @@ void ILocArm64::allocStack(Function * func, int tmp_reg_no)
         emit("sub", "sp", "sp", PlatformArm64::regName[tmp_reg_no]);
     }
 
-    // 函数调用通过栈传递的基址寄存器设置
-    inst("add", ARM64_FP, "sp", toStr(funcCallArgCnt * 8));
+    // 函数调用通过栈传递的基址寄存器设置，只有栈传递的实参时不需要fp
+    if (useFp)
+        inst("add", ARM64_FP, "sp", toStr(off - func->getMaxDep()));
+}
+
+/// @brief 函数的栈帧大小，包括局部变量以及调用函数时栈传递的实参，按16字节对齐
+/// @param func 函数
+/// @return 栈帧大小
+int ILocArm64::stackSize(Function * func)
+{
+    // 超过四个的函数调用参数个数，多余8个，则需要栈传值
+    int funcCallArgCnt = func->getMaxFuncCallArgCnt() - 8;
+    if (funcCallArgCnt < 0) {
+        funcCallArgCnt = 0;
+    }
+
+    return func->getMaxDep() + ((funcCallArgCnt * 8 + 15) & ~15);
+}
+
+/// @brief 函数是否需要fp寄存器，栈内有局部变量或溢出的值，或者有栈传递的形参时需要
+/// @param func 函数
+/// @return true 需要
+bool ILocArm64::useFramePointer(Function * func)
+{
+    if (func->getMaxDep()) {
+        return true;
+    }
+
+    for (auto param: func->getParams()) {
+        if (param->getRegId() == -1 && param->getMemoryAddr()) {
+            return true;
+        }
+    }
+
+    // 局部数组即使没有占用栈空间也通过fp寻址
+    for (auto var: func->getVarValues()) {
+        int32_t base = -1;
+        if (var->getRegId() == -1 && var->getMemoryAddr(&base) && base == ARM64_FP_REG_NO) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 /// @brief 调用函数fun
@@ -34,10 +34,10 @@ class ILocArm64 {
     /// @brief 符号表
     Module * module;
 
-    /// @brief 加载立即数 ldr r0,=#100
-    /// @param rs_reg_no 结果寄存器号
-    /// @param num 立即数
-    void load_imm(int rs_reg_no, int num);
+    /// @brief 加载浮点常量，按位模式经通用寄存器传送 mov w16,#bits; fmov s0,w16
+    /// @param rs_reg_no 结果寄存器
+    /// @param num 浮点常量
+    void load_float_imm(int rs_reg_no, float num);
 
     /// @brief 加载符号值 ldr r0,=g; ldr r0,[r0]
     /// @param rsReg 结果寄存器号
@@ -51,6 +51,11 @@ class ILocArm64 {
     void leaStack(int rs_reg_no, int base_reg_no, int offset);
 
 public:
+    /// @brief 加载立即数 ldr r0,=#100
+    /// @param rs_reg_no 结果寄存器号
+    /// @param num 立即数
+    void load_imm(int rs_reg_no, int num);
+
     /// @brief 构造函数
     /// @param _module 符号表-模块
     ILocArm64(Module * _module);
@@ -130,7 +135,7 @@ public:
     /// @param addr_reg_no 地址寄存器号
     void store_var(int src_reg_no, Value * var, int addr_reg_no);
 
-    /// @brief 寄存器Mov操作
+    /// @brief 寄存器Mov操作，涉及浮点寄存器时用fmov
     /// @param rs_reg_no 结果寄存器
     /// @param src_reg_no 源寄存器
     void mov_reg(int rs_reg_no, int src_reg_no);
@@ -144,6 +149,16 @@ public:
     /// @param tmp_reg_No
     void allocStack(Function * func, int tmp_reg_No);
 
+    /// @brief 函数的栈帧大小，包括局部变量以及调用函数时栈传递的实参，按16字节对齐
+    /// @param func 函数
+    /// @return 栈帧大小
+    static int stackSize(Function * func);
+
+    /// @brief 函数是否需要fp寄存器，栈内有局部变量或溢出的值，或者有栈传递的形参时需要
+    /// @param func 函数
+    /// @return true 需要
+    static bool useFramePointer(Function * func);
+
     /// @brief 加载函数的参数到寄存器
     /// @param fun
     void ldr_args(Function * fun);
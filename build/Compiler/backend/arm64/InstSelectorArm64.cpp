@@ -29,12 +29,51 @@
 #include "GotoInstruction.h"
 #include "FuncCallInstruction.h"
 #include "MoveInstruction.h"
+#include "MemsetInstruction.h"
 #include "ArrayType.h"
+#include "GlobalVariable.h"
+#include "ConstFloat.h"
+#include "FormalParam.h"
 // #include "BinaryInstruction.h"
 
 static char * cmpmap[] = {"eq", "ne", "gt", "le", "ge", "lt"};
 #define CSTRJ(C) cmpmap[(C - IRINST_OP_IEQ) ^ 1]
 #define CSTR(C) cmpmap[(C - IRINST_OP_IEQ)]
+#define XREG(i) ("x" + to_string(i))
+
+/// @brief 浮点比较在fcmp后与整数比较使用相同的条件码，映射到对应的整数比较
+/// @param op 比较运算符
+/// @return 整数比较运算符，不是浮点比较时原样返回
+static IRInstOperator icmpOp(IRInstOperator op)
+{
+    switch (op) {
+        case IRINST_OP_FEQ:
+            return IRINST_OP_IEQ;
+        case IRINST_OP_FNE:
+            return IRINST_OP_INE;
+        case IRINST_OP_FGT:
+            return IRINST_OP_IGT;
+        case IRINST_OP_FGE:
+            return IRINST_OP_IGE;
+        case IRINST_OP_FLT:
+            return IRINST_OP_ILT;
+        case IRINST_OP_FLE:
+            return IRINST_OP_ILE;
+        default:
+            return op;
+    }
+}
+
+/// @brief 保护寄存器时的名字，通用寄存器保存x，浮点寄存器保存低64位d
+/// @param reg 寄存器编号
+/// @return 寄存器名字
+static std::string saveRegName(int32_t reg)
+{
+    if (ARM64_IS_FREG(reg)) {
+        return "d" + std::to_string(reg - ARM64_FREG_BASE);
+    }
+    return "x" + std::to_string(reg);
+}
 
 using std::to_string;
 // static GotoInstruction *lastBranch;
@@ -72,6 +111,13 @@ InstSelectorArm64::InstSelectorArm64(vector<Instruction *> & _irCode,
     translator_handlers[IRINST_OP_ILT] = &InstSelectorArm64::translate_bi_op;
     translator_handlers[IRINST_OP_ILE] = &InstSelectorArm64::translate_bi_op;
 
+    translator_handlers[IRINST_OP_FEQ] = &InstSelectorArm64::translate_bi_op;
+    translator_handlers[IRINST_OP_FNE] = &InstSelectorArm64::translate_bi_op;
+    translator_handlers[IRINST_OP_FGT] = &InstSelectorArm64::translate_bi_op;
+    translator_handlers[IRINST_OP_FGE] = &InstSelectorArm64::translate_bi_op;
+    translator_handlers[IRINST_OP_FLT] = &InstSelectorArm64::translate_bi_op;
+    translator_handlers[IRINST_OP_FLE] = &InstSelectorArm64::translate_bi_op;
+
     translator_handlers[IRINST_OP_FADD] = &InstSelectorArm64::translate_fadd;
     translator_handlers[IRINST_OP_FSUB] = &InstSelectorArm64::translate_fsub;
     translator_handlers[IRINST_OP_FMUL] = &InstSelectorArm64::translate_fmul;
@@ -79,8 +125,10 @@ InstSelectorArm64::InstSelectorArm64(vector<Instruction *> & _irCode,
     translator_handlers[IRINST_OP_FMOD] = &InstSelectorArm64::translate_fmod;
 
     translator_handlers[IRINST_OP_GEP] = &InstSelectorArm64::translate_gep;
+    translator_handlers[IRINST_OP_ADDR] = &InstSelectorArm64::translate_addr;
     translator_handlers[IRINST_OP_STORE] = &InstSelectorArm64::translate_store;
     translator_handlers[IRINST_OP_LOAD] = &InstSelectorArm64::translate_load;
+    translator_handlers[IRINST_OP_MEMSET] = &InstSelectorArm64::translate_memset;
 
     translator_handlers[IRINST_OP_CAST] = &InstSelectorArm64::translate_cast;
 
@@ -153,10 +201,15 @@ void InstSelectorArm64::translate_label(Instruction * inst)
 {
     Instanceof(labelInst, LabelInstruction *, inst);
 
-    ArmInst * ai = iloc.getCode().back();
-    if (ai->opcode[0] == 'b' && ai->result == labelInst->getName())
-        ai->setDead();
+    // 没有栈帧的函数开头可能还没有指令
+    auto & code = iloc.getCode();
+    if (!code.empty() && code.back()->opcode[0] == 'b' && code.back()->result == labelInst->getName())
+        code.back()->setDead();
     iloc.label(labelInst->getName());
+
+    if (inst == func->getFrameLabel()) {
+        translate_prologue();
+    }
 }
 
 /// @brief goto指令指令翻译成ARM64汇编
@@ -185,17 +238,31 @@ void InstSelectorArm64::translate_goto(Instruction * inst)
 /// @param inst IR指令
 void InstSelectorArm64::translate_entry(Instruction * inst)
 {
-    // 查看保护的寄存器
-    auto & protectedReg = func->getProtectedReg();
+    // shrink-wrapping后栈帧在指定的Label处建立
+    if (!func->getFrameLabel()) {
+        translate_prologue();
+    }
+}
 
-    int i = 0, m = protectedReg.size() - 1;
-    while (i < m) {
-        int32_t xa = protectedReg[i], xb = protectedReg[i + 1];
-        i += 2;
-        iloc.inst("stp", "x" + std::to_string(xa), "x" + std::to_string(xb), "[sp,#-16]!");
+/// @brief 建立栈帧，保存被保护的寄存器并分配栈空间
+void InstSelectorArm64::translate_prologue()
+{
+    // 查看保护的寄存器，通用寄存器与浮点寄存器分别成对保存
+    std::vector<int32_t> protectedReg[2];
+    for (auto reg: func->getProtectedReg()) {
+        protectedReg[ARM64_IS_FREG(reg)].push_back(reg);
+    }
+
+    for (auto & regs: protectedReg) {
+        int i = 0, m = regs.size() - 1;
+        while (i < m) {
+            int32_t xa = regs[i], xb = regs[i + 1];
+            i += 2;
+            iloc.inst("stp", saveRegName(xa), saveRegName(xb), "[sp,#-16]!");
+        }
+        if (i <= m)
+            iloc.inst("str", saveRegName(regs[i]), "[sp,#-16]!");
     }
-    if (i <= m)
-        iloc.inst("str", "x" + std::to_string(protectedReg[i]), "[sp,#-16]!");
 
     // 为fun分配栈帧，含局部变量、函数调用值传递的空间等
     iloc.allocStack(func, ARM64_TMP_REG_NO);
@@ -209,29 +276,44 @@ void InstSelectorArm64::translate_exit(Instruction * inst)
         // 存在返回值
         Value * retVal = inst->getOperand(0);
 
-        // 赋值给寄存器R0
-        iloc.load_var(0, retVal);
+        // 赋值给寄存器R0，浮点返回值用s0
+        iloc.load_var(func->getReturnType()->isFloatType() ? ARM64_FREG(0) : 0, retVal);
     }
 
-    // 恢复栈空间
-    int32_t dp = func->getMaxDep();
+    // 不经过栈帧建立处的出口直接返回
+    if (inst != func->getFramelessExit()) {
+        translate_epilogue();
+    }
+
+    iloc.inst("ret", "");
+}
+
+/// @brief 恢复栈帧，释放栈空间并恢复被保护的寄存器
+void InstSelectorArm64::translate_epilogue()
+{
+    // 恢复栈空间，与入口分配的大小一致
+    int32_t dp = ILocArm64::stackSize(func);
     if (dp)
         iloc.inst("add", "sp", "sp", iloc.toStr(dp));
 
-    auto & protectedReg = func->getProtectedReg();
-    if (!protectedReg.empty()) {
-        int m = protectedReg.size();
+    // 与入口相反，先恢复浮点寄存器，再恢复通用寄存器
+    std::vector<int32_t> protectedReg[2];
+    for (auto reg: func->getProtectedReg()) {
+        protectedReg[ARM64_IS_FREG(reg)].push_back(reg);
+    }
+
+    for (int c = 1; c >= 0; c--) {
+        auto & regs = protectedReg[c];
+        int m = regs.size();
         if (m & 1)
-            iloc.inst("ldr", "x" + std::to_string(protectedReg[m - 1]), "[sp],#16");
+            iloc.inst("ldr", saveRegName(regs[m - 1]), "[sp],#16");
         int i = (m - 2) | 1;
         while (i > 0) {
-            int32_t xa = protectedReg[i - 1], xb = protectedReg[i];
+            int32_t xa = regs[i - 1], xb = regs[i];
             i -= 2;
-            iloc.inst("ldp", "x" + std::to_string(xa), "x" + std::to_string(xb), "[sp],#16");
+            iloc.inst("ldp", saveRegName(xa), saveRegName(xb), "[sp],#16");
         }
     }
-
-    iloc.inst("ret", "");
 }
 
 /// @brief 赋值指令翻译成ARM64汇编
@@ -257,7 +339,9 @@ void InstSelectorArm64::translate_assign(Instruction * inst)
     } else {
         // 内存变量 => 内存变量
 
-        int32_t temp_regno = simpleRegisterAllocator.Allocate();
+        // 浮点值借助浮点临时寄存器
+        bool isFloat = PlatformArm64::isFloatValue(result);
+        int32_t temp_regno = isFloat ? ARM64_FTMP_REG_NO : simpleRegisterAllocator.Allocate();
 
         // arg1 -> r8
         iloc.load_var(temp_regno, arg1);
@@ -265,7 +349,9 @@ void InstSelectorArm64::translate_assign(Instruction * inst)
         // r8 -> rs 可能用到r9
         iloc.store_var(temp_regno, result, ARM64_TMP_REG_NO);
 
-        simpleRegisterAllocator.free(temp_regno);
+        if (!isFloat) {
+            simpleRegisterAllocator.free(temp_regno);
+        }
     }
 }
 
@@ -289,8 +375,8 @@ void InstSelectorArm64::translate_two_operator(Instruction * inst, string operat
     // 看arg1是否是寄存器，若是则寄存器寻址，否则要load变量到寄存器中
     if (arg1_reg_no == -1) {
 
-        // 分配一个寄存器r8
-        load_arg1_reg_no = ARM64_TMP_REG_NO;
+        // 分配一个寄存器r8，浮点用s16
+        load_arg1_reg_no = PlatformArm64::isFloatValue(arg1) ? ARM64_FTMP_REG_NO : ARM64_TMP_REG_NO;
 
         // arg1 -> r8，这里可能由于偏移不满足指令的要求，需要额外分配寄存器
         iloc.load_var(load_arg1_reg_no, arg1);
@@ -301,8 +387,8 @@ void InstSelectorArm64::translate_two_operator(Instruction * inst, string operat
     // 看arg2是否是寄存器，若是则寄存器寻址，否则要load变量到寄存器中
     if (arg2_reg_no == -1) {
 
-        // 分配一个寄存器r9
-        load_arg2_reg_no = ARM64_TMP_REG_NO2;
+        // 分配一个寄存器r9，浮点用s17
+        load_arg2_reg_no = PlatformArm64::isFloatValue(arg2) ? ARM64_FTMP_REG_NO2 : ARM64_TMP_REG_NO2;
 
         // arg2 -> r9
         iloc.load_var(load_arg2_reg_no, arg2);
@@ -313,7 +399,7 @@ void InstSelectorArm64::translate_two_operator(Instruction * inst, string operat
     // 看结果变量是否是寄存器，若不是则需要分配一个新的寄存器来保存运算的结果
     if (result_reg_no == -1) {
         // 分配一个寄存器r10，用于暂存结果
-        load_result_reg_no = ARM64_TMP_REG_NO2;
+        load_result_reg_no = PlatformArm64::isFloatValue(result) ? ARM64_FTMP_REG_NO2 : ARM64_TMP_REG_NO2;
     } else {
         load_result_reg_no = result_reg_no;
     }
@@ -350,14 +436,257 @@ void InstSelectorArm64::translate_sub_int32(Instruction * inst)
 
 void InstSelectorArm64::translate_mul_int32(Instruction * inst)
 {
-    translate_two_operator(inst, "mul");
+    // 有一个操作数为常量时尝试改为移位与加减
+    Instanceof(factor, ConstInt *, inst->getOperand(1));
+    Value * other = inst->getOperand(0);
+    if (!factor) {
+        factor = dynamic_cast<ConstInt *>(inst->getOperand(0));
+        other = inst->getOperand(1);
+    }
+
+    std::vector<MulStep> steps;
+    int32_t res = inst->getRegId() != -1 ? inst->getRegId() : ARM64_TMP_REG_NO2;
+    int32_t src = other->getRegId() != -1 ? other->getRegId() : ARM64_TMP_REG_NO;
+    if (!factor || !plan_mul_const(factor->getVal(), res != src, steps)) {
+        translate_two_operator(inst, "mul");
+        return;
+    }
+
+    if (other->getRegId() == -1) {
+        iloc.load_var(src, other);
+    }
+    emit_mul_const(steps, res, src);
+    if (inst->getRegId() == -1) {
+        iloc.store_var(res, inst, ARM64_TMP_REG_NO);
+    }
+}
+
+/// @brief 32位整数乘以常量分解为至多两条lsl、neg以及带移位操作数的add/sub。
+/// 按Cortex-A53/A72估计，移位不超过4时每条1个周期，否则2个周期，合计超过3个周期时不如mov+mul。
+/// 按第二条指令的每种形式由常量直接反推第一条指令的倍数，只需常数时间
+/// @param c 常量
+/// @param keepSrc 被乘数所在的寄存器在第一条指令后是否仍然可用，即结果与被乘数不在同一寄存器
+/// @param steps 指令序列
+/// @return true 可以分解，false 不能分解
+bool InstSelectorArm64::plan_mul_const(int32_t c, bool keepSrc, std::vector<MulStep> & steps)
+{
+    // 乘以0与1的由常量传播等处理，这里不再考虑
+    steps.clear();
+    if (c == 0 || c == 1) {
+        return false;
+    }
+
+    // 移位不超过4的add/sub以及lsl、neg为1个周期，其余为2个周期
+    auto cost = [](const MulStep & step) { return (step.op == MulStep::LSL || step.shift <= 4) ? 1 : 2; };
+
+    // 2的幂的指数，不是2的幂时为-1
+    auto exponent = [](uint32_t v) { return (v && !(v & (v - 1))) ? __builtin_ctz(v) : -1; };
+
+    // 被乘数x一条指令乘以m：x << k、-(x << k)、x + (x << k)、x - (x << k)，按32位回绕
+    auto single = [&exponent](uint32_t m, MulStep & step) {
+        int32_t k;
+        if (m == 0) {
+            return false;
+        } else if ((k = exponent(m)) > 0) {
+            step = {MulStep::LSL, false, false, k};
+        } else if ((k = exponent(-m)) >= 0) {
+            step = {MulStep::NEG, false, false, k};
+        } else if ((k = exponent(m - 1)) >= 0) {
+            step = {MulStep::ADD, false, false, k};
+        } else if ((k = exponent(1 - m)) >= 0) {
+            step = {MulStep::SUB, false, false, k};
+        } else {
+            return false;
+        }
+        return true;
+    };
+
+    int32_t best = 4;
+    MulStep first;
+    if (single((uint32_t) c, first)) {
+        best = cost(first);
+        steps = {first};
+    }
+
+    // 第一条指令得到m倍的部分积v，第二条指令为second时结果为c
+    auto tryPair = [&](int64_t m, const MulStep & second) {
+        if (cost(second) + 1 < best && single((uint32_t) m, first) && cost(first) + cost(second) < best) {
+            best = cost(first) + cost(second);
+            steps = {first, second};
+        }
+    };
+
+    int64_t v = c;
+    for (int32_t k = 0; k < 32; k++) {
+        int64_t p = int64_t(1) << k;
+
+        // v << k、-(v << k)、v + (v << k)、v - (v << k)：c除以相应的因子得到m
+        if (k && v % p == 0) {
+            tryPair(v / p, {MulStep::LSL, false, false, k});
+        }
+        if (v % p == 0) {
+            tryPair(-v / p, {MulStep::NEG, false, false, k});
+        }
+        if (v % (1 + p) == 0) {
+            tryPair(v / (1 + p), {MulStep::ADD, false, false, k});
+        }
+        if (k && v % (1 - p) == 0) {
+            tryPair(v / (1 - p), {MulStep::SUB, false, false, k});
+        }
+
+        if (!keepSrc) {
+            continue;
+        }
+
+        // x + (v << k)、x - (v << k)：c - 1与1 - c除以2的幂得到m
+        if ((v - 1) % p == 0) {
+            tryPair((v - 1) / p, {MulStep::ADD, true, false, k});
+            tryPair((1 - v) / p, {MulStep::SUB, true, false, k});
+        }
+
+        // v + (x << k)、v - (x << k)：c减去或加上2的幂得到m
+        tryPair(v - p, {MulStep::ADD, false, true, k});
+        tryPair(v + p, {MulStep::SUB, false, true, k});
+    }
+
+    return !steps.empty();
+}
+
+/// @brief 产生乘以常量的指令序列
+/// @param steps plan_mul_const得到的指令序列
+/// @param dst 结果寄存器
+/// @param src 被乘数寄存器
+void InstSelectorArm64::emit_mul_const(const std::vector<MulStep> & steps, int32_t dst, int32_t src)
+{
+    // 第一条指令之后部分积在结果寄存器中
+    std::string v = PlatformArm64::regName[src];
+    for (auto & step: steps) {
+        std::string a = step.aIsX ? PlatformArm64::regName[src] : v;
+        std::string b = step.bIsX ? PlatformArm64::regName[src] : v;
+        const std::string & d = PlatformArm64::regName[dst];
+        if (step.op == MulStep::LSL) {
+            // lsl w0, w1, #3
+            iloc.inst("lsl", d, b, "#" + to_string(step.shift));
+        } else if (step.op == MulStep::NEG) {
+            // neg w0, w1, lsl #3
+            iloc.inst("neg", d, step.shift ? b + ",lsl #" + to_string(step.shift) : b);
+        } else {
+            // add w0, w1, w1, lsl #3
+            iloc.inst(step.op == MulStep::ADD ? "add" : "sub", d, a, step.shift ? b + ",lsl #" + to_string(step.shift) : b);
+        }
+        v = d;
+    }
 }
 
 void InstSelectorArm64::translate_div_int32(Instruction * inst)
 {
+    if (translate_div_const(inst, false)) {
+        return;
+    }
     translate_two_operator(inst, "sdiv");
 }
 
+/// @brief 除数为常量的整数除法与求余，2的幂改为移位，其它改为乘以魔数取高位
+/// @param inst IR指令
+/// @param rem true求余，false除法
+/// @return true 已翻译，false 除数不是常量或者为0、INT32_MIN，仍用sdiv
+bool InstSelectorArm64::translate_div_const(Instruction * inst, bool rem)
+{
+    Instanceof(divisor, ConstInt *, inst->getOperand(1));
+    if (!divisor || divisor->getVal() == 0 || divisor->getVal() == INT32_MIN) {
+        return false;
+    }
+
+    Value * arg1 = inst->getOperand(0);
+    int32_t d = divisor->getVal();
+    int32_t ad = d < 0 ? -d : d;
+
+    // 被除数不在寄存器时读入x16，x17暂存中间结果，结果不在寄存器时也先放在x17
+    int32_t n = arg1->getRegId();
+    if (n == -1) {
+        n = ARM64_TMP_REG_NO;
+        iloc.load_var(n, arg1);
+    }
+    int32_t tmp = ARM64_TMP_REG_NO2;
+    int32_t res = inst->getRegId() != -1 ? inst->getRegId() : tmp;
+    std::string wn = PlatformArm64::regName[n];
+    std::string wt = PlatformArm64::regName[tmp];
+    std::string wr = PlatformArm64::regName[res];
+
+    if (ad == 1) {
+        // x/1=x，x/-1=-x，余数为0
+        if (rem) {
+            iloc.inst("mov", wr, "wzr");
+        } else {
+            iloc.inst(d > 0 ? "mov" : "neg", wr, wn);
+        }
+    } else if ((ad & (ad - 1)) == 0) {
+        // 负数先加上2^k-1再算术右移，使商向0取整
+        int32_t k = __builtin_ctz(ad);
+        if (k == 1) {
+            iloc.inst("add", wt, wn, wn + ",lsr #31");
+        } else {
+            iloc.inst("asr", wt, wn, "#31");
+            iloc.inst("add", wt, wn, wt + ",lsr #" + to_string(32 - k));
+        }
+
+        if (rem) {
+            // x - (偏置后的x & -2^k)
+            iloc.inst("and", wt, wt, "#" + to_string((uint32_t) -ad));
+            iloc.inst("sub", wr, wn, wt);
+        } else if (d > 0) {
+            iloc.inst("asr", wr, wt, "#" + to_string(k));
+        } else {
+            iloc.inst("asr", wt, wt, "#" + to_string(k));
+            iloc.inst("neg", wr, wt);
+        }
+    } else {
+        // 商为x*magic的高位算术右移，被除数为负时再加1
+        int32_t magic, shift;
+        signedDivMagic(ad, &magic, &shift);
+        iloc.load_imm(tmp, magic);
+        iloc.inst("smull", XREG(tmp), wn, wt);
+        if (magic >= 0) {
+            iloc.inst("asr", XREG(tmp), XREG(tmp), "#" + to_string(32 + shift));
+        } else {
+            // 魔数超过INT32_MAX时按负数相乘，高位少了一个被除数
+            iloc.inst("asr", XREG(tmp), XREG(tmp), "#32");
+            iloc.inst("add", wt, wt, wn);
+            if (shift) {
+                iloc.inst("asr", wt, wt, "#" + to_string(shift));
+            }
+        }
+
+        if (!rem && d > 0) {
+            iloc.inst("sub", wr, wt, wn + ",asr #31");
+        } else if (!rem) {
+            iloc.inst("sub", wt, wt, wn + ",asr #31");
+            iloc.inst("neg", wr, wt);
+        } else {
+            // 余数x - q*|d|与除数的符号无关
+            iloc.inst("sub", wt, wt, wn + ",asr #31");
+            int32_t dreg = (res != tmp && res != n) ? res : (n != ARM64_TMP_REG_NO ? ARM64_TMP_REG_NO : -1);
+            if (dreg != -1) {
+                iloc.load_imm(dreg, ad);
+                iloc.inst("msub", wr, wt, PlatformArm64::regName[dreg] + "," + wn);
+            } else {
+                // 被除数与结果都不在寄存器中，没有空闲的临时寄存器，乘积算出后重新读入被除数
+                std::string wd = PlatformArm64::regName[ARM64_TMP_REG_NO];
+                iloc.load_imm(ARM64_TMP_REG_NO, ad);
+                iloc.inst("mul", wt, wt, wd);
+                iloc.load_var(ARM64_TMP_REG_NO, arg1);
+                iloc.inst("sub", wr, wd, wt);
+            }
+        }
+    }
+
+    if (inst->getRegId() == -1) {
+        iloc.store_var(res, inst, ARM64_TMP_REG_NO);
+    }
+
+    return true;
+}
+
 void InstSelectorArm64::translate_fadd(Instruction *inst) {
     translate_two_operator(inst, "fadd");
 }
@@ -380,7 +709,10 @@ void InstSelectorArm64::translate_fmod(Instruction *inst) {
 
 void InstSelectorArm64::translate_rem_int32(Instruction * inst)
 {
-    // TODO 计算降级：当op2为整数常量，op2=2^n时，改为and rs,ra,op-1
+    if (translate_div_const(inst, true)) {
+        return;
+    }
+
     Value * arg1 = inst->getOperand(0);
     Value * arg2 = inst->getOperand(1);
     int32_t reg1 = arg1->getRegId();
@@ -403,75 +735,308 @@ void InstSelectorArm64::translate_rem_int32(Instruction * inst)
 }
 
 void InstSelectorArm64::translate_gep(Instruction *inst) {
-    Value *arg1 = inst->getOperand(0);
-    Value *arg2 = inst->getOperand(1);
-
-    int32_t baseReg = -1;
-    int64_t baseOff;
-    arg1->getMemoryAddr(&baseReg, &baseOff);
-
-    Instanceof(off, ConstInt*, arg2);
-    uint32_t l = ((ArrayType*)(inst->getType()))->getElementType()->getSize();
-    if (off) {
-        // if (baseReg == null) store baseReg;
-        inst->setMemoryAddr(baseReg, baseOff + off->getVal() * l);
+    // 公共子表达式删除、循环不变量外提后，GEP可能与其使用隔了别的指令甚至跨基本块，
+    // 临时寄存器早已被改写，因此没有寄存器的GEP在每个访存处重新计算地址
+    int32_t reg = inst->getRegId();
+    if (reg == -1) {
+        return;
+    }
+
+    // 作为公共前缀的GEP在这里算一次：add x19, x20, w21, sxtw #2
+    MemAddr addr;
+    gep_level(inst, addr, reg);
+    materialize_symbol(addr);
+    if (addr.index != -1) {
+        add_index(addr.base, addr.index, addr.shift, reg);
+        addr.base = reg;
+    }
+    if (addr.offset == 0) {
+        if (addr.base != reg) {
+            iloc.inst("mov", XREG(reg), XREG(addr.base));
+        }
+    } else if (PlatformArm64::isDisp((int) addr.offset)) {
+        iloc.inst(addr.offset > 0 ? "add" : "sub", XREG(reg), XREG(addr.base), iloc.toStr((int) std::abs(addr.offset)));
     } else {
-        // TODO
-        // %t1 = getelemptr [3xi32] %l0, %l1
-        // // mul l1, l1, lx
-        if (baseReg == -1) {
-            baseReg = ARM64_TMP_REG_NO;
-            iloc.load_var(baseReg, arg1);
-        }
-        int32_t reg2 = arg2->getRegId();
-        if (reg2 == -1) {
-            reg2 = ARM64_TMP_REG_NO2;
-            iloc.load_var(reg2, arg2);
-        }
-        if (__builtin_popcount(l) == 1) {
-            iloc.inst("add", "x"+to_string(ARM64_TMP_REG_NO2), "x"+to_string(baseReg), "x"+to_string(reg2)+",lsl "+to_string(__builtin_ctz(l)));
+        iloc.load_imm(ARM64_TMP_REG_NO, (int) addr.offset);
+        iloc.inst("add", XREG(reg), XREG(addr.base), XREG(ARM64_TMP_REG_NO));
+    }
+}
+
+void InstSelectorArm64::translate_addr(Instruction *inst) {
+    int32_t reg = inst->getRegId();
+    if (reg == -1) {
+        return;
+    }
+
+    // adrp x19, a; add x19, x19, :lo12:a
+    std::string sym = inst->getOperand(0)->getName();
+    iloc.inst("adrp", XREG(reg), sym);
+    iloc.inst("add", XREG(reg), XREG(reg), ":lo12:" + sym);
+}
+
+void InstSelectorArm64::gep_address(Value *ptr, MemAddr &addr) {
+    Instanceof(gep, Instruction*, ptr);
+    if (gep && gep->getOp() == IRINST_OP_ADDR && gep->getRegId() == -1) {
+        // 没有寄存器的全局数组地址，按符号寻址
+        gep_address(gep->getOperand(0), addr);
+        return;
+    }
+    if (!gep || gep->getOp() != IRINST_OP_GEP || gep->getRegId() != -1) {
+        addr = MemAddr();
+        if (Instanceof(globalArr, GlobalVariable*, ptr)) {
+            // 全局数组用到变量下标时才取其地址
+            addr.symbol = globalArr->getName();
+        } else if (ptr->getRegId() != -1) {
+            // 数组形参保存的是数组的地址，GEP的寄存器保存已算好的地址
+            addr.base = ptr->getRegId();
+        } else if (dynamic_cast<FormalParam*>(ptr)) {
+            // 栈内的数组形参先读出数组的地址
+            iloc.load_var(ARM64_TMP_REG_NO2, ptr);
+            addr.base = ARM64_TMP_REG_NO2;
         } else {
-            iloc.inst("mov", "x"+to_string(ARM64_TMP_REG_NO), "#"+to_string(l));
-            iloc.inst("madd", "x"+to_string(ARM64_TMP_REG_NO2),
-                        "x"+to_string(reg2),
-                        "x"+to_string(ARM64_TMP_REG_NO)
-                        +",x"+to_string(baseReg));
+            // 栈内的局部数组
+            ptr->getMemoryAddr(&addr.base, &addr.offset);
         }
-        inst->setMemoryAddr(ARM64_TMP_REG_NO2, baseOff);
-        // add t1, l0, l1, lsl 2
+        return;
     }
+
+    gep_level(gep, addr);
+}
+
+void InstSelectorArm64::gep_level(Instruction *gep, MemAddr &addr, int32_t dst) {
+    gep_address(gep->getOperand(0), addr);
+
+    Value *index = gep->getOperand(1);
+    int64_t l = ((ArrayType*)(gep->getType()))->getElementType()->getSize();
+    if (Instanceof(off, ConstInt*, index)) {
+        addr.offset += off->getVal() * l;
+        return;
+    }
+
+    materialize_symbol(addr);
+
+    // 前面的维度已有变量下标时先加到基址上
+    if (addr.index != -1) {
+        add_index(addr.base, addr.index, addr.shift);
+        addr.base = ARM64_TMP_REG_NO2;
+        addr.index = -1;
+    }
+
+    int32_t reg = index->getRegId();
+    if (reg == -1) {
+        reg = ARM64_TMP_REG_NO;
+        iloc.load_var(reg, index);
+    }
+
+    std::vector<MulStep> steps;
+    if (__builtin_popcountll(l) == 1) {
+        if (reg != ARM64_TMP_REG_NO) {
+            // 留到访存时折叠到寻址方式中
+            addr.index = reg;
+            addr.shift = __builtin_ctzll(l);
+        } else {
+            add_index(addr.base, reg, __builtin_ctzll(l), dst);
+            addr.base = dst;
+        }
+    } else if (plan_mul_const((int32_t) (l >> __builtin_ctzll(l)), reg != ARM64_TMP_REG_NO, steps)) {
+        // 元素大小的奇数部分用移位加减乘到w16中，2的幂部分在加到基址时移位
+        // add w16, w20, w20, lsl #3; add x17, x19, w16, sxtw #2
+        emit_mul_const(steps, ARM64_TMP_REG_NO, reg);
+        add_index(addr.base, ARM64_TMP_REG_NO, __builtin_ctzll(l), dst);
+        addr.base = dst;
+    } else if (reg != ARM64_TMP_REG_NO) {
+        // smaddl x17, w20, w16, x19
+        iloc.load_imm(ARM64_TMP_REG_NO, (int) l);
+        iloc.inst("smaddl", XREG(dst), PlatformArm64::regName[reg],
+                  PlatformArm64::regName[ARM64_TMP_REG_NO] + "," + XREG(addr.base));
+        addr.base = dst;
+    } else {
+        // 下标在x16中，没有别的临时寄存器保存元素大小，按其二进制位移位相加
+        iloc.inst("sxtw", XREG(ARM64_TMP_REG_NO), PlatformArm64::regName[ARM64_TMP_REG_NO]);
+        for (int32_t k = 0; k < 64; k++) {
+            if (l & (1LL << k)) {
+                iloc.inst("add", XREG(dst), XREG(addr.base), XREG(ARM64_TMP_REG_NO) + ",lsl #" + to_string(k));
+                addr.base = dst;
+            }
+        }
+    }
+}
+
+void InstSelectorArm64::materialize_symbol(MemAddr &addr) {
+    if (addr.symbol.empty()) {
+        return;
+    }
+
+    // adrp x17, a+8; add x17, x17, :lo12:a+8
+    std::string sym = addr.symbol;
+    if (addr.offset) {
+        sym += (addr.offset > 0 ? "+" : "") + to_string(addr.offset);
+    }
+    iloc.inst("adrp", XREG(ARM64_TMP_REG_NO2), sym);
+    iloc.inst("add", XREG(ARM64_TMP_REG_NO2), XREG(ARM64_TMP_REG_NO2), ":lo12:" + sym);
+    addr.symbol.clear();
+    addr.base = ARM64_TMP_REG_NO2;
+    addr.offset = 0;
+}
+
+void InstSelectorArm64::add_index(int32_t base, int32_t index, int32_t shift, int32_t dst) {
+    if (shift <= 4) {
+        // add x17, x19, w20, sxtw #2
+        iloc.inst("add", XREG(dst), XREG(base), PlatformArm64::regName[index] + ",sxtw #" + to_string(shift));
+    } else {
+        // 扩展的寄存器最多左移4位
+        iloc.inst("sxtw", XREG(ARM64_TMP_REG_NO), PlatformArm64::regName[index]);
+        iloc.inst("add", XREG(dst), XREG(base), XREG(ARM64_TMP_REG_NO) + ",lsl #" + to_string(shift));
+    }
+}
+
+std::string InstSelectorArm64::mem_operand(MemAddr &addr, int32_t size) {
+    if (!addr.symbol.empty()) {
+        // 只有常量下标：adrp x17, a+8; ldr w0, [x17, :lo12:a+8]
+        std::string sym = addr.symbol;
+        if (addr.offset) {
+            sym += (addr.offset > 0 ? "+" : "") + to_string(addr.offset);
+        }
+        iloc.inst("adrp", XREG(ARM64_TMP_REG_NO2), sym);
+        return "[" + XREG(ARM64_TMP_REG_NO2) + ",:lo12:" + sym + "]";
+    }
+
+    if (addr.index != -1) {
+        if (addr.offset == 0 && (addr.shift == 0 || addr.shift == __builtin_ctz(size))) {
+            // ldr w0, [x19, w20, sxtw #2]
+            return "[" + XREG(addr.base) + "," + PlatformArm64::regName[addr.index] + ",sxtw #"
+                   + to_string(addr.shift) + "]";
+        }
+        add_index(addr.base, addr.index, addr.shift);
+        addr.base = ARM64_TMP_REG_NO2;
+        addr.index = -1;
+    }
+
+    if (!PlatformArm64::isDisp(addr.offset)) {
+        // 偏移超出范围时先加到基址上
+        iloc.load_imm(ARM64_TMP_REG_NO, (int) addr.offset);
+        add_index(addr.base, ARM64_TMP_REG_NO, 0);
+        addr.base = ARM64_TMP_REG_NO2;
+        addr.offset = 0;
+    }
+
+    std::string operand = XREG(addr.base);
+    if (addr.offset) {
+        operand += "," + iloc.toStr(addr.offset);
+    }
+    return "[" + operand + "]";
 }
 
 void InstSelectorArm64::translate_store(Instruction *inst) {
-    int64_t off = 0;
     Value *ptr = inst->getOperand(0),
           *src = inst->getOperand(1);
-    int32_t basereg = ptr->getRegId(),
-            loadreg = src->getRegId();
+
+    // 先计算地址，x16用于读取溢出的值
+    MemAddr addr;
+    gep_address(ptr, addr);
+    std::string mem = mem_operand(addr, 4);
+
+    int32_t loadreg = src->getRegId();
     if (loadreg == -1) {
-        loadreg = ARM64_TMP_REG_NO;
+        loadreg = PlatformArm64::isFloatValue(src) ? ARM64_FTMP_REG_NO : ARM64_TMP_REG_NO;
         iloc.load_var(loadreg, src);
     }
-    if (basereg == -1) {
-        ptr->getMemoryAddr(&basereg, &off);
-    }
-    
-    iloc.store_base(loadreg, basereg, off, ARM64_TMP_REG_NO);
+
+    iloc.inst("str", PlatformArm64::regName[loadreg], mem);
 }
 
 void InstSelectorArm64::translate_load(Instruction *inst) {
-    int64_t off = 0;
-    Value *addr = inst->getOperand(0);
-    int32_t basereg = addr->getRegId(),
-            loadreg = inst->getRegId();
+    MemAddr addr;
+    gep_address(inst->getOperand(0), addr);
+    std::string mem = mem_operand(addr, 4);
+
+    int32_t loadreg = inst->getRegId();
     if (loadreg == -1) {
-        loadreg = ARM64_TMP_REG_NO;
-        iloc.load_var(loadreg, addr);
+        // 结果溢出到栈内时先读到临时寄存器，浮点用s16
+        loadreg = PlatformArm64::isFloatValue(inst) ? ARM64_FTMP_REG_NO : ARM64_TMP_REG_NO;
+    }
+    iloc.inst("ldr", PlatformArm64::regName[loadreg], mem);
+    if (inst->getRegId() == -1) {
+        iloc.store_var(loadreg, inst, ARM64_TMP_REG_NO);
+    }
+}
+
+void InstSelectorArm64::translate_memset(Instruction * inst)
+{
+    int32_t size = static_cast<MemsetInstruction *>(inst)->getSize();
+
+    MemAddr addr;
+    gep_address(inst->getOperand(0), addr);
+    materialize_symbol(addr);
+    if (addr.index != -1) {
+        add_index(addr.base, addr.index, addr.shift);
+        addr.base = ARM64_TMP_REG_NO2;
+        addr.index = -1;
+    }
+
+    // stp的偏移是8的倍数且在[-512,504]内，负偏移的str在[-256,-1]内
+    int64_t last = addr.offset + size - 4;
+    if (size <= 256 && addr.offset % 8 == 0 && addr.offset >= -256 && last <= 504) {
+        zero_stores(addr.base, addr.offset, size);
+        return;
+    }
+
+    // x17 = 起始地址
+    if (addr.offset == 0) {
+        if (addr.base != ARM64_TMP_REG_NO2) {
+            iloc.inst("mov", XREG(ARM64_TMP_REG_NO2), XREG(addr.base));
+        }
+    } else if (PlatformArm64::isDisp((int) addr.offset)) {
+        iloc.inst(addr.offset > 0 ? "add" : "sub",
+                  XREG(ARM64_TMP_REG_NO2),
+                  XREG(addr.base),
+                  iloc.toStr((int) std::abs(addr.offset)));
+    } else {
+        iloc.load_imm(ARM64_TMP_REG_NO, (int) addr.offset);
+        iloc.inst("add", XREG(ARM64_TMP_REG_NO2), XREG(addr.base), XREG(ARM64_TMP_REG_NO));
     }
-    if (basereg == -1) {
-        addr->getMemoryAddr(&basereg, &off);
+
+    if (size <= 256) {
+        zero_stores(ARM64_TMP_REG_NO2, 0, size);
+        return;
+    }
+
+    // x16 = 循环清零部分的结束地址
+    int32_t loopSize = size / 64 * 64;
+    if (PlatformArm64::isDisp(loopSize)) {
+        iloc.inst("add", XREG(ARM64_TMP_REG_NO), XREG(ARM64_TMP_REG_NO2), iloc.toStr(loopSize));
+    } else {
+        iloc.load_imm(ARM64_TMP_REG_NO, loopSize);
+        iloc.inst("add", XREG(ARM64_TMP_REG_NO), XREG(ARM64_TMP_REG_NO2), XREG(ARM64_TMP_REG_NO));
+    }
+
+    // .L1: stp xzr,xzr,[x17,#16] ... stp xzr,xzr,[x17],#64; cmp x17,x16; blo .L1
+    iloc.label(inst->getName());
+    for (int32_t off = 16; off < 64; off += 16) {
+        iloc.inst("stp", "xzr", "xzr", "[" + XREG(ARM64_TMP_REG_NO2) + "," + iloc.toStr(off) + "]");
+    }
+    iloc.inst("stp", "xzr", "xzr", "[" + XREG(ARM64_TMP_REG_NO2) + "]," + iloc.toStr(64));
+    iloc.inst("cmp", XREG(ARM64_TMP_REG_NO2), XREG(ARM64_TMP_REG_NO));
+    iloc.branch("lo", inst->getName());
+
+    zero_stores(ARM64_TMP_REG_NO2, 0, size - loopSize);
+}
+
+void InstSelectorArm64::zero_stores(int32_t base, int64_t offset, int32_t size)
+{
+    std::string reg = XREG(base);
+    int64_t end = offset + size;
+
+    for (; offset + 16 <= end; offset += 16) {
+        iloc.inst("stp", "xzr", "xzr", "[" + reg + "," + iloc.toStr((int) offset) + "]");
+    }
+    if (offset + 8 <= end) {
+        iloc.inst("str", "xzr", "[" + reg + "," + iloc.toStr((int) offset) + "]");
+        offset += 8;
+    }
+    if (offset < end) {
+        iloc.inst("str", "wzr", "[" + reg + "," + iloc.toStr((int) offset) + "]");
     }
-    iloc.load_base(loadreg, basereg, off);
 }
 
 void InstSelectorArm64::translate_bi_op(Instruction * inst)
@@ -486,7 +1051,7 @@ void InstSelectorArm64::translate_bi_op(Instruction * inst)
         case IRINST_OP_ILT: {
             lstcmp = inst->getOp();
             Instanceof(v, ConstInt *, inst->getOperand(1));
-            if (v && v->getVal() == 0) {
+            if (v && v->getVal() == 0 && !iloc.getCode().empty()) {
                 ArmInst * it = iloc.getCode().back();
                 int32_t reg = inst->getOperand(0)->getRegId();
                 if (reg >= 0 && PlatformArm64::regName[reg] == it->arg1 &&
@@ -499,6 +1064,35 @@ void InstSelectorArm64::translate_bi_op(Instruction * inst)
             inst->setRegId(ARM64_ZR_REG_NO);
             translate_two_operator(inst, "subs");
             inst->setRegId(x);
+            break;
+        }
+        case IRINST_OP_FEQ:
+        case IRINST_OP_FNE:
+        case IRINST_OP_FGT:
+        case IRINST_OP_FGE:
+        case IRINST_OP_FLT:
+        case IRINST_OP_FLE: {
+            // fcmp后条件码与整数比较相同，后续的跳转与cset按整数比较处理
+            lstcmp = icmpOp(inst->getOp());
+            Value * arg1 = inst->getOperand(0);
+            Value * arg2 = inst->getOperand(1);
+            int32_t reg1 = arg1->getRegId(), reg2 = arg2->getRegId();
+            if (reg1 == -1) {
+                reg1 = ARM64_FTMP_REG_NO;
+                iloc.load_var(reg1, arg1);
+            }
+            Instanceof(c, ConstFloat *, arg2);
+            if (c && c->getVal() == 0) {
+                // fcmp s0,#0.0
+                iloc.inst("fcmp", PlatformArm64::regName[reg1], "#0.0");
+                break;
+            }
+            if (reg2 == -1) {
+                reg2 = ARM64_FTMP_REG_NO2;
+                iloc.load_var(reg2, arg2);
+            }
+            iloc.inst("fcmp", PlatformArm64::regName[reg1], PlatformArm64::regName[reg2]);
+            break;
         }
         default:
             return;
@@ -521,17 +1115,51 @@ void InstSelectorArm64::translate_cast(Instruction * inst)
                 iloc.store_var(ARM64_TMP_REG_NO2, arg, ARM64_TMP_REG_NO);
             }
             break;
+        case CastInstruction::INT_TO_FLOAT:
+            // scvtf s0,w0
+            translate_convert(inst, "scvtf");
+            break;
+        case CastInstruction::FLOAT_TO_INT:
+            // 向零取整 fcvtzs w0,s0
+            translate_convert(inst, "fcvtzs");
+            break;
         default:
             break;
     }
 }
 
+/// @brief 整数与浮点之间的类型转换翻译成ARM64汇编
+/// @param inst IR指令
+/// @param operator_name 转换指令
+void InstSelectorArm64::translate_convert(Instruction * inst, string operator_name)
+{
+    Value * arg = inst->getOperand(0);
+    int32_t arg_reg_no = arg->getRegId();
+    int32_t result_reg_no = inst->getRegId();
+
+    if (arg_reg_no == -1) {
+        arg_reg_no = PlatformArm64::isFloatValue(arg) ? ARM64_FTMP_REG_NO : ARM64_TMP_REG_NO;
+        iloc.load_var(arg_reg_no, arg);
+    }
+
+    int32_t load_result_reg_no = result_reg_no;
+    if (result_reg_no == -1) {
+        load_result_reg_no = PlatformArm64::isFloatValue(inst) ? ARM64_FTMP_REG_NO2 : ARM64_TMP_REG_NO2;
+    }
+
+    iloc.inst(operator_name, PlatformArm64::regName[load_result_reg_no], PlatformArm64::regName[arg_reg_no]);
+
+    if (result_reg_no == -1) {
+        iloc.store_var(load_result_reg_no, inst, ARM64_TMP_REG_NO);
+    }
+}
+
 void InstSelectorArm64::translate_xor_int32(Instruction * inst)
 {
     Instanceof(l, Instruction *, inst->getOperand(0));
     Instanceof(v, ConstInt *, inst->getOperand(1));
     IRInstOperator ir;
-    if (v && l && v->getVal() == 1 && (ir = l->getOp()) >= IRINST_OP_IEQ && ir <= IRINST_OP_ILT) {
+    if (v && l && v->getVal() == 1 && (ir = icmpOp(l->getOp())) >= IRINST_OP_IEQ && ir <= IRINST_OP_ILT) {
         int32_t regId = inst->getRegId(), load_regId;
         if (regId == -1) {
             load_regId = simpleRegisterAllocator.Allocate(inst);
@@ -577,11 +1205,15 @@ void InstSelectorArm64::translate_call(Instruction * inst)
         simpleRegisterAllocator.Allocate(6);
         simpleRegisterAllocator.Allocate(7);
 
-        // 前四个的后面参数采用栈传递
+        // 整数与浮点参数分别使用x0-x7与s0-s7，其余的参数采用栈传递
         int esp = 0;
-        for (int32_t k = 8; k < operandNum; k++) {
+        int32_t intCnt = 0, floatCnt = 0;
+        for (int32_t k = 0; k < operandNum; k++) {
 
             auto arg = callInst->getOperand(k);
+            if (arg == callInst || PlatformArm64::argRegNo(arg, intCnt, floatCnt) != -1) {
+                continue;
+            }
 
             // 新建一个内存变量，用于栈传值到形参变量中
             MemVariable * newVal = func->newMemVariable((Type *) PointerType::get(arg->getType()));
@@ -596,24 +1228,29 @@ void InstSelectorArm64::translate_call(Instruction * inst)
             delete assignInst;
         }
 
-        for (int32_t k = 0, d = 0; k < operandNum && k < 8; k++) {
+        intCnt = floatCnt = 0;
+        for (int32_t k = 0; k < operandNum; k++) {
 
             auto arg = callInst->getOperand(k);
             if (arg == callInst) {
                 continue;
             }
 
+            int32_t reg = PlatformArm64::argRegNo(arg, intCnt, floatCnt);
+            if (reg == -1) {
+                continue;
+            }
+
             // 检查实参的类型是否是临时变量。
             // 如果是临时变量，该变量可更改为寄存器变量即可，或者设置寄存器号
             // 如果不是，则必须开辟一个寄存器变量，然后赋值即可
 
-            Instruction * assignInst = new MoveInstruction(func, PlatformArm64::intRegVal[d], arg);
+            Instruction * assignInst = new MoveInstruction(func, PlatformArm64::regVal(reg), arg);
 
             // 翻译赋值指令
             translate_assign(assignInst);
 
             delete assignInst;
-            d++;
         }
     }
 
@@ -631,6 +1268,7 @@ void InstSelectorArm64::translate_call(Instruction * inst)
     }
     // 函数调用后清零，使得下次可正常统计
     realArgCount = 0;
+    argIntCount = argFloatCount = 0;
 }
 
 ///
@@ -645,10 +1283,11 @@ void InstSelectorArm64::translate_arg(Instruction * inst)
     // 当前统计的ARG指令个数
     int32_t regId = src->getRegId();
 
-    if (realArgCount < 8) {
-        // 前四个参数
+    int32_t argReg = PlatformArm64::argRegNo(src, argIntCount, argFloatCount);
+    if (argReg != -1) {
+        // 寄存器传递的参数
         if (regId != -1) {
-            if (regId != realArgCount) {
+            if (regId != argReg) {
                 // 肯定寄存器分配有误
                 minic_log(LOG_ERROR, "第%d个ARG指令对象寄存器分配有误: %d", argCount + 1, regId);
             }
@@ -20,6 +20,7 @@
 #include "Function.h"
 #include "ILocArm64.h"
 #include "Instruction.h"
+#include "PlatformArm64.h"
 #include "SimpleRegisterAllocator.h"
 
 using namespace std;
@@ -53,6 +54,12 @@ protected:
     /// @param inst IR指令
     void translate_exit(Instruction * inst);
 
+    /// @brief 建立栈帧，保存被保护的寄存器并分配栈空间
+    void translate_prologue();
+
+    /// @brief 恢复栈帧，释放栈空间并恢复被保护的寄存器
+    void translate_epilogue();
+
     /// @brief 赋值指令翻译成ARM32汇编
     /// @param inst IR指令
     void translate_assign(Instruction * inst);
@@ -75,10 +82,46 @@ protected:
 
     void translate_mul_int32(Instruction * inst);
 
+    /// @brief 乘以常量分解出的一条指令：v = a op (b << shift)，a、b为被乘数x或者当前的部分积v，
+    /// lsl与neg只有b，第一条指令的v就是x
+    struct MulStep {
+        enum Op {
+            LSL, ///< v = b << shift
+            NEG, ///< v = -(b << shift)
+            ADD, ///< v = a + (b << shift)
+            SUB, ///< v = a - (b << shift)
+        };
+        Op op = LSL;
+        bool aIsX = false;
+        bool bIsX = false;
+        int32_t shift = 0;
+    };
+
+    /// @brief 32位整数乘以常量分解为至多两条lsl、neg以及带移位操作数的add/sub。
+    /// 按Cortex-A53/A72估计，移位不超过4时每条1个周期，否则2个周期，合计超过3个周期时不如mov+mul。
+    /// 按第二条指令的每种形式由常量直接反推第一条指令的倍数，只需常数时间
+    /// @param c 常量
+    /// @param keepSrc 被乘数所在的寄存器在第一条指令后是否仍然可用，即结果与被乘数不在同一寄存器
+    /// @param steps 指令序列
+    /// @return true 可以分解，false 不能分解
+    static bool plan_mul_const(int32_t c, bool keepSrc, std::vector<MulStep> & steps);
+
+    /// @brief 产生乘以常量的指令序列
+    /// @param steps plan_mul_const得到的指令序列
+    /// @param dst 结果寄存器
+    /// @param src 被乘数寄存器
+    void emit_mul_const(const std::vector<MulStep> & steps, int32_t dst, int32_t src);
+
     void translate_div_int32(Instruction * inst);
 
     void translate_rem_int32(Instruction * inst);
 
+    /// @brief 除数为常量的整数除法与求余，2的幂改为移位，其它改为乘以魔数取高位
+    /// @param inst IR指令
+    /// @param rem true求余，false除法
+    /// @return true 已翻译，false 除数不是常量或者为0、INT32_MIN，仍用sdiv
+    bool translate_div_const(Instruction * inst, bool rem);
+
     void translate_xor_int32(Instruction * inst);
 
     /// @brief 二元操作指令翻译成ARM32汇编
@@ -94,13 +137,72 @@ protected:
     void translate_fdiv(Instruction *);
     void translate_fmod(Instruction *);
 
+    /// @brief 分配到寄存器的GEP在此计算地址，其余的GEP不产生代码，地址在访存时通过gep_address折叠到寻址方式中
+    /// @param inst IR指令
     void translate_gep(Instruction *);
 
+    /// @brief 全局数组的地址取到寄存器中，没有分配到寄存器时在访存处按符号寻址
+    /// @param inst IR指令
+    void translate_addr(Instruction *);
+
+    /// @brief 访存地址：基址寄存器+立即数偏移，可再加一个符号扩展并移位的32位下标寄存器。
+    /// 全局数组的基址是符号，只有常量下标时偏移并入重定位 :lo12:a+8，不需要单独计算地址
+    struct MemAddr {
+        std::string symbol;
+        int32_t base = -1;
+        int64_t offset = 0;
+        int32_t index = -1;
+        int32_t shift = 0;
+    };
+
+    /// @brief 计算访存地址，GEP链逐级展开到有寄存器的GEP为止，常量下标并入偏移，中间结果只在x17中，x16用完即可改写
+    /// @param ptr 访存的地址
+    /// @param addr 地址
+    void gep_address(Value * ptr, MemAddr & addr);
+
+    /// @brief 计算一级GEP的地址，基址由gep_address得到，再加上本级下标乘元素大小
+    /// @param gep GEP指令
+    /// @param addr 地址
+    /// @param dst 本级下标加到基址上时的目的寄存器，默认x17
+    void gep_level(Instruction * gep, MemAddr & addr, int32_t dst = ARM64_TMP_REG_NO2);
+
+    /// @brief 全局数组的地址加上偏移读到x17中作为基址
+    /// @param addr 地址
+    void materialize_symbol(MemAddr & addr);
+
+    /// @brief dst = 基址 + 符号扩展后移位的下标
+    /// @param base 基址寄存器
+    /// @param index 32位下标寄存器
+    /// @param shift 移位
+    /// @param dst 目的寄存器，默认x17
+    void add_index(int32_t base, int32_t index, int32_t shift, int32_t dst = ARM64_TMP_REG_NO2);
+
+    /// @brief 访存地址转换为寻址方式，不能直接寻址的部分先加到x17中
+    /// @param addr 地址
+    /// @param size 访存的字节数，下标的移位与之相符时才能用寄存器偏移寻址
+    /// @return 寻址方式，如[x19,w20,sxtw #2]、[x17,#8]
+    std::string mem_operand(MemAddr & addr, int32_t size);
+
     void translate_store(Instruction *);
     void translate_load(Instruction *);
 
+    /// @brief 内存块清零，较小的逐个存入零寄存器，较大的每次循环清零64字节
+    /// @param inst IR指令
+    void translate_memset(Instruction *);
+
+    /// @brief 从基址加偏移处开始逐个存入零寄存器
+    /// @param base 基址寄存器
+    /// @param offset 起始偏移，要求是8的倍数
+    /// @param size 字节数，要求是4的倍数
+    void zero_stores(int32_t base, int64_t offset, int32_t size);
+
     void translate_cast(Instruction *);
 
+    /// @brief 整数与浮点之间的类型转换翻译成ARM64汇编
+    /// @param inst IR指令
+    /// @param operator_name 转换指令
+    void translate_convert(Instruction * inst, string operator_name);
+
     /// @brief 函数调用指令翻译成ARM32汇编
     /// @param inst IR指令
     void translate_call(Instruction * inst);
@@ -135,6 +237,10 @@ protected:
     /// @brief 累计的实参个数
     int32_t realArgCount = 0;
 
+    /// @brief 累计的整数与浮点传参寄存器个数
+    int32_t argIntCount = 0;
+    int32_t argFloatCount = 0;
+
     /**
      * @brief 显示IR指令内容
      */
@@ -0,0 +1,287 @@
+///
+/// @file LiveRangeSplitter.cpp
+/// @brief 在循环边界处拆分溢出值的活跃区间
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "LiveRangeSplitter.h"
+#include "LivenessArm64.h"
+#include "BasicBlock.h"
+#include "Function.h"
+#include "LoopInfo.h"
+#include "Instruction.h"
+#include "MoveInstruction.h"
+#include "FormalParam.h"
+
+///
+/// @brief 构造函数
+/// @param _func 函数，要求已经划分了基本块
+/// @param _loopInfo 函数的循环分析结果
+///
+LiveRangeSplitter::LiveRangeSplitter(Function * _func, LoopInfo & _loopInfo) : func(_func), loopInfo(_loopInfo)
+{}
+
+///
+/// @brief 对溢出的值在循环边界处拆分
+/// @param spilled 溢出的值
+/// @param liveness 函数当前的活跃变量分析结果
+/// @return true 有值被拆分，需要重新进行活跃变量分析以及寄存器分配
+/// @return false 没有拆分
+///
+bool LiveRangeSplitter::run(const std::vector<Value *> & spilled, LivenessArm64 & liveness)
+{
+    blockOf.clear();
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            blockOf[inst] = block;
+        }
+    }
+
+    bool changed = false;
+    for (auto val: spilled) {
+        // 数组形参与全局数组的地址由GEP直接使用，GEP的地址在使用处重新计算，不拆分
+        Instruction * inst = dynamic_cast<Instruction *>(val);
+        if (val->getType()->isArrayType()
+            || (inst && (inst->getOp() == IRInstOperator::IRINST_OP_ADDR || inst->getOp() == IRInstOperator::IRINST_OP_GEP))) {
+            continue;
+        }
+        if (split(val, loopInfo.getTopLevelLoops(), liveness)) {
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief 在给定的循环中找可拆分的循环进行拆分，不可拆分时尝试内层循环
+/// @param val 溢出的值
+/// @param loops 循环
+/// @param liveness 活跃变量分析结果
+/// @return true 有拆分
+/// @return false 没有拆分
+///
+bool LiveRangeSplitter::split(Value * val, std::vector<Loop *> & loops, LivenessArm64 & liveness)
+{
+    bool changed = false;
+
+    for (auto loop: loops) {
+        if (!refersIn(val, loop, true)) {
+            continue;
+        }
+
+        // 只在该循环内引用时拆分没有意义，到内层循环再尝试
+        if (refersIn(val, loop, false) && canSplit(val, loop, liveness)) {
+            splitAt(val, loop, liveness);
+            changed = true;
+        } else if (split(val, loop->getSubLoops(), liveness)) {
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief 值能否在循环边界处拆分
+/// @param val 值
+/// @param loop 循环
+/// @param liveness 活跃变量分析结果
+/// @return true 可以
+/// @return false 不可以
+///
+bool LiveRangeSplitter::canSplit(Value * val, Loop * loop, LivenessArm64 & liveness)
+{
+    // 指令的结果不能改名，只能拆分循环外定义的
+    Instruction * def = dynamic_cast<Instruction *>(val);
+    if (def && loop->contains(blockOf[def])) {
+        return false;
+    }
+
+    // GEP在使用处计算地址，GEP与其使用者必须同在循环内或同在循环外，改名后才一致
+    for (auto & pair: blockOf) {
+        Instruction * gep = pair.first;
+        if (gep->isDead() || gep->getOp() != IRInstOperator::IRINST_OP_GEP || !refers(gep, val)) {
+            continue;
+        }
+        bool inside = loop->contains(pair.second);
+        for (auto use: gep->getUseList()) {
+            Instruction * user = dynamic_cast<Instruction *>(use->getUser());
+            if (user && !user->isDead() && blockOf.count(user) && loop->contains(blockOf[user]) != inside) {
+                return false;
+            }
+        }
+    }
+
+    // 循环入口处活跃时需要在前置块内复制
+    if (liveIn(val, loop->getHeader(), liveness) && !loop->getPreheader()) {
+        return false;
+    }
+
+    // 循环内有定义时需要在出口块复制回去，出口块只能从循环内到达
+    if (definedIn(val, loop)) {
+        for (auto exit: loop->getExitBlocks()) {
+            if (!liveIn(val, exit, liveness)) {
+                continue;
+            }
+            for (auto pred: exit->getPreds()) {
+                if (!loop->contains(pred)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+///
+/// @brief 在循环边界处拆分，循环内的引用改为新的局部变量，并插入拆分点的复制指令
+/// @param val 值
+/// @param loop 循环
+/// @param liveness 活跃变量分析结果
+///
+void LiveRangeSplitter::splitAt(Value * val, Loop * loop, LivenessArm64 & liveness)
+{
+    bool defined = definedIn(val, loop);
+
+    LocalVariable * part = func->newLocalVarValue(val->getType());
+
+    // 循环内的引用，包括循环内GEP的操作数，都改为新的变量
+    for (auto block: loop->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            for (int32_t k = 0; k < inst->getOperandsNum(); k++) {
+                if (inst->getOperand(k) == val) {
+                    inst->setOperand(k, part);
+                }
+            }
+        }
+    }
+
+    // 进入循环时从原值复制
+    if (liveIn(val, loop->getHeader(), liveness)) {
+        BasicBlock * preheader = loop->getPreheader();
+        MoveInstruction * move = new MoveInstruction(func, part, val);
+        preheader->insertBeforeTerminator(move);
+        blockOf[move] = preheader;
+    }
+
+    // 离开循环时复制回原值，放在出口块的Label指令之后
+    if (defined) {
+        for (auto exit: loop->getExitBlocks()) {
+            if (!liveIn(val, exit, liveness)) {
+                continue;
+            }
+            auto & insts = exit->getInsts();
+            auto pos = insts.begin();
+            if (pos != insts.end() && (*pos)->getOp() == IRInstOperator::IRINST_OP_LABEL) {
+                ++pos;
+            }
+            MoveInstruction * move = new MoveInstruction(func, val, part);
+            insts.insert(pos, move);
+            blockOf[move] = exit;
+        }
+    }
+}
+
+///
+/// @brief 指令是否引用了值，GEP操作数递归展开，与活跃变量分析一致
+/// @param inst 指令
+/// @param val 值
+/// @return true 引用
+/// @return false 没有引用
+///
+bool LiveRangeSplitter::refers(Instruction * inst, Value * val)
+{
+    for (int32_t k = 0; k < inst->getOperandsNum(); k++) {
+        Value * operand = inst->getOperand(k);
+        if (operand == val) {
+            return true;
+        }
+        Instruction * gep = dynamic_cast<Instruction *>(operand);
+        if (gep && gep != inst && gep->getOp() == IRInstOperator::IRINST_OP_GEP && refers(gep, val)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+///
+/// @brief 循环内或循环外是否有指令引用值
+/// @param val 值
+/// @param loop 循环
+/// @param inside true查找循环内，false查找循环外
+/// @return true 有引用
+/// @return false 没有引用
+///
+bool LiveRangeSplitter::refersIn(Value * val, Loop * loop, bool inside)
+{
+    // 形参在入口处定义，循环外定义的指令结果也算作循环外的引用
+    if (!inside) {
+        if (dynamic_cast<FormalParam *>(val)) {
+            return true;
+        }
+        Instruction * def = dynamic_cast<Instruction *>(val);
+        if (def && !loop->contains(blockOf[def])) {
+            return true;
+        }
+    }
+
+    for (auto block: func->getBlocks()) {
+        if (loop->contains(block) != inside) {
+            continue;
+        }
+        for (auto inst: block->getInsts()) {
+            if (!inst->isDead() && refers(inst, val)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+///
+/// @brief 值在循环内是否有定义
+/// @param val 值
+/// @param loop 循环
+/// @return true 有定义
+/// @return false 没有定义
+///
+bool LiveRangeSplitter::definedIn(Value * val, Loop * loop)
+{
+    for (auto block: loop->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            if (!inst->isDead() && inst->getOp() == IRInstOperator::IRINST_OP_ASSIGN && inst->getOperand(0) == val) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+///
+/// @brief 值在基本块入口处是否活跃
+/// @param val 值
+/// @param block 基本块
+/// @param liveness 活跃变量分析结果
+/// @return true 活跃
+/// @return false 不活跃
+///
+bool LiveRangeSplitter::liveIn(Value * val, BasicBlock * block, LivenessArm64 & liveness)
+{
+    int32_t index = liveness.getIndex(val);
+    return index != -1 && liveness.isLiveIn(block, index);
+}
@@ -0,0 +1,139 @@
+///
+/// @file LiveRangeSplitter.h
+/// @brief 在循环边界处拆分溢出值的活跃区间
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+class Function;
+class BasicBlock;
+class Instruction;
+class Value;
+class Loop;
+class LoopInfo;
+class LivenessArm64;
+
+///
+/// @brief 在循环边界处拆分溢出值的活跃区间
+///
+/// 溢出的值若在某个循环内被引用，且在循环外也有引用，则在循环内改用一个新的局部变量：
+/// 循环入口处活跃时在前置块内从原值复制，循环内有定义且在出口块入口处活跃时在出口块开头复制回原值。
+/// 这样循环内的部分是一个短而使用频繁的区间，可以单独分到寄存器，
+/// 循环外的部分仍可溢出，访存只发生在拆分点而不是循环内的每次使用处。
+/// 从最外层的循环开始尝试，不满足拆分条件或者值只在该循环内引用时再尝试内层循环。
+///
+class LiveRangeSplitter {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _func 函数，要求已经划分了基本块
+    /// @param _loopInfo 函数的循环分析结果
+    ///
+    LiveRangeSplitter(Function * _func, LoopInfo & _loopInfo);
+
+    ///
+    /// @brief 对溢出的值在循环边界处拆分
+    /// @param spilled 溢出的值
+    /// @param liveness 函数当前的活跃变量分析结果
+    /// @return true 有值被拆分，需要重新进行活跃变量分析以及寄存器分配
+    /// @return false 没有拆分
+    ///
+    bool run(const std::vector<Value *> & spilled, LivenessArm64 & liveness);
+
+private:
+    ///
+    /// @brief 在给定的循环中找可拆分的循环进行拆分，不可拆分时尝试内层循环
+    /// @param val 溢出的值
+    /// @param loops 循环
+    /// @param liveness 活跃变量分析结果
+    /// @return true 有拆分
+    /// @return false 没有拆分
+    ///
+    bool split(Value * val, std::vector<Loop *> & loops, LivenessArm64 & liveness);
+
+    ///
+    /// @brief 值能否在循环边界处拆分
+    /// @param val 值
+    /// @param loop 循环
+    /// @param liveness 活跃变量分析结果
+    /// @return true 可以
+    /// @return false 不可以
+    ///
+    bool canSplit(Value * val, Loop * loop, LivenessArm64 & liveness);
+
+    ///
+    /// @brief 在循环边界处拆分，循环内的引用改为新的局部变量，并插入拆分点的复制指令
+    /// @param val 值
+    /// @param loop 循环
+    /// @param liveness 活跃变量分析结果
+    ///
+    void splitAt(Value * val, Loop * loop, LivenessArm64 & liveness);
+
+    ///
+    /// @brief 指令是否引用了值，GEP操作数递归展开，与活跃变量分析一致
+    /// @param inst 指令
+    /// @param val 值
+    /// @return true 引用
+    /// @return false 没有引用
+    ///
+    static bool refers(Instruction * inst, Value * val);
+
+    ///
+    /// @brief 循环内或循环外是否有指令引用值
+    /// @param val 值
+    /// @param loop 循环
+    /// @param inside true查找循环内，false查找循环外
+    /// @return true 有引用
+    /// @return false 没有引用
+    ///
+    bool refersIn(Value * val, Loop * loop, bool inside);
+
+    ///
+    /// @brief 值在循环内是否有定义
+    /// @param val 值
+    /// @param loop 循环
+    /// @return true 有定义
+    /// @return false 没有定义
+    ///
+    bool definedIn(Value * val, Loop * loop);
+
+    ///
+    /// @brief 值在基本块入口处是否活跃
+    /// @param val 值
+    /// @param block 基本块
+    /// @param liveness 活跃变量分析结果
+    /// @return true 活跃
+    /// @return false 不活跃
+    ///
+    static bool liveIn(Value * val, BasicBlock * block, LivenessArm64 & liveness);
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func;
+
+    ///
+    /// @brief 循环分析
+    ///
+    LoopInfo & loopInfo;
+
+    ///
+    /// @brief 指令所在的基本块
+    ///
+    std::unordered_map<Instruction *, BasicBlock *> blockOf;
+};
@@ -0,0 +1,389 @@
+///
+/// @file LivenessArm64.cpp
+/// @brief 寄存器分配用的活跃变量分析
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+
+#include "LivenessArm64.h"
+#include "BasicBlock.h"
+#include "ConstInt.h"
+#include "Function.h"
+#include "Instruction.h"
+#include "PlatformArm64.h"
+
+///
+/// @brief 构造函数，进行活跃变量分析
+/// @param _func 函数，要求已经划分了基本块
+///
+LivenessArm64::LivenessArm64(Function * _func) : func(_func)
+{
+    findKeptGeps();
+
+    // 形参先编号，其余的值按出现的顺序编号
+    for (auto param: func->getParams()) {
+        number(param);
+    }
+
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            if (inst->isDead()) {
+                continue;
+            }
+            if (inst->getOp() == IRInstOperator::IRINST_OP_ASSIGN) {
+                number(inst->getOperand(0));
+            } else if (inst->hasResultValue()) {
+                number(inst);
+            }
+            for (int32_t k = 0; k < inst->getOperandsNum(); k++) {
+                number(inst->getOperand(k));
+            }
+        }
+    }
+
+    solve();
+}
+
+///
+/// @brief 值是否是分析对象
+/// @param val 值
+/// @return true 是
+/// @return false 不是
+///
+bool LivenessArm64::isCandidate(Value * val)
+{
+    if (keptGeps.count(dynamic_cast<Instruction *>(val))) {
+        return true;
+    }
+
+    if (dynamic_cast<FormalParam *>(val)) {
+        // 数组形参保存的是数组的地址，同样需要寄存器
+        return true;
+    }
+
+    if (dynamic_cast<LocalVariable *>(val)) {
+        // 局部数组分配在栈内
+        return !val->getType()->isArrayType();
+    }
+
+    Instruction * inst = dynamic_cast<Instruction *>(val);
+    return inst && inst->hasResultValue() && inst->getOp() != IRInstOperator::IRINST_OP_GEP;
+}
+
+///
+/// @brief 找出地址保存在寄存器中的GEP：作为别的GEP的基址，有变量下标，
+/// 并且被多次使用或者在别的基本块内使用(如外提到循环外)，只在定义处计算一次，
+/// 访存时只把最后一级下标折叠到寻址方式中
+///
+void LivenessArm64::findKeptGeps()
+{
+    std::unordered_map<Instruction *, BasicBlock *> blockOf;
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            if (!inst->isDead()) {
+                blockOf[inst] = block;
+            }
+        }
+    }
+
+    for (auto & pair: blockOf) {
+        Instruction * gep = pair.first;
+        if (gep->getOp() != IRInstOperator::IRINST_OP_GEP || !hasVarIndex(gep)) {
+            continue;
+        }
+
+        int32_t useCount = 0;
+        bool isBase = false, remote = false;
+        for (auto use: gep->getUseList()) {
+            auto it = blockOf.find(dynamic_cast<Instruction *>(use->getUser()));
+            if (it == blockOf.end()) {
+                continue;
+            }
+            useCount++;
+            isBase = isBase || it->first->getOp() == IRInstOperator::IRINST_OP_GEP;
+            remote = remote || it->second != pair.second;
+        }
+        if (isBase && (useCount > 1 || remote)) {
+            keptGeps.insert(gep);
+        }
+    }
+}
+
+///
+/// @brief GEP链中是否有变量下标，只有常量下标时地址是基址加常量偏移，不必保存
+/// @param gep GEP指令
+/// @return true 有变量下标
+/// @return false 没有
+///
+bool LivenessArm64::hasVarIndex(Instruction * gep)
+{
+    while (gep && gep->getOp() == IRInstOperator::IRINST_OP_GEP) {
+        if (!dynamic_cast<ConstInt *>(gep->getOperand(1))) {
+            return true;
+        }
+        gep = dynamic_cast<Instruction *>(gep->getOperand(0));
+    }
+
+    return false;
+}
+
+///
+/// @brief 值编号，新的值分配下一个编号
+/// @param val 值
+///
+void LivenessArm64::number(Value * val)
+{
+    if (isCandidate(val) && !indexMap.count(val)) {
+        indexMap[val] = (int32_t) values.size();
+        values.push_back(val);
+    }
+}
+
+///
+/// @brief 获取分析对象的个数
+/// @return int32_t 个数
+///
+int32_t LivenessArm64::getValueCount()
+{
+    return (int32_t) values.size();
+}
+
+///
+/// @brief 获取编号对应的值
+/// @param index 编号
+/// @return Value* 值
+///
+Value * LivenessArm64::getValue(int32_t index)
+{
+    return values[index];
+}
+
+///
+/// @brief 获取值的编号
+/// @param val 值
+/// @return int32_t 编号，不是分析对象时为-1
+///
+int32_t LivenessArm64::getIndex(Value * val)
+{
+    auto it = indexMap.find(val);
+    return it == indexMap.end() ? -1 : it->second;
+}
+
+///
+/// @brief 值是否参与寄存器分配。没有函数调用时寄存器传递的形参直接使用x0-x7或s0-s7，栈传递的形参在栈内
+/// @param index 值的编号
+/// @return true 参与
+/// @return false 不参与
+///
+bool LivenessArm64::isAllocatable(int32_t index)
+{
+    int32_t intCnt = 0, floatCnt = 0;
+    for (auto param: func->getParams()) {
+        int32_t reg = PlatformArm64::argRegNo(param, intCnt, floatCnt);
+        if (param == values[index]) {
+            return func->getExistFuncCall() && reg != -1;
+        }
+    }
+
+    return true;
+}
+
+///
+/// @brief 获取指令定义的值的编号
+/// @param inst 指令
+/// @param defs 定义的值的编号
+///
+void LivenessArm64::getDefs(Instruction * inst, std::vector<int32_t> & defs)
+{
+    defs.clear();
+
+    int32_t index = -1;
+    if (inst->getOp() == IRInstOperator::IRINST_OP_ENTRY) {
+        // 形参的值在函数入口处给定
+        for (auto param: func->getParams()) {
+            defs.push_back(getIndex(param));
+        }
+    } else if (inst->getOp() == IRInstOperator::IRINST_OP_ASSIGN) {
+        index = getIndex(inst->getOperand(0));
+    } else {
+        index = getIndex(inst);
+    }
+
+    if (index != -1) {
+        defs.push_back(index);
+    }
+}
+
+///
+/// @brief 获取指令使用的值的编号，GEP展开为其操作数
+/// @param inst 指令
+/// @param uses 使用的值的编号，可能重复
+///
+void LivenessArm64::getUses(Instruction * inst, std::vector<int32_t> & uses)
+{
+    uses.clear();
+
+    // Move指令的第一个操作数是被赋值的目标
+    int32_t k = inst->getOp() == IRInstOperator::IRINST_OP_ASSIGN ? 1 : 0;
+    for (; k < inst->getOperandsNum(); k++) {
+        Value * val = inst->getOperand(k);
+        if (val != inst) {
+            collectUses(val, uses);
+        }
+    }
+}
+
+///
+/// @brief 收集使用的值，GEP递归展开。保存地址的GEP没有分配到寄存器时在使用处重新计算，其操作数同样要活跃
+/// @param val 被使用的值
+/// @param uses 使用的值的编号
+///
+void LivenessArm64::collectUses(Value * val, std::vector<int32_t> & uses)
+{
+    Instruction * gep = dynamic_cast<Instruction *>(val);
+    if (gep && gep->getOp() == IRInstOperator::IRINST_OP_GEP) {
+        if (keptGeps.count(gep)) {
+            uses.push_back(getIndex(gep));
+        }
+        for (int32_t k = 0; k < gep->getOperandsNum(); k++) {
+            collectUses(gep->getOperand(k), uses);
+        }
+        return;
+    }
+
+    int32_t index = getIndex(val);
+    if (index != -1) {
+        uses.push_back(index);
+    }
+}
+
+///
+/// @brief 迭代求解入口、出口活跃集合
+///
+void LivenessArm64::solve()
+{
+    auto & blocks = func->getBlocks();
+    size_t words = (values.size() + 63) / 64;
+
+    // 基本块内先使用后定义的值(gen)，以及基本块内定义的值(kill)
+    std::vector<std::vector<uint64_t>> gen(blocks.size(), std::vector<uint64_t>(words, 0));
+    std::vector<std::vector<uint64_t>> kill(blocks.size(), std::vector<uint64_t>(words, 0));
+    std::vector<int32_t> defs, uses;
+    for (auto block: blocks) {
+        auto & g = gen[block->getIndex()];
+        auto & d = kill[block->getIndex()];
+        for (auto inst: block->getInsts()) {
+            if (inst->isDead()) {
+                continue;
+            }
+            getUses(inst, uses);
+            for (int32_t u: uses) {
+                if (!(d[u / 64] & (1ULL << (u % 64)))) {
+                    g[u / 64] |= 1ULL << (u % 64);
+                }
+            }
+            getDefs(inst, defs);
+            for (int32_t v: defs) {
+                d[v / 64] |= 1ULL << (v % 64);
+            }
+        }
+    }
+
+    liveIn.assign(blocks.size(), std::vector<uint64_t>(words, 0));
+    liveOut.assign(blocks.size(), std::vector<uint64_t>(words, 0));
+
+    // 逆序遍历基本块收敛较快，迭代到不动点
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+            int32_t b = (*it)->getIndex();
+            auto & out = liveOut[b];
+            for (auto succ: (*it)->getSuccs()) {
+                auto & in = liveIn[succ->getIndex()];
+                for (size_t w = 0; w < words; w++) {
+                    out[w] |= in[w];
+                }
+            }
+            auto & in = liveIn[b];
+            for (size_t w = 0; w < words; w++) {
+                uint64_t newIn = gen[b][w] | (out[w] & ~kill[b][w]);
+                if (newIn != in[w]) {
+                    in[w] = newIn;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+///
+/// @brief 位向量转换为编号列表
+/// @param bits 位向量
+/// @param live 编号列表
+///
+void LivenessArm64::toList(const std::vector<uint64_t> & bits, std::vector<int32_t> & live)
+{
+    live.clear();
+    for (size_t w = 0; w < bits.size(); w++) {
+        uint64_t word = bits[w];
+        while (word) {
+            live.push_back((int32_t) (w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+}
+
+///
+/// @brief 获取基本块入口处活跃的值的编号
+/// @param block 基本块
+/// @param live 活跃的值的编号，从小到大
+///
+void LivenessArm64::getLiveIn(BasicBlock * block, std::vector<int32_t> & live)
+{
+    toList(liveIn[block->getIndex()], live);
+}
+
+///
+/// @brief 获取基本块出口处活跃的值的编号
+/// @param block 基本块
+/// @param live 活跃的值的编号，从小到大
+///
+void LivenessArm64::getLiveOut(BasicBlock * block, std::vector<int32_t> & live)
+{
+    toList(liveOut[block->getIndex()], live);
+}
+
+///
+/// @brief 值在基本块入口处是否活跃
+/// @param block 基本块
+/// @param index 值的编号
+/// @return true 活跃
+/// @return false 不活跃
+///
+bool LivenessArm64::isLiveIn(BasicBlock * block, int32_t index)
+{
+    return liveIn[block->getIndex()][index / 64] & (1ULL << (index % 64));
+}
+
+///
+/// @brief 值在基本块出口处是否活跃
+/// @param block 基本块
+/// @param index 值的编号
+/// @return true 活跃
+/// @return false 不活跃
+///
+bool LivenessArm64::isLiveOut(BasicBlock * block, int32_t index)
+{
+    return liveOut[block->getIndex()][index / 64] & (1ULL << (index % 64));
+}
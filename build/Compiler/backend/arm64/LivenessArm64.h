@@ -0,0 +1,196 @@
+///
+/// @file LivenessArm64.h
+/// @brief 寄存器分配用的活跃变量分析
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Function;
+class BasicBlock;
+class Instruction;
+class Value;
+
+///
+/// @brief 寄存器分配用的活跃变量分析
+///
+/// 分析对象是可分配寄存器的值：有结果的指令(GEP除外，其地址在使用处计算)、非数组的局部变量以及形参。
+/// 作为多处GEP的公共前缀或者外提到循环外的GEP例外，其地址保存在寄存器中。
+/// Move指令定义其第一个操作数，Entry指令定义全部形参。GEP在使用处重新计算地址，
+/// 因此使用GEP相当于使用其基址与下标。以位向量在控制流图上迭代求基本块的入口、出口活跃集合。
+///
+class LivenessArm64 {
+
+public:
+    ///
+    /// @brief 构造函数，进行活跃变量分析
+    /// @param _func 函数，要求已经划分了基本块
+    ///
+    explicit LivenessArm64(Function * _func);
+
+    ///
+    /// @brief 获取分析对象的个数
+    /// @return int32_t 个数
+    ///
+    int32_t getValueCount();
+
+    ///
+    /// @brief 获取编号对应的值
+    /// @param index 编号
+    /// @return Value* 值
+    ///
+    Value * getValue(int32_t index);
+
+    ///
+    /// @brief 获取值的编号
+    /// @param val 值
+    /// @return int32_t 编号，不是分析对象时为-1
+    ///
+    int32_t getIndex(Value * val);
+
+    ///
+    /// @brief 值是否参与寄存器分配。没有函数调用时寄存器传递的形参直接使用x0-x7或s0-s7，栈传递的形参在栈内
+    /// @param index 值的编号
+    /// @return true 参与
+    /// @return false 不参与
+    ///
+    bool isAllocatable(int32_t index);
+
+    ///
+    /// @brief 获取指令定义的值的编号
+    /// @param inst 指令
+    /// @param defs 定义的值的编号
+    ///
+    void getDefs(Instruction * inst, std::vector<int32_t> & defs);
+
+    ///
+    /// @brief 获取指令使用的值的编号，GEP展开为其操作数
+    /// @param inst 指令
+    /// @param uses 使用的值的编号，可能重复
+    ///
+    void getUses(Instruction * inst, std::vector<int32_t> & uses);
+
+    ///
+    /// @brief 获取基本块入口处活跃的值的编号
+    /// @param block 基本块
+    /// @param live 活跃的值的编号，从小到大
+    ///
+    void getLiveIn(BasicBlock * block, std::vector<int32_t> & live);
+
+    ///
+    /// @brief 获取基本块出口处活跃的值的编号
+    /// @param block 基本块
+    /// @param live 活跃的值的编号，从小到大
+    ///
+    void getLiveOut(BasicBlock * block, std::vector<int32_t> & live);
+
+    ///
+    /// @brief 值在基本块入口处是否活跃
+    /// @param block 基本块
+    /// @param index 值的编号
+    /// @return true 活跃
+    /// @return false 不活跃
+    ///
+    bool isLiveIn(BasicBlock * block, int32_t index);
+
+    ///
+    /// @brief 值在基本块出口处是否活跃
+    /// @param block 基本块
+    /// @param index 值的编号
+    /// @return true 活跃
+    /// @return false 不活跃
+    ///
+    bool isLiveOut(BasicBlock * block, int32_t index);
+
+private:
+    ///
+    /// @brief 值是否是分析对象
+    /// @param val 值
+    /// @return true 是
+    /// @return false 不是
+    ///
+    bool isCandidate(Value * val);
+
+    ///
+    /// @brief 找出地址保存在寄存器中的GEP
+    ///
+    void findKeptGeps();
+
+    ///
+    /// @brief GEP链中是否有变量下标
+    /// @param gep GEP指令
+    /// @return true 有变量下标
+    /// @return false 没有
+    ///
+    static bool hasVarIndex(Instruction * gep);
+
+    ///
+    /// @brief 值编号，新的值分配下一个编号
+    /// @param val 值
+    ///
+    void number(Value * val);
+
+    ///
+    /// @brief 收集使用的值，GEP递归展开，保存地址的GEP本身也算使用
+    /// @param val 被使用的值
+    /// @param uses 使用的值的编号
+    ///
+    void collectUses(Value * val, std::vector<int32_t> & uses);
+
+    ///
+    /// @brief 迭代求解入口、出口活跃集合
+    ///
+    void solve();
+
+    ///
+    /// @brief 位向量转换为编号列表
+    /// @param bits 位向量
+    /// @param live 编号列表
+    ///
+    static void toList(const std::vector<uint64_t> & bits, std::vector<int32_t> & live);
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func;
+
+    ///
+    /// @brief 分析对象，按编号索引
+    ///
+    std::vector<Value *> values;
+
+    ///
+    /// @brief 值到编号的映射
+    ///
+    std::unordered_map<Value *, int32_t> indexMap;
+
+    ///
+    /// @brief 地址保存在寄存器中的GEP
+    ///
+    std::unordered_set<Instruction *> keptGeps;
+
+    ///
+    /// @brief 基本块入口活跃集合，按基本块编号索引
+    ///
+    std::vector<std::vector<uint64_t>> liveIn;
+
+    ///
+    /// @brief 基本块出口活跃集合，按基本块编号索引
+    ///
+    std::vector<std::vector<uint64_t>> liveOut;
+};
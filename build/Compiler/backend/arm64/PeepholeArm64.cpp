@@ -0,0 +1,1114 @@
+///
+/// @file PeepholeArm64.cpp
+/// @brief ARM64汇编指令序列上的窥孔优化
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <unordered_set>
+
+#include "PeepholeArm64.h"
+
+/// @brief 条件码及其相反的条件码，两两一组
+static const char * condPairs[] = {"eq", "ne", "cs", "cc", "hs", "lo", "mi", "pl", "vs", "vc", "hi", "ls", "ge", "lt", "gt", "le"};
+
+///
+/// @brief 获取相反的条件码
+/// @param cond 条件码
+/// @return std::string 相反的条件码，不是条件码时为空串
+///
+static std::string invertCond(const std::string & cond)
+{
+    for (size_t k = 0; k < sizeof(condPairs) / sizeof(condPairs[0]); k++) {
+        if (cond == condPairs[k]) {
+            return condPairs[k ^ 1];
+        }
+    }
+
+    return "";
+}
+
+///
+/// @brief 获取条件跳转指令的条件码，如bne、b.ne
+/// @param arm 汇编指令
+/// @return std::string 条件码，不是条件跳转指令时为空串
+///
+static std::string branchCond(ArmInst * arm)
+{
+    const std::string & op = arm->opcode;
+    if (op.size() < 3 || op[0] != 'b' || arm->result == ":") {
+        return "";
+    }
+
+    std::string cond = op.substr(op[1] == '.' ? 2 : 1);
+    return invertCond(cond).empty() ? "" : cond;
+}
+
+///
+/// @brief 寄存器名字对应的编号，w与x、s与d等同一寄存器的不同宽度编号相同
+/// @param name 寄存器名字
+/// @return int32_t 寄存器编号，零寄存器或者不是寄存器时为-1
+///
+static int32_t regNo(const std::string & name)
+{
+    if (name == "sp" || name == "wsp") {
+        return ARM64_SP_REG_NO;
+    }
+
+    if (name.size() < 2 || name.size() > 3) {
+        return -1;
+    }
+    for (size_t k = 1; k < name.size(); k++) {
+        if (!isdigit((unsigned char) name[k])) {
+            return -1;
+        }
+    }
+
+    int32_t n = atoi(name.c_str() + 1);
+    switch (name[0]) {
+        case 'w':
+        case 'x':
+            return n <= 30 ? n : -1;
+        case 's':
+        case 'd':
+        case 'q':
+        case 'v':
+            return n < PlatformArm64::maxFloatRegNum ? ARM64_FREG(n) : -1;
+        default:
+            return -1;
+    }
+}
+
+///
+/// @brief 寄存器的宽度
+/// @param name 寄存器名字，含零寄存器
+/// @return int32_t 字节数，不是通用或浮点寄存器时为0
+///
+static int32_t regSize(const std::string & name)
+{
+    if (name == "wzr") {
+        return 4;
+    }
+    if (name == "xzr") {
+        return 8;
+    }
+    if (regNo(name) == -1 || name == "sp") {
+        return 0;
+    }
+
+    return (name[0] == 'w' || name[0] == 's') ? 4 : (name[0] == 'x' || name[0] == 'd') ? 8 : 0;
+}
+
+///
+/// @brief 是否是零寄存器
+/// @param name 寄存器名字
+/// @return true 是
+/// @return false 不是
+///
+static bool isZeroReg(const std::string & name)
+{
+    return name == "wzr" || name == "xzr";
+}
+
+///
+/// @brief 收集操作数中的寄存器，:lo12:之后的符号不是寄存器
+/// @param opnd 操作数，可能是[x29,#-16]、[x17,w13,sxtw #2]等内存操作数
+/// @param regs 寄存器集合
+///
+static void operandRegs(const std::string & opnd, PeepholeArm64::RegSet & regs)
+{
+    std::string token;
+    size_t k = 0;
+    while (k <= opnd.size()) {
+        char ch = k < opnd.size() ? opnd[k] : ',';
+        if (isalnum((unsigned char) ch) || ch == '_') {
+            token += ch;
+            k++;
+            continue;
+        }
+
+        int32_t reg = regNo(token);
+        if (reg != -1) {
+            regs.set(reg);
+        }
+        token.clear();
+
+        if (ch == ':' && opnd.compare(k, 6, ":lo12:") == 0) {
+            // 跳过重定位的符号
+            while (k < opnd.size() && opnd[k] != ']' && opnd[k] != ',') {
+                k++;
+            }
+        } else if (ch == '.') {
+            // Label名
+            while (k < opnd.size() && (isalnum((unsigned char) opnd[k]) || opnd[k] == '.' || opnd[k] == '_')) {
+                k++;
+            }
+        } else {
+            k++;
+        }
+    }
+}
+
+///
+/// @brief 内存操作数是否修改基址寄存器，如[sp,#-16]!、[sp],#16
+/// @param addr 内存操作数
+/// @return true 修改
+/// @return false 不修改
+///
+static bool hasWriteback(const std::string & addr)
+{
+    return addr.find("]!") != std::string::npos || addr.find("],") != std::string::npos;
+}
+
+///
+/// @brief 获取访存指令的内存操作数
+/// @param arm 访存指令
+/// @return const std::string& 内存操作数
+///
+static const std::string & memOperand(ArmInst * arm)
+{
+    return (arm->opcode == "ldp" || arm->opcode == "stp") ? arm->arg2 : arm->arg1;
+}
+
+///
+/// @brief 是否是访存指令
+/// @param arm 汇编指令
+/// @param store true判断写内存，false判断读内存
+/// @return true 是
+/// @return false 不是
+///
+static bool isMemAccess(ArmInst * arm, bool store)
+{
+    return arm->opcode.compare(0, 2, store ? "st" : "ld") == 0;
+}
+
+///
+/// @brief 是否是Label指令
+/// @param arm 汇编指令
+/// @return true 是
+/// @return false 不是
+///
+static bool isLabel(ArmInst * arm)
+{
+    return arm->result == ":";
+}
+
+///
+/// @brief 解析不修改基址寄存器、没有变址寄存器的内存操作数，如[x29,#-16]、[sp]
+/// @param addr 内存操作数
+/// @param base 基址寄存器名字
+/// @param offset 偏移
+/// @return true 是这种内存操作数
+/// @return false 不是
+///
+static bool simpleAddr(const std::string & addr, std::string & base, int64_t & offset)
+{
+    if (addr.size() < 3 || addr.front() != '[' || addr.back() != ']') {
+        return false;
+    }
+
+    std::string inner = addr.substr(1, addr.size() - 2);
+    size_t comma = inner.find(',');
+    base = inner.substr(0, comma);
+    if (base != "sp" && (base[0] != 'x' || regNo(base) == -1)) {
+        return false;
+    }
+    if (comma == std::string::npos) {
+        offset = 0;
+        return true;
+    }
+    if (inner.compare(comma + 1, 1, "#") != 0) {
+        return false;
+    }
+
+    char * end = nullptr;
+    offset = strtoll(inner.c_str() + comma + 2, &end, 10);
+    return end && *end == '\0' && end != inner.c_str() + comma + 2;
+}
+
+///
+/// @brief 访存指令访问的内存是否可能与给定的范围重叠，基址不同时认为可能重叠
+/// @param arm 访存指令
+/// @param base 基址寄存器名字
+/// @param offset 偏移
+/// @param size 字节数
+/// @return true 可能重叠
+/// @return false 不重叠
+///
+static bool mayOverlap(ArmInst * arm, const std::string & base, int64_t offset, int32_t size)
+{
+    std::string armBase;
+    int64_t armOffset;
+    if (!simpleAddr(memOperand(arm), armBase, armOffset) || armBase != base) {
+        return true;
+    }
+
+    // ldrb等按寄存器宽度估计，只会偏大
+    int32_t len = regSize(arm->result) * ((arm->opcode == "ldp" || arm->opcode == "stp") ? 2 : 1);
+    if (len == 0) {
+        return true;
+    }
+
+    return armOffset < offset + size && offset < armOffset + len;
+}
+
+///
+/// @brief 构造函数
+/// @param _code 一个函数的汇编指令序列
+///
+PeepholeArm64::PeepholeArm64(ArmInsts & _code) : code(_code)
+{}
+
+///
+/// @brief 获取跳转指令的目标Label
+/// @param arm 汇编指令
+/// @return std::string 目标Label名称，不是跳转指令时为空串
+///
+std::string PeepholeArm64::branchTarget(ArmInst * arm)
+{
+    if (arm->opcode == "cbz" || arm->opcode == "cbnz") {
+        return arm->arg1;
+    }
+    if (arm->opcode == "b" || !branchCond(arm).empty()) {
+        return arm->result;
+    }
+
+    return "";
+}
+
+///
+/// @brief 进行窥孔优化，删除的指令设置为无效
+///
+void PeepholeArm64::run()
+{
+    // 每个变换之前重新分析，保证变换所依据的活跃信息是准确的
+    bool (PeepholeArm64::*passes[])() = {&PeepholeArm64::removeSelfMoves,
+                                         &PeepholeArm64::forwardLoads,
+                                         &PeepholeArm64::foldImmediates,
+                                         &PeepholeArm64::formCompareBranches,
+                                         &PeepholeArm64::foldCsetBranches,
+                                         &PeepholeArm64::foldConstBranches,
+                                         &PeepholeArm64::simplifyJumps,
+                                         &PeepholeArm64::removeDeadCode};
+
+    bool changed = true;
+    for (int32_t round = 0; changed && round < 16; round++) {
+        changed = false;
+        for (auto pass: passes) {
+            collect();
+            computeLiveness();
+            if ((this->*pass)()) {
+                changed = true;
+            }
+        }
+    }
+
+    // 每合并一对之后重新分析，改名用到的空闲寄存器依据准确的活跃信息
+    do {
+        collect();
+        computeLiveness();
+    } while (formPairs());
+}
+
+///
+/// @brief 收集有效的指令，建立Label的位置，没有跳转指令以之为目标的基本块Label删除，
+/// 以便前后的指令能够合并，如bne .L1; b .L2; .L3: .L1:
+///
+void PeepholeArm64::collect()
+{
+    insts.clear();
+    labels.clear();
+
+    std::unordered_set<std::string> targets;
+    for (auto arm: code) {
+        if (!arm->dead) {
+            std::string target = branchTarget(arm);
+            if (!target.empty()) {
+                targets.insert(target);
+            }
+        }
+    }
+
+    for (auto arm: code) {
+        // 无效指令、空指令以及注释不参与
+        if (arm->dead || arm->opcode.empty() || arm->opcode == "@") {
+            continue;
+        }
+        if (isLabel(arm)) {
+            if (arm->opcode[0] == '.' && !targets.count(arm->opcode)) {
+                arm->setDead();
+                continue;
+            }
+            labels[arm->opcode] = insts.size();
+        }
+        insts.push_back(arm);
+    }
+}
+
+///
+/// @brief 获取指令定义与使用的寄存器
+/// @param arm 汇编指令
+/// @param defs 定义的寄存器
+/// @param uses 使用的寄存器
+///
+void PeepholeArm64::getDefsUses(ArmInst * arm, RegSet & defs, RegSet & uses)
+{
+    defs.reset();
+    uses.reset();
+
+    const std::string & op = arm->opcode;
+
+    if (isLabel(arm) || op == "b") {
+        return;
+    }
+
+    if (op == "ret") {
+        // 返回值、被调用者保存的寄存器以及sp在返回后使用
+        uses.set(0);
+        uses.set(ARM64_FREG(0));
+        uses.set(ARM64_SP_REG_NO);
+        for (int32_t k = 19; k <= ARM64_LR_REG_NO; k++) {
+            uses.set(k);
+        }
+        for (int32_t k = 8; k < 16; k++) {
+            uses.set(ARM64_FREG(k));
+        }
+        return;
+    }
+
+    if (op == "bl") {
+        // 使用传参寄存器，改写调用者保存的寄存器以及条件标志
+        for (int32_t k = 0; k < 8; k++) {
+            uses.set(k);
+            uses.set(ARM64_FREG(k));
+        }
+        uses.set(ARM64_SP_REG_NO);
+        for (int32_t k = 0; k <= 18; k++) {
+            defs.set(k);
+        }
+        defs.set(ARM64_LR_REG_NO);
+        for (int32_t k = 0; k < PlatformArm64::maxFloatRegNum; k++) {
+            if (k < 8 || k >= 16) {
+                defs.set(ARM64_FREG(k));
+            }
+        }
+        defs.set(flagsBit);
+        return;
+    }
+
+    if (!branchCond(arm).empty()) {
+        uses.set(flagsBit);
+        return;
+    }
+
+    if (op == "cbz" || op == "cbnz") {
+        operandRegs(arm->result, uses);
+        return;
+    }
+
+    if (isMemAccess(arm, true) || isMemAccess(arm, false)) {
+        bool pair = op == "ldp" || op == "stp";
+        const std::string & addr = memOperand(arm);
+        operandRegs(addr, uses);
+        RegSet & values = isMemAccess(arm, true) ? uses : defs;
+        operandRegs(arm->result, values);
+        if (pair) {
+            operandRegs(arm->arg1, values);
+        }
+        if (hasWriteback(addr)) {
+            // 基址寄存器被改写
+            RegSet base;
+            operandRegs(addr.substr(0, addr.find(']')), base);
+            defs |= base;
+        }
+        return;
+    }
+
+    if (op == "cmp" || op == "cmn" || op == "tst" || op == "fcmp" || op == "fcmpe") {
+        operandRegs(arm->result, uses);
+        operandRegs(arm->arg1, uses);
+        operandRegs(arm->arg2, uses);
+        defs.set(flagsBit);
+        return;
+    }
+
+    if (op == "adrp") {
+        operandRegs(arm->result, defs);
+        return;
+    }
+
+    // 其余指令第一个操作数是结果，movk保留其余的位
+    operandRegs(arm->result, defs);
+    if (op == "movk") {
+        operandRegs(arm->result, uses);
+    }
+    operandRegs(arm->arg1, uses);
+    operandRegs(arm->arg2, uses);
+    operandRegs(arm->addition, uses);
+
+    if (op == "adds" || op == "subs" || op == "ands" || op == "negs") {
+        defs.set(flagsBit);
+    }
+    if (op == "cset" || op == "csetm" || op == "csel" || op == "csinc" || op == "csinv" || op == "csneg" ||
+        op == "cinc" || op == "cneg" || op == "fcsel" || op == "adc" || op == "sbc") {
+        uses.set(flagsBit);
+    }
+}
+
+///
+/// @brief 活跃变量分析，求出每条指令出口处活跃的寄存器
+///
+void PeepholeArm64::computeLiveness()
+{
+    size_t n = insts.size();
+    std::vector<RegSet> defs(n), uses(n), liveIn(n);
+    liveOut.assign(n, RegSet());
+
+    // 后继：顺序执行的下一条指令以及跳转目标，目标未知或者执行到序列末尾时全部活跃
+    std::vector<std::vector<size_t>> succs(n);
+    std::vector<bool> exitAll(n, false);
+    for (size_t i = 0; i < n; i++) {
+        ArmInst * arm = insts[i];
+        getDefsUses(arm, defs[i], uses[i]);
+        if (arm->opcode == "ret") {
+            continue;
+        }
+
+        std::string target = branchTarget(arm);
+        if (!target.empty()) {
+            auto it = labels.find(target);
+            if (it != labels.end()) {
+                succs[i].push_back(it->second);
+            } else {
+                exitAll[i] = true;
+            }
+        }
+        if (arm->opcode != "b") {
+            if (i + 1 < n) {
+                succs[i].push_back(i + 1);
+            } else {
+                exitAll[i] = true;
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = n; i-- > 0;) {
+            RegSet out;
+            if (exitAll[i]) {
+                out.set();
+            }
+            for (size_t s: succs[i]) {
+                out |= liveIn[s];
+            }
+            RegSet in = uses[i] | (out & ~defs[i]);
+            if (in != liveIn[i] || out != liveOut[i]) {
+                liveIn[i] = in;
+                liveOut[i] = out;
+                changed = true;
+            }
+        }
+    }
+}
+
+///
+/// @brief 在基本块内向前查找寄存器的定义
+/// @param pos 指令位置
+/// @param reg 寄存器编号
+/// @return ArmInst* 定义寄存器的指令，到达基本块开头时为空
+///
+ArmInst * PeepholeArm64::reachingDef(size_t pos, int32_t reg)
+{
+    RegSet defs, uses;
+    for (size_t i = pos; i-- > 0;) {
+        if (isLabel(insts[i])) {
+            return nullptr;
+        }
+        getDefsUses(insts[i], defs, uses);
+        if (defs.test(reg)) {
+            return insts[i];
+        }
+    }
+
+    return nullptr;
+}
+
+///
+/// @brief 获取由mov定义的常量
+/// @param def 定义寄存器的指令
+/// @param name 寄存器名字，要求与定义的名字一致
+/// @param val 常量值
+/// @return true 是常量
+/// @return false 不是常量
+///
+bool PeepholeArm64::constValue(ArmInst * def, const std::string & name, int64_t & val)
+{
+    if (!def || def->opcode != "mov" || def->result != name || !def->arg2.empty()) {
+        return false;
+    }
+
+    if (isZeroReg(def->arg1)) {
+        val = 0;
+        return true;
+    }
+    if (def->arg1.size() > 1 && def->arg1[0] == '#') {
+        val = strtoll(def->arg1.c_str() + 1, nullptr, 10);
+        return true;
+    }
+
+    return false;
+}
+
+///
+/// @brief 删除mov x,x
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::removeSelfMoves()
+{
+    bool changed = false;
+
+    for (auto arm: insts) {
+        if ((arm->opcode == "mov" || arm->opcode == "fmov") && arm->arg2.empty() && arm->result == arm->arg1) {
+            arm->setDead();
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief 存入或读出某地址后再读同一地址的ldr改为mov
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::forwardLoads()
+{
+    bool changed = false;
+    RegSet defs, uses;
+
+    for (size_t i = 0; i < insts.size(); i++) {
+        ArmInst * arm = insts[i];
+        if (arm->opcode != "str" && arm->opcode != "ldr") {
+            continue;
+        }
+        const std::string & addr = arm->arg1;
+        const std::string & value = arm->result;
+        if (hasWriteback(addr) || regSize(value) == 0) {
+            continue;
+        }
+
+        RegSet addrRegs;
+        operandRegs(addr, addrRegs);
+        int32_t valueReg = regNo(value);
+        if (valueReg != -1 && addrRegs.test(valueReg)) {
+            // 读出的值改写了基址寄存器
+            continue;
+        }
+
+        // 到基本块结束、写内存或者函数调用为止，其间地址与值所在的寄存器不能被改写
+        for (size_t j = i + 1; j < insts.size(); j++) {
+            ArmInst * next = insts[j];
+            if (isLabel(next) || next->opcode == "b" || next->opcode == "ret" || next->opcode == "bl" ||
+                isMemAccess(next, true)) {
+                break;
+            }
+
+            if (next->opcode == "ldr" && next->arg1 == addr && regSize(next->result) == regSize(value)) {
+                if (next->result == value) {
+                    next->setDead();
+                } else {
+                    bool isFloat = ARM64_IS_FREG(regNo(next->result)) || (valueReg != -1 && ARM64_IS_FREG(valueReg));
+                    next->replace(isFloat ? "fmov" : "mov", next->result, value);
+                }
+                changed = true;
+            }
+
+            getDefsUses(next, defs, uses);
+            if ((valueReg != -1 && defs.test(valueReg)) || (defs & addrRegs).any()) {
+                break;
+            }
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief mov得到的常量折叠为立即数操作数，与零寄存器的运算改为mov
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::foldImmediates()
+{
+    bool changed = false;
+
+    for (size_t i = 0; i < insts.size(); i++) {
+        ArmInst * arm = insts[i];
+        const std::string & op = arm->opcode;
+        int64_t val;
+
+        // mov w1,#5; mov w0,w1 => mov w0,#5
+        if (op == "mov" && arm->arg2.empty() && regNo(arm->arg1) != -1 && arm->arg1[0] == arm->result[0] &&
+            arm->arg1[0] == 'w' && constValue(reachingDef(i, regNo(arm->arg1)), arm->arg1, val)) {
+            arm->arg1 = val ? "#" + std::to_string(val) : "wzr";
+            changed = true;
+            continue;
+        }
+
+        // add w0,wzr,w1 => mov w0,w1
+        if ((op == "add" || op == "sub" || op == "orr" || op == "eor") && arm->addition.empty() &&
+            regSize(arm->result) && (isZeroReg(arm->arg2) || (op != "sub" && isZeroReg(arm->arg1)))) {
+            std::string src = isZeroReg(arm->arg2) ? arm->arg1 : arm->arg2;
+            if (regSize(src) == regSize(arm->result)) {
+                arm->replace("mov", arm->result, src);
+                changed = true;
+                continue;
+            }
+        }
+
+        bool arith = op == "add" || op == "sub" || op == "adds" || op == "subs";
+        bool logic = op == "and" || op == "orr" || op == "eor";
+        if ((!arith && !logic) || !arm->addition.empty() || arm->arg1 == arm->arg2) {
+            continue;
+        }
+
+        // 立即数形式中第一个源操作数编号31表示sp，不能是零寄存器；不设置标志时结果也不能是零寄存器
+        if (isZeroReg(arm->arg1) || (op.size() == 3 && isZeroReg(arm->result))) {
+            continue;
+        }
+
+        // 加法以及逻辑运算可交换，常量在第一个源操作数时交换过来
+        bool swap = false;
+        int32_t reg = regNo(arm->arg2);
+        bool isConst = reg != -1 && !ARM64_IS_FREG(reg) && constValue(reachingDef(i, reg), arm->arg2, val);
+        if (!isConst && op != "sub" && op != "subs" && !isZeroReg(arm->arg2)) {
+            reg = regNo(arm->arg1);
+            isConst = reg != -1 && !ARM64_IS_FREG(reg) && constValue(reachingDef(i, reg), arm->arg1, val);
+            swap = true;
+        }
+        const std::string & constReg = swap ? arm->arg1 : arm->arg2;
+        if (!isConst || constReg[0] != 'w') {
+            continue;
+        }
+
+        std::string opcode = op;
+        if (logic) {
+            // 逻辑运算的立即数为连续的1(可循环移位)，这里只处理32位的情况
+            uint32_t bits = (uint32_t) val;
+            uint32_t run = (bits & 1) ? ~bits : bits;
+            if (run != 0) {
+                run >>= __builtin_ctz(run);
+            }
+            if (bits == 0 || bits == 0xFFFFFFFFu || (run & (run + 1)) != 0) {
+                continue;
+            }
+        } else if (val < 0 && val >= -4095) {
+            // 负数时加减互换
+            opcode = (op[0] == 'a' ? "sub" : "add") + op.substr(3);
+            val = -val;
+        } else if (val < 0 || val > 4095) {
+            // 立即数为12位无符号数
+            continue;
+        }
+
+        std::string src = swap ? arm->arg2 : arm->arg1;
+        if (regNo(src) == -1) {
+            continue;
+        }
+        arm->replace(opcode, arm->result, src, "#" + std::to_string(logic ? (uint32_t) val : val));
+        changed = true;
+    }
+
+    return changed;
+}
+
+///
+/// @brief 与0比较的指令，subs wzr,x,wzr、subs wzr,x,#0、cmp x,#0以及adds x,x,wzr
+/// @param arm 汇编指令
+/// @return std::string 比较的寄存器名字，不是与0比较时为空串
+///
+static std::string zeroTest(ArmInst * arm)
+{
+    if (!arm->addition.empty()) {
+        return "";
+    }
+
+    if (arm->opcode == "cmp") {
+        return (isZeroReg(arm->arg1) || arm->arg1 == "#0") ? arm->result : "";
+    }
+
+    if ((arm->opcode == "subs" || arm->opcode == "adds") && (isZeroReg(arm->arg2) || arm->arg2 == "#0") &&
+        (isZeroReg(arm->result) || arm->result == arm->arg1)) {
+        return arm->arg1;
+    }
+
+    return "";
+}
+
+///
+/// @brief 与0比较后的beq/bne改为cbz/cbnz，其它条件下与前面的add/sub合并
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::formCompareBranches()
+{
+    bool changed = false;
+
+    for (size_t i = 0; i + 1 < insts.size(); i++) {
+        ArmInst * arm = insts[i];
+        std::string reg = zeroTest(arm);
+        std::string cond = branchCond(insts[i + 1]);
+        if (reg.empty() || isZeroReg(reg) || regSize(reg) == 0 || cond.empty() || liveOut[i + 1].test(flagsBit)) {
+            continue;
+        }
+
+        ArmInst * branch = insts[i + 1];
+        if (cond == "eq" || cond == "ne") {
+            // subs wzr,w0,wzr; bne .L1 => cbnz w0,.L1
+            std::string label = branch->result;
+            arm->setDead();
+            branch->replace(cond == "eq" ? "cbz" : "cbnz", reg, label);
+            changed = true;
+            continue;
+        }
+
+        // add w0,w0,w1; subs wzr,w0,wzr; blt .L1 => adds w0,w0,w1; blt .L1
+        ArmInst * prev = i > 0 ? insts[i - 1] : nullptr;
+        if (prev && (prev->opcode == "add" || prev->opcode == "sub") && prev->result == reg &&
+            prev->addition.empty() && !isZeroReg(prev->arg1) && prev->arg1 != "sp") {
+            prev->opcode += "s";
+            arm->setDead();
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief cset的结果与0比较后跳转改为按条件跳转，cset的结果与1异或改为取反的条件
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::foldCsetBranches()
+{
+    bool changed = false;
+
+    for (size_t i = 0; i + 1 < insts.size(); i++) {
+        ArmInst * cset = insts[i];
+        ArmInst * next = insts[i + 1];
+        if (cset->opcode != "cset") {
+            continue;
+        }
+        int32_t reg = regNo(cset->result);
+        if (reg == -1) {
+            continue;
+        }
+
+        // cset w0,lt; cbnz w0,.L1 => blt .L1
+        if ((next->opcode == "cbz" || next->opcode == "cbnz") && next->result == cset->result &&
+            !liveOut[i + 1].test(reg)) {
+            std::string cond = next->opcode == "cbnz" ? cset->arg1 : invertCond(cset->arg1);
+            next->replace("b" + cond, next->arg1);
+            cset->setDead();
+            changed = true;
+            continue;
+        }
+
+        // cset w0,lt; eor w1,w0,#1 => cset w1,ge
+        if (next->opcode == "eor" && next->arg1 == cset->result && next->arg2 == "#1" && next->addition.empty() &&
+            regSize(next->result) == regSize(cset->result) && !liveOut[i + 1].test(reg)) {
+            next->replace("cset", next->result, invertCond(cset->arg1));
+            cset->setDead();
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief 条件已知的cbz/cbnz改为无条件跳转或者删除
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::foldConstBranches()
+{
+    bool changed = false;
+
+    for (size_t i = 0; i < insts.size(); i++) {
+        ArmInst * arm = insts[i];
+        if (arm->opcode != "cbz" && arm->opcode != "cbnz") {
+            continue;
+        }
+        int32_t reg = regNo(arm->result);
+        int64_t val;
+        if (reg == -1 || !constValue(reachingDef(i, reg), arm->result, val)) {
+            continue;
+        }
+
+        if ((val == 0) == (arm->opcode == "cbz")) {
+            arm->replace("b", arm->arg1);
+        } else {
+            arm->setDead();
+        }
+        changed = true;
+    }
+
+    return changed;
+}
+
+///
+/// @brief 跳转到紧跟的Label、条件跳转越过无条件跳转、跳转后不可达的指令
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::simplifyJumps()
+{
+    bool changed = false;
+
+    for (size_t i = 0; i < insts.size(); i++) {
+        ArmInst * arm = insts[i];
+        if (arm->dead) {
+            continue;
+        }
+
+        if (arm->opcode == "b" || arm->opcode == "ret") {
+            // 到下一个Label之前的指令不可达
+            size_t j = i + 1;
+            for (; j < insts.size() && !isLabel(insts[j]); j++) {
+                insts[j]->setDead();
+                changed = true;
+            }
+
+            // 跳转到紧跟的Label
+            if (arm->opcode == "b") {
+                for (; j < insts.size() && isLabel(insts[j]); j++) {
+                    if (insts[j]->opcode == arm->result) {
+                        arm->setDead();
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+            continue;
+        }
+
+        // bne .L1; b .L2; .L1: => beq .L2; .L1:
+        std::string target = branchTarget(arm);
+        if (target.empty() || i + 2 >= insts.size()) {
+            continue;
+        }
+        ArmInst * jump = insts[i + 1];
+        if (jump->opcode != "b" || !isLabel(insts[i + 2]) || insts[i + 2]->opcode != target) {
+            continue;
+        }
+        if (arm->opcode == "cbz" || arm->opcode == "cbnz") {
+            arm->replace(arm->opcode == "cbz" ? "cbnz" : "cbz", arm->result, jump->result);
+        } else {
+            arm->replace("b" + invertCond(branchCond(arm)), jump->result);
+        }
+        jump->setDead();
+        changed = true;
+    }
+
+    return changed;
+}
+
+///
+/// @brief 删除定义的寄存器以及条件标志都不再活跃的指令
+/// @return true 有变化
+/// @return false 没有变化
+///
+bool PeepholeArm64::removeDeadCode()
+{
+    bool changed = false;
+    RegSet defs, uses, frame;
+    frame.set(ARM64_SP_REG_NO);
+    frame.set(ARM64_FP_REG_NO);
+    frame.set(ARM64_LR_REG_NO);
+
+    for (size_t i = 0; i < insts.size(); i++) {
+        ArmInst * arm = insts[i];
+        const std::string & op = arm->opcode;
+
+        // 有副作用的指令保留
+        if (isLabel(arm) || op == "bl" || op == "ret" || !branchTarget(arm).empty() || isMemAccess(arm, true)) {
+            continue;
+        }
+
+        getDefsUses(arm, defs, uses);
+        if (defs.none() || (defs & frame).any() || (defs & liveOut[i]).any()) {
+            continue;
+        }
+
+        arm->setDead();
+        changed = true;
+    }
+
+    return changed;
+}
+
+///
+/// @brief 合并一对基址相同、偏移相邻的ldr或str为ldp或stp
+/// @return true 合并了一对
+/// @return false 没有可合并的
+///
+bool PeepholeArm64::formPairs()
+{
+    RegSet defs, uses;
+
+    for (size_t i = 0; i < insts.size(); i++) {
+        ArmInst * first = insts[i];
+        const std::string & op = first->opcode;
+        int32_t size = regSize(first->result);
+        std::string base;
+        int64_t offset;
+        if ((op != "ldr" && op != "str") || size == 0 || !simpleAddr(first->arg1, base, offset)) {
+            continue;
+        }
+
+        bool store = op == "str";
+        int32_t baseReg = regNo(base);
+        int32_t value = regNo(first->result);
+        bool isFloat = value != -1 && ARM64_IS_FREG(value);
+        if (!store && value == baseReg) {
+            continue;
+        }
+
+        // ldp放在第一条ldr处，stp放在第二条str处，其间的指令不能依赖被移动的访存
+        RegSet between;
+        std::vector<ArmInst *> accesses;
+        for (size_t j = i + 1; j < insts.size() && j <= i + 8; j++) {
+            ArmInst * next = insts[j];
+            if (isLabel(next) || next->opcode == "bl" || next->opcode == "ret" || !branchTarget(next).empty()) {
+                break;
+            }
+
+            std::string base2;
+            int64_t offset2;
+            int32_t value2 = regNo(next->result);
+            if (next->opcode == op && regSize(next->result) == size && (value2 != -1 && ARM64_IS_FREG(value2)) == isFloat &&
+                simpleAddr(next->arg1, base2, offset2) && base2 == base &&
+                (offset2 - offset == size || offset - offset2 == size)) {
+
+                // ldp/stp的偏移是宽度的倍数，范围为宽度的[-64, 63]倍
+                int64_t low = std::min(offset, offset2);
+                bool ok = low % size == 0 && low >= -64 * size && low <= 63 * size;
+
+                if (ok && !store) {
+                    ok = value2 != value && value2 != baseReg && !between.test(value2);
+                    for (auto access: accesses) {
+                        ok = ok && !(isMemAccess(access, true) && mayOverlap(access, base, offset2, size));
+                    }
+                } else if (ok) {
+                    for (auto access: accesses) {
+                        ok = ok && !mayOverlap(access, base, offset, size);
+                    }
+                    ok = ok && renameForPair(i, j);
+                }
+
+                if (ok) {
+                    std::string lowReg = offset < offset2 ? first->result : next->result;
+                    std::string highReg = offset < offset2 ? next->result : first->result;
+                    std::string addr = low ? "[" + base + ",#" + std::to_string(low) + "]" : "[" + base + "]";
+                    (store ? next : first)->replace(store ? "stp" : "ldp", lowReg, highReg, addr);
+                    (store ? first : next)->setDead();
+                    return true;
+                }
+            }
+
+            getDefsUses(next, defs, uses);
+            if (defs.test(baseReg)) {
+                break;
+            }
+            between |= defs | uses;
+            if (isMemAccess(next, true) || isMemAccess(next, false)) {
+                accesses.push_back(next);
+            }
+        }
+    }
+
+    return false;
+}
+
+///
+/// @brief 第一个str的值寄存器在两个str之间被重新定义时，把新定义改到空闲的临时寄存器
+/// @param first 第一个str的位置
+/// @param second 第二个str的位置
+/// @return true 改名成功，或者不需要改名
+/// @return false 不能改名
+///
+bool PeepholeArm64::renameForPair(size_t first, size_t second)
+{
+    const std::string value = insts[first]->result;
+    int32_t reg = regNo(value);
+    if (reg == -1) {
+        return true;
+    }
+
+    // 其间只能有一条指令重新定义，新值只被第二个str使用，之后不再活跃
+    RegSet defs, uses;
+    size_t defPos = 0;
+    for (size_t k = first + 1; k < second; k++) {
+        getDefsUses(insts[k], defs, uses);
+        if (defPos && uses.test(reg)) {
+            return false;
+        }
+        if (defs.test(reg)) {
+            if (defPos) {
+                return false;
+            }
+            defPos = k;
+        }
+    }
+    if (!defPos) {
+        return true;
+    }
+
+    ArmInst * def = insts[defPos];
+    getDefsUses(def, defs, uses);
+    if (def->result != value || insts[second]->result != value || defs.count() != 1 || uses.test(reg) ||
+        liveOut[second].test(reg)) {
+        return false;
+    }
+
+    // 从两个str之间既不使用也不活跃的调用者保存寄存器中选取
+    RegSet busy;
+    for (size_t k = first; k <= second; k++) {
+        getDefsUses(insts[k], defs, uses);
+        busy |= defs | uses | liveOut[k];
+    }
+
+    // 浮点寄存器s8~s15是被调用者保存的，只从s16开始选取
+    static const std::vector<int32_t> intCandidates = {16, 17, 9, 10, 11, 12, 13, 14, 15};
+    static const std::vector<int32_t> floatCandidates = {16, 17, 18, 19, 20, 21, 22, 23};
+    bool isFloat = ARM64_IS_FREG(reg);
+    for (int32_t n: isFloat ? floatCandidates : intCandidates) {
+        int32_t free = isFloat ? ARM64_FREG(n) : n;
+        if (!busy.test(free)) {
+            std::string name = value.substr(0, 1) + std::to_string(n);
+            def->result = name;
+            insts[second]->result = name;
+            return true;
+        }
+    }
+
+    return false;
+}
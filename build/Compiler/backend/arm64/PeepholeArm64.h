@@ -0,0 +1,202 @@
+///
+/// @file PeepholeArm64.h
+/// @brief ARM64汇编指令序列上的窥孔优化
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <bitset>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ILocArm64.h"
+#include "PlatformArm64.h"
+
+///
+/// @brief ARM64汇编指令序列上的窥孔优化
+///
+/// 指令选择之后、输出之前，在一个函数的ArmInst序列上进行。先解析每条指令定义与使用的寄存器，
+/// 按Label与跳转指令建立控制流，求出每条指令出口处活跃的寄存器以及条件标志NZCV，
+/// 再反复应用以下变换直到不再变化：
+/// (1) 删除mov x,x；
+/// (2) 存入或读出某地址后再读同一地址，改为寄存器之间的mov；
+/// (3) mov得到的常量折叠到add/sub/subs以及逻辑运算的立即数操作数中，与零寄存器的运算改为mov；
+/// (4) 与0比较后的beq/bne改为cbz/cbnz，其它条件下与前面的add/sub合并为adds/subs；
+/// (5) cset的结果与0比较后跳转，改为直接按cset的条件跳转；
+/// (6) 条件已知的cbz/cbnz改为无条件跳转或者删除；
+/// (7) 跳转到紧跟的Label、条件跳转越过无条件跳转、跳转后不可达的指令；
+/// (8) 定义的寄存器以及条件标志都不再活跃的指令。
+/// 最后把同一基本块内基址相同、偏移相邻的ldr或str合并为ldp或stp。
+///
+class PeepholeArm64 {
+
+public:
+    ///
+    /// @brief 寄存器集合，按PlatformArm64的寄存器编号，最后一位表示条件标志NZCV
+    ///
+    typedef std::bitset<ARM64_FREG_BASE + PlatformArm64::maxFloatRegNum + 1> RegSet;
+
+    ///
+    /// @brief 条件标志NZCV在寄存器集合中的位置
+    ///
+    static const int flagsBit = ARM64_FREG_BASE + PlatformArm64::maxFloatRegNum;
+
+    ///
+    /// @brief 构造函数
+    /// @param _code 一个函数的汇编指令序列
+    ///
+    explicit PeepholeArm64(ArmInsts & _code);
+
+    ///
+    /// @brief 进行窥孔优化，删除的指令设置为无效
+    ///
+    void run();
+
+    ///
+    /// @brief 获取跳转指令的目标Label
+    /// @param arm 汇编指令
+    /// @return std::string 目标Label名称，不是跳转指令时为空串
+    ///
+    static std::string branchTarget(ArmInst * arm);
+
+private:
+    ///
+    /// @brief 收集有效的指令，建立Label的位置，删除没有跳转到的基本块Label
+    ///
+    void collect();
+
+    ///
+    /// @brief 活跃变量分析，求出每条指令出口处活跃的寄存器
+    ///
+    void computeLiveness();
+
+    ///
+    /// @brief 删除mov x,x
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool removeSelfMoves();
+
+    ///
+    /// @brief 存入或读出某地址后再读同一地址的ldr改为mov
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool forwardLoads();
+
+    ///
+    /// @brief mov得到的常量折叠为立即数操作数，与零寄存器的运算改为mov
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool foldImmediates();
+
+    ///
+    /// @brief 与0比较后的beq/bne改为cbz/cbnz，其它条件下与前面的add/sub合并
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool formCompareBranches();
+
+    ///
+    /// @brief cset的结果与0比较后跳转改为按条件跳转，cset的结果与1异或改为取反的条件
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool foldCsetBranches();
+
+    ///
+    /// @brief 条件已知的cbz/cbnz改为无条件跳转或者删除
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool foldConstBranches();
+
+    ///
+    /// @brief 跳转到紧跟的Label、条件跳转越过无条件跳转、跳转后不可达的指令
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool simplifyJumps();
+
+    ///
+    /// @brief 删除定义的寄存器以及条件标志都不再活跃的指令
+    /// @return true 有变化
+    /// @return false 没有变化
+    ///
+    bool removeDeadCode();
+
+    ///
+    /// @brief 合并一对基址相同、偏移相邻的ldr或str为ldp或stp
+    /// @return true 合并了一对
+    /// @return false 没有可合并的
+    ///
+    bool formPairs();
+
+    ///
+    /// @brief 第一个str的值寄存器在两个str之间被重新定义时，把新定义改到空闲的临时寄存器
+    /// @param first 第一个str的位置
+    /// @param second 第二个str的位置
+    /// @return true 改名成功，或者不需要改名
+    /// @return false 不能改名
+    ///
+    bool renameForPair(size_t first, size_t second);
+
+    ///
+    /// @brief 在基本块内向前查找寄存器的定义
+    /// @param pos 指令位置
+    /// @param reg 寄存器编号
+    /// @return ArmInst* 定义寄存器的指令，到达基本块开头时为空
+    ///
+    ArmInst * reachingDef(size_t pos, int32_t reg);
+
+    ///
+    /// @brief 获取由mov定义的常量
+    /// @param def 定义寄存器的指令
+    /// @param name 寄存器名字，要求与定义的名字一致
+    /// @param val 常量值
+    /// @return true 是常量
+    /// @return false 不是常量
+    ///
+    static bool constValue(ArmInst * def, const std::string & name, int64_t & val);
+
+    ///
+    /// @brief 获取指令定义与使用的寄存器
+    /// @param arm 汇编指令
+    /// @param defs 定义的寄存器
+    /// @param uses 使用的寄存器
+    ///
+    static void getDefsUses(ArmInst * arm, RegSet & defs, RegSet & uses);
+
+    ///
+    /// @brief 函数的汇编指令序列
+    ///
+    ArmInsts & code;
+
+    ///
+    /// @brief 有效的指令
+    ///
+    std::vector<ArmInst *> insts;
+
+    ///
+    /// @brief Label名称对应的指令位置
+    ///
+    std::unordered_map<std::string, size_t> labels;
+
+    ///
+    /// @brief 每条指令出口处活跃的寄存器
+    ///
+    std::vector<RegSet> liveOut;
+};
@@ -16,6 +16,7 @@
 #include "PlatformArm64.h"
 
 #include "IntegerType.h"
+#include "FloatType.h"
 #include <algorithm>
 
 const std::string PlatformArm64::regName[] = {
@@ -52,7 +53,12 @@ const std::string PlatformArm64::regName[] = {
     "x30",
     "sp",
     //
-    "wzr"
+    "wzr",
+    // 浮点寄存器，s0-s7用于传参或返回值，s8-s15需要保护低64位
+    "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+    "s8", "s9", "s10", "s11", "s12", "s13", "s14", "s15",
+    "s16", "s17", "s18", "s19", "s20", "s21", "s22", "s23",
+    "s24", "s25", "s26", "s27", "s28", "s29", "s30", "s31"
 };
 
 RegVariable * PlatformArm64::intRegVal[PlatformArm64::maxRegNum] = {
@@ -90,6 +96,77 @@ RegVariable * PlatformArm64::intRegVal[PlatformArm64::maxRegNum] = {
     new RegVariable(IntegerType::getTypeInt(), PlatformArm64::regName[31], 31),
 };
 
+RegVariable * PlatformArm64::floatRegVal[PlatformArm64::maxFloatRegNum] = {
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(0)], ARM64_FREG(0)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(1)], ARM64_FREG(1)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(2)], ARM64_FREG(2)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(3)], ARM64_FREG(3)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(4)], ARM64_FREG(4)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(5)], ARM64_FREG(5)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(6)], ARM64_FREG(6)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(7)], ARM64_FREG(7)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(8)], ARM64_FREG(8)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(9)], ARM64_FREG(9)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(10)], ARM64_FREG(10)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(11)], ARM64_FREG(11)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(12)], ARM64_FREG(12)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(13)], ARM64_FREG(13)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(14)], ARM64_FREG(14)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(15)], ARM64_FREG(15)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(16)], ARM64_FREG(16)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(17)], ARM64_FREG(17)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(18)], ARM64_FREG(18)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(19)], ARM64_FREG(19)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(20)], ARM64_FREG(20)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(21)], ARM64_FREG(21)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(22)], ARM64_FREG(22)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(23)], ARM64_FREG(23)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(24)], ARM64_FREG(24)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(25)], ARM64_FREG(25)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(26)], ARM64_FREG(26)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(27)], ARM64_FREG(27)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(28)], ARM64_FREG(28)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(29)], ARM64_FREG(29)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(30)], ARM64_FREG(30)),
+    new RegVariable(FloatType::getTypeFloat(), PlatformArm64::regName[ARM64_FREG(31)], ARM64_FREG(31)),
+};
+
+/// @brief 获取寄存器编号对应的Value
+/// @param reg_no 寄存器编号，通用寄存器或浮点寄存器
+/// @return 寄存器Value
+RegVariable * PlatformArm64::regVal(int32_t reg_no)
+{
+    if (ARM64_IS_FREG(reg_no)) {
+        return floatRegVal[reg_no - ARM64_FREG_BASE];
+    }
+    return intRegVal[reg_no];
+}
+
+/// @brief 值是否使用浮点寄存器
+/// @param val 值
+/// @return 是否是
+bool PlatformArm64::isFloatValue(Value * val)
+{
+    // 寄存器Value按编号区分，不依赖全局类型对象的初始化顺序
+    if (auto regVar = dynamic_cast<RegVariable *>(val)) {
+        return ARM64_IS_FREG(regVar->getRegId());
+    }
+    return val->getType()->isFloatType();
+}
+
+/// @brief 按AAPCS64确定下一个形参或实参的传参寄存器，整数与浮点分别使用x0-x7与s0-s7
+/// @param val 形参或实参
+/// @param intCnt 已使用的整数传参寄存器个数，使用后累加
+/// @param floatCnt 已使用的浮点传参寄存器个数，使用后累加
+/// @return 寄存器编号，需要栈传递时为-1
+int32_t PlatformArm64::argRegNo(Value * val, int32_t & intCnt, int32_t & floatCnt)
+{
+    if (isFloatValue(val)) {
+        return floatCnt < 8 ? ARM64_FREG(floatCnt++) : -1;
+    }
+    return intCnt < 8 ? intCnt++ : -1;
+}
+
 /// @brief 循环左移两位
 /// @param num
 void PlatformArm64::roundLeftShiftTwoBit(unsigned int & num)
@@ -35,6 +35,18 @@
 
 #define ARM64_CALLER_SAVE(x) ((x)>=19 && (x)<=28)
 
+// 浮点寄存器s0-s31编号在通用寄存器之后
+#define ARM64_FREG_BASE 33
+#define ARM64_FREG(n) (ARM64_FREG_BASE + (n))
+#define ARM64_IS_FREG(x) ((x) >= ARM64_FREG_BASE)
+
+// 浮点运算临时借助的寄存器s16、s17
+#define ARM64_FTMP_REG_NO ARM64_FREG(16)
+#define ARM64_FTMP_REG_NO2 ARM64_FREG(17)
+
+// 被调用函数需要保护的浮点寄存器v8-v15，保存其低64位d8-d15
+#define ARM64_FREG_SAVE(x) ((x)>=ARM64_FREG(8) && (x)<=ARM64_FREG(15))
+
 /// @brief ARM32平台信息
 class PlatformArm64 {
 
@@ -69,9 +81,32 @@ public:
     /// @brief 可使用的通用寄存器的个数r0-r10
     static const int maxUsableRegNum = 16;
 
-    /// @brief 寄存器的名字，x0-x30,sp,zr
-    static const std::string regName[maxRegNum+1];
+    /// @brief 浮点寄存器数目
+    static const int maxFloatRegNum = 32;
+
+    /// @brief 寄存器的名字，x0-x30,sp,zr，之后是浮点寄存器s0-s31
+    static const std::string regName[ARM64_FREG_BASE + maxFloatRegNum];
 
     /// @brief 对寄存器R0分配Value，记录位置
     static RegVariable * intRegVal[maxRegNum];
+
+    /// @brief 浮点寄存器s0-s31对应的Value
+    static RegVariable * floatRegVal[maxFloatRegNum];
+
+    /// @brief 获取寄存器编号对应的Value
+    /// @param reg_no 寄存器编号，通用寄存器或浮点寄存器
+    /// @return 寄存器Value
+    static RegVariable * regVal(int32_t reg_no);
+
+    /// @brief 值是否使用浮点寄存器
+    /// @param val 值
+    /// @return 是否是
+    static bool isFloatValue(Value * val);
+
+    /// @brief 按AAPCS64确定下一个形参或实参的传参寄存器，整数与浮点分别使用x0-x7与s0-s7
+    /// @param val 形参或实参
+    /// @param intCnt 已使用的整数传参寄存器个数，使用后累加
+    /// @param floatCnt 已使用的浮点传参寄存器个数，使用后累加
+    /// @return 寄存器编号，需要栈传递时为-1
+    static int32_t argRegNo(Value * val, int32_t & intCnt, int32_t & floatCnt);
 };
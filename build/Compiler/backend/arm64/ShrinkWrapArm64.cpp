@@ -0,0 +1,197 @@
+///
+/// @file ShrinkWrapArm64.cpp
+/// @brief 栈帧建立与恢复的位置下沉(shrink-wrapping)
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <vector>
+
+#include "ShrinkWrapArm64.h"
+#include "BasicBlock.h"
+#include "Function.h"
+#include "DominatorTree.h"
+#include "LoopInfo.h"
+#include "ExitInstruction.h"
+#include "GotoInstruction.h"
+#include "LabelInstruction.h"
+#include "PlatformArm64.h"
+
+///
+/// @brief 构造函数
+/// @param _func 函数，要求已经完成寄存器分配，指令在线性IR指令序列中
+///
+ShrinkWrapArm64::ShrinkWrapArm64(Function * _func) : func(_func)
+{}
+
+///
+/// @brief 确定建立栈帧的位置，需要时增加不恢复栈帧的出口
+///
+void ShrinkWrapArm64::run()
+{
+    func->setFrameLabel(nullptr);
+    func->setFramelessExit(nullptr);
+
+    func->buildBlocks();
+
+    auto & blocks = func->getBlocks();
+    DominatorTree domTree(func);
+    LoopInfo loopInfo(func, domTree);
+
+    // 需要栈帧的基本块的最近公共支配者，以及唯一的出口块
+    BasicBlock * frameBlock = nullptr;
+    BasicBlock * exitBlock = nullptr;
+    int32_t exitCount = 0;
+    for (auto block: blocks) {
+        if (!block->isReachable()) {
+            continue;
+        }
+        bool need = false;
+        for (auto inst: block->getInsts()) {
+            if (inst->isDead()) {
+                continue;
+            }
+            need = need || needFrame(inst);
+            if (inst->getOp() == IRInstOperator::IRINST_OP_EXIT) {
+                exitBlock = block;
+                exitCount++;
+            }
+        }
+        if (need) {
+            frameBlock = frameBlock ? domTree.findNearestCommonDominator(frameBlock, block) : block;
+        }
+    }
+
+    // 入口就需要栈帧，或者位置在循环内会反复建立，则保持在入口处建立
+    if (!frameBlock || frameBlock == blocks.front() || exitCount != 1 || loopInfo.getLoopDepth(frameBlock) ||
+        frameBlock->getLeader()->getOp() != IRInstOperator::IRINST_OP_LABEL) {
+        func->linearizeBlocks();
+        return;
+    }
+
+    // 从建立栈帧处可达的基本块除出口块外都要被它支配，否则会有不经过建立栈帧处就进入的路径
+    std::vector<bool> visited(blocks.size(), false);
+    std::vector<BasicBlock *> worklist{frameBlock};
+    visited[frameBlock->getIndex()] = true;
+    while (!worklist.empty()) {
+        BasicBlock * block = worklist.back();
+        worklist.pop_back();
+        if (block != exitBlock && !domTree.dominates(frameBlock, block)) {
+            func->linearizeBlocks();
+            return;
+        }
+        for (auto succ: block->getSuccs()) {
+            if (!visited[succ->getIndex()]) {
+                visited[succ->getIndex()] = true;
+                worklist.push_back(succ);
+            }
+        }
+    }
+
+    if (!domTree.dominates(frameBlock, exitBlock)) {
+        // 出口块除Label指令外只有出口指令时才复制出一个不恢复栈帧的出口
+        Instruction * exitInst = nullptr;
+        for (auto inst: exitBlock->getInsts()) {
+            if (inst->isDead() || inst->getOp() == IRInstOperator::IRINST_OP_LABEL) {
+                continue;
+            }
+            if (inst->getOp() != IRInstOperator::IRINST_OP_EXIT) {
+                func->linearizeBlocks();
+                return;
+            }
+            exitInst = inst;
+        }
+
+        LabelInstruction * label = new LabelInstruction(func);
+        ExitInstruction * framelessExit =
+            new ExitInstruction(func, exitInst->getOperandsNum() ? exitInst->getOperand(0) : nullptr);
+
+        // 不经过建立栈帧处的前驱改为跳转到新的出口
+        for (auto pred: exitBlock->getPreds()) {
+            if (!pred->isReachable() || domTree.dominates(frameBlock, pred)) {
+                continue;
+            }
+            GotoInstruction * gotoInst = dynamic_cast<GotoInstruction *>(pred->getTerminator());
+            if (gotoInst) {
+                if (gotoInst->iftrue == exitBlock->getLeader()) {
+                    gotoInst->iftrue = label;
+                }
+                if (gotoInst->iffalse == exitBlock->getLeader()) {
+                    gotoInst->iffalse = label;
+                }
+            } else {
+                // 顺序执行到出口块的，增加跳转
+                pred->getInsts().push_back(new GotoInstruction(func, label));
+            }
+        }
+
+        BasicBlock * framelessBlock = new BasicBlock(func);
+        framelessBlock->getInsts().push_back(label);
+        framelessBlock->getInsts().push_back(framelessExit);
+        blocks.push_back(framelessBlock);
+
+        func->setFramelessExit(framelessExit);
+    }
+
+    func->setFrameLabel(frameBlock->getLeader());
+    func->linearizeBlocks();
+}
+
+///
+/// @brief 指令是否需要栈帧，GEP操作数递归展开
+/// @param inst 指令
+/// @return true 需要
+/// @return false 不需要
+///
+bool ShrinkWrapArm64::needFrame(Instruction * inst)
+{
+    // 函数调用需要保存lr，并且可能用到栈传递实参的空间
+    if (inst->getOp() == IRInstOperator::IRINST_OP_FUNC_CALL) {
+        return true;
+    }
+
+    // 保存地址的GEP可能分配到被调用者保存的寄存器
+    if (inst->hasResultValue() && needFrame((Value *) inst)) {
+        return true;
+    }
+
+    for (int32_t k = 0; k < inst->getOperandsNum(); k++) {
+        Value * val = inst->getOperand(k);
+        Instruction * gep = dynamic_cast<Instruction *>(val);
+        if (gep && gep != inst && gep->getOp() == IRInstOperator::IRINST_OP_GEP) {
+            if (needFrame(gep)) {
+                return true;
+            }
+        } else if (needFrame(val)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+///
+/// @brief 值是否需要栈帧，即在被调用者保存的寄存器中或者在栈内
+/// @param val 值
+/// @return true 需要
+/// @return false 不需要
+///
+bool ShrinkWrapArm64::needFrame(Value * val)
+{
+    int32_t reg = val->getRegId();
+    if (reg != -1) {
+        return ARM64_CALLER_SAVE(reg) || ARM64_FREG_SAVE(reg);
+    }
+
+    int32_t base = -1;
+    return val->getMemoryAddr(&base) && (base == ARM64_FP_REG_NO || base == ARM64_SP_REG_NO);
+}
@@ -0,0 +1,67 @@
+///
+/// @file ShrinkWrapArm64.h
+/// @brief 栈帧建立与恢复的位置下沉(shrink-wrapping)
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+class Function;
+class Instruction;
+class Value;
+
+///
+/// @brief 栈帧建立与恢复的位置下沉(shrink-wrapping)
+///
+/// 寄存器分配之后，使用被调用者保存的寄存器、访问栈内变量或者调用函数的基本块需要栈帧。
+/// 取这些基本块的最近公共支配者作为建立栈帧的位置，要求它不在循环内，
+/// 且从它可达的基本块除出口块外都被它支配，这样不经过它的路径上都不需要栈帧。
+/// 这些路径若到达出口块，则改为跳转到新增的不恢复栈帧的出口，
+/// 如gcd、fib等递归函数的递归出口可以不保存、不恢复任何寄存器直接返回。
+///
+class ShrinkWrapArm64 {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _func 函数，要求已经完成寄存器分配，指令在线性IR指令序列中
+    ///
+    explicit ShrinkWrapArm64(Function * _func);
+
+    ///
+    /// @brief 确定建立栈帧的位置，需要时增加不恢复栈帧的出口
+    ///
+    void run();
+
+private:
+    ///
+    /// @brief 指令是否需要栈帧，GEP操作数递归展开
+    /// @param inst 指令
+    /// @return true 需要
+    /// @return false 不需要
+    ///
+    static bool needFrame(Instruction * inst);
+
+    ///
+    /// @brief 值是否需要栈帧，即在被调用者保存的寄存器中或者在栈内
+    /// @param val 值
+    /// @return true 需要
+    /// @return false 不需要
+    ///
+    static bool needFrame(Value * val);
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func;
+};
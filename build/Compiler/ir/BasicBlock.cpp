@@ -0,0 +1,182 @@
+///
+/// @file BasicBlock.cpp
+/// @brief 基本块，函数的控制流图由基本块组成
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "BasicBlock.h"
+#include "Instruction.h"
+#include "PhiInstruction.h"
+
+///
+/// @brief 构造函数
+/// @param _func 所属的函数
+///
+BasicBlock::BasicBlock(Function * _func) : func(_func)
+{}
+
+///
+/// @brief 获取所属的函数
+/// @return Function* 函数
+///
+Function * BasicBlock::getFunction()
+{
+    return func;
+}
+
+///
+/// @brief 获取基本块内的指令序列
+/// @return std::vector<Instruction *>& 指令序列
+///
+std::vector<Instruction *> & BasicBlock::getInsts()
+{
+    return insts;
+}
+
+///
+/// @brief 获取基本块的首指令，即Entry或者Label指令
+/// @return Instruction* 首指令
+///
+Instruction * BasicBlock::getLeader()
+{
+    return insts.empty() ? nullptr : insts.front();
+}
+
+///
+/// @brief 获取基本块末尾的跳转指令或出口指令
+/// @return Instruction* 跳转指令或出口指令，顺序执行到下一个基本块时为nullptr
+///
+Instruction * BasicBlock::getTerminator()
+{
+    if (insts.empty()) {
+        return nullptr;
+    }
+
+    Instruction * last = insts.back();
+    if (last->getOp() == IRINST_OP_GOTO || last->getOp() == IRINST_OP_EXIT) {
+        return last;
+    }
+
+    return nullptr;
+}
+
+///
+/// @brief 获取基本块开头的Phi指令
+/// @return std::vector<PhiInstruction *> Phi指令
+///
+std::vector<PhiInstruction *> BasicBlock::getPhis()
+{
+    std::vector<PhiInstruction *> phis;
+
+    // Phi指令紧跟在首指令之后
+    for (size_t pos = 1; pos < insts.size() && insts[pos]->getOp() == IRINST_OP_PHI; pos++) {
+        phis.push_back(static_cast<PhiInstruction *>(insts[pos]));
+    }
+
+    return phis;
+}
+
+///
+/// @brief 在基本块的末尾、跳转指令之前插入指令
+/// @param inst 指令
+///
+void BasicBlock::insertBeforeTerminator(Instruction * inst)
+{
+    if (getTerminator()) {
+        insts.insert(insts.end() - 1, inst);
+    } else {
+        insts.push_back(inst);
+    }
+}
+
+///
+/// @brief 获取前驱基本块
+/// @return std::vector<BasicBlock *>& 前驱基本块
+///
+std::vector<BasicBlock *> & BasicBlock::getPreds()
+{
+    return preds;
+}
+
+///
+/// @brief 获取后继基本块
+/// @return std::vector<BasicBlock *>& 后继基本块
+///
+std::vector<BasicBlock *> & BasicBlock::getSuccs()
+{
+    return succs;
+}
+
+///
+/// @brief 获取基本块在函数内的编号，即在基本块序列中的位置
+/// @return int32_t 编号
+///
+int32_t BasicBlock::getIndex()
+{
+    return index;
+}
+
+///
+/// @brief 设置基本块在函数内的编号
+/// @param _index 编号
+///
+void BasicBlock::setIndex(int32_t _index)
+{
+    index = _index;
+}
+
+///
+/// @brief 获取逆后序编号
+/// @return int32_t 逆后序编号，-1表示从入口不可达
+///
+int32_t BasicBlock::getRPO()
+{
+    return rpo;
+}
+
+///
+/// @brief 设置逆后序编号
+/// @param _rpo 逆后序编号
+///
+void BasicBlock::setRPO(int32_t _rpo)
+{
+    rpo = _rpo;
+}
+
+///
+/// @brief 是否从入口可达
+/// @return true 可达
+/// @return false 不可达
+///
+bool BasicBlock::isReachable()
+{
+    return rpo >= 0;
+}
+
+///
+/// @brief 获取基本块的名字，入口基本块为entry，其它一般为Label指令的名字
+/// @return std::string 名字
+///
+std::string BasicBlock::getName()
+{
+    Instruction * leader = getLeader();
+    if (leader && leader->getOp() == IRINST_OP_LABEL) {
+        return leader->getIRName();
+    }
+    if (leader && leader->getOp() == IRINST_OP_ENTRY) {
+        return "entry";
+    }
+
+    // 跳转指令之后没有Label的不可达代码
+    return "bb" + std::to_string(index);
+}
@@ -0,0 +1,158 @@
+///
+/// @file BasicBlock.h
+/// @brief 基本块，函数的控制流图由基本块组成
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Function;
+class Instruction;
+class PhiInstruction;
+
+///
+/// @brief 基本块，拥有自己的指令序列以及前驱后继基本块
+///
+/// 第一条指令为Entry指令（入口基本块）或者Label指令，Phi指令紧随其后。
+/// 最后一条指令若是跳转指令或者出口指令则决定了后继，否则顺序执行到下一个基本块。
+/// 前驱后继、编号以及逆后序编号由Function::updateCFG统一维护。
+///
+class BasicBlock {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _func 所属的函数
+    ///
+    explicit BasicBlock(Function * _func);
+
+    ///
+    /// @brief 获取所属的函数
+    /// @return Function* 函数
+    ///
+    Function * getFunction();
+
+    ///
+    /// @brief 获取基本块内的指令序列
+    /// @return std::vector<Instruction *>& 指令序列
+    ///
+    std::vector<Instruction *> & getInsts();
+
+    ///
+    /// @brief 获取基本块的首指令，即Entry或者Label指令
+    /// @return Instruction* 首指令
+    ///
+    Instruction * getLeader();
+
+    ///
+    /// @brief 获取基本块末尾的跳转指令或出口指令
+    /// @return Instruction* 跳转指令或出口指令，顺序执行到下一个基本块时为nullptr
+    ///
+    Instruction * getTerminator();
+
+    ///
+    /// @brief 获取基本块开头的Phi指令
+    /// @return std::vector<PhiInstruction *> Phi指令
+    ///
+    std::vector<PhiInstruction *> getPhis();
+
+    ///
+    /// @brief 在基本块的末尾、跳转指令之前插入指令
+    /// @param inst 指令
+    ///
+    void insertBeforeTerminator(Instruction * inst);
+
+    ///
+    /// @brief 获取前驱基本块
+    /// @return std::vector<BasicBlock *>& 前驱基本块
+    ///
+    std::vector<BasicBlock *> & getPreds();
+
+    ///
+    /// @brief 获取后继基本块
+    /// @return std::vector<BasicBlock *>& 后继基本块
+    ///
+    std::vector<BasicBlock *> & getSuccs();
+
+    ///
+    /// @brief 获取基本块在函数内的编号，即在基本块序列中的位置
+    /// @return int32_t 编号
+    ///
+    int32_t getIndex();
+
+    ///
+    /// @brief 设置基本块在函数内的编号
+    /// @param _index 编号
+    ///
+    void setIndex(int32_t _index);
+
+    ///
+    /// @brief 获取逆后序编号
+    /// @return int32_t 逆后序编号，-1表示从入口不可达
+    ///
+    int32_t getRPO();
+
+    ///
+    /// @brief 设置逆后序编号
+    /// @param _rpo 逆后序编号
+    ///
+    void setRPO(int32_t _rpo);
+
+    ///
+    /// @brief 是否从入口可达
+    /// @return true 可达
+    /// @return false 不可达
+    ///
+    bool isReachable();
+
+    ///
+    /// @brief 获取基本块的名字，入口基本块为entry，其它一般为Label指令的名字
+    /// @return std::string 名字
+    ///
+    std::string getName();
+
+private:
+    ///
+    /// @brief 所属的函数
+    ///
+    Function * func;
+
+    ///
+    /// @brief 指令序列
+    ///
+    std::vector<Instruction *> insts;
+
+    ///
+    /// @brief 前驱基本块
+    ///
+    std::vector<BasicBlock *> preds;
+
+    ///
+    /// @brief 后继基本块
+    ///
+    std::vector<BasicBlock *> succs;
+
+    ///
+    /// @brief 在函数基本块序列中的编号
+    ///
+    int32_t index = -1;
+
+    ///
+    /// @brief 逆后序编号，-1表示不可达
+    ///
+    int32_t rpo = -1;
+};
@@ -14,11 +14,15 @@
 /// </table>
 ///
 
+#include <algorithm>
 #include <cstdlib>
 #include <string>
+#include <unordered_map>
 
 #include "IRConstant.h"
 #include "Function.h"
+#include "GotoInstruction.h"
+#include "PhiInstruction.h"
 
 /// @brief 指定函数名字、函数类型的构造函数
 /// @param _name 函数名称
@@ -109,9 +113,19 @@ void Function::toString(std::string & str)
         str += "\n";
     }
 
+    // 划分了基本块时指令在基本块内，按基本块的顺序输出
+    std::vector<Instruction *> insts;
+    if (blocks.empty()) {
+        insts = code.getInsts();
+    } else {
+        for (auto block: blocks) {
+            insts.insert(insts.end(), block->getInsts().begin(), block->getInsts().end());
+        }
+    }
+
     // 输出临时变量的declare形式
     // 遍历所有的线性IR指令，文本输出
-    for (auto & inst: code.getInsts()) {
+    for (auto & inst: insts) {
 
         if (inst->hasResultValue()) {
 
@@ -121,7 +135,7 @@ void Function::toString(std::string & str)
     }
 
     // 遍历所有的线性IR指令，文本输出
-    for (auto & inst: code.getInsts()) {
+    for (auto & inst: insts) {
 
         std::string instStr;
         inst->toString(instStr);
@@ -155,6 +169,34 @@ Instruction * Function::getExitLabel()
     return exitLabel;
 }
 
+/// @brief 设置建立栈帧的Label指令，shrink-wrapping后栈帧在该Label处而不是函数入口处建立
+/// @param inst Label指令，nullptr表示在函数入口处建立
+void Function::setFrameLabel(Instruction * inst)
+{
+    frameLabel = inst;
+}
+
+/// @brief 获取建立栈帧的Label指令
+/// @return Label指令，nullptr表示在函数入口处建立
+Instruction * Function::getFrameLabel()
+{
+    return frameLabel;
+}
+
+/// @brief 设置不经过栈帧建立点的出口指令，该出口不需要恢复栈帧
+/// @param inst 出口指令
+void Function::setFramelessExit(Instruction * inst)
+{
+    framelessExit = inst;
+}
+
+/// @brief 获取不经过栈帧建立点的出口指令
+/// @return 出口指令，没有时为nullptr
+Instruction * Function::getFramelessExit()
+{
+    return framelessExit;
+}
+
 /// @brief 设置函数返回值变量
 /// @param val 返回值变量，要求必须是局部变量，不能是临时变量
 void Function::setReturnValue(LocalVariable * val)
@@ -259,7 +301,8 @@ MemVariable * Function::newMemVariable(Type * type)
 /// @brief 清理函数内申请的资源
 void Function::Delete()
 {
-    // 清理IR指令
+    // 清理IR指令，基本块内的指令先放回线性IR指令序列
+    linearizeBlocks();
     code.Delete();
 
     // 清理Value
@@ -294,13 +337,226 @@ void Function::renameIR()
     }
 
     // 遍历所有的指令进行命名
-    for (auto inst: this->getInterCode().getInsts()) {
+    auto renameInst = [&nameIndex](Instruction * inst) {
         if (inst->getOp() == IRInstOperator::IRINST_OP_LABEL) {
             inst->setIRName(IR_LABEL_PREFIX + std::to_string(nameIndex++));
         } else if (inst->hasResultValue()) {
             inst->setIRName(IR_TEMP_VARNAME_PREFIX + std::to_string(nameIndex++));
         }
+    };
+
+    for (auto inst: this->getInterCode().getInsts()) {
+        renameInst(inst);
+    }
+    for (auto block: blocks) {
+        for (auto inst: block->getInsts()) {
+            renameInst(inst);
+        }
+    }
+}
+
+///
+/// @brief 把线性IR指令序列划分为基本块，指令移到基本块中，并建立控制流图
+///
+void Function::buildBlocks()
+{
+    if (!blocks.empty()) {
+        return;
+    }
+
+    auto & insts = code.getInsts();
+
+    // Entry指令、Label指令以及跳转、出口指令的下一条指令为基本块的首指令
+    for (size_t pos = 0; pos < insts.size(); pos++) {
+        Instruction * inst = insts[pos];
+        bool leader = (pos == 0) || (inst->getOp() == IRInstOperator::IRINST_OP_LABEL) ||
+                      (insts[pos - 1]->getOp() == IRInstOperator::IRINST_OP_GOTO) ||
+                      (insts[pos - 1]->getOp() == IRInstOperator::IRINST_OP_EXIT);
+        if (leader) {
+            blocks.push_back(new BasicBlock(this));
+        }
+        blocks.back()->getInsts().push_back(inst);
+    }
+
+    // 指令已归基本块所有
+    insts.clear();
+
+    updateCFG();
+}
+
+///
+/// @brief 基本块内的指令按基本块的顺序放回线性IR指令序列，并删除基本块
+///
+void Function::linearizeBlocks()
+{
+    if (blocks.empty()) {
+        return;
+    }
+
+    auto & insts = code.getInsts();
+    insts.clear();
+
+    for (auto block: blocks) {
+        insts.insert(insts.end(), block->getInsts().begin(), block->getInsts().end());
+        delete block;
+    }
+
+    blocks.clear();
+    rpoBlocks.clear();
+}
+
+///
+/// @brief 是否已经划分了基本块
+/// @return true 已划分，指令在基本块内
+/// @return false 未划分，指令在线性IR指令序列中
+///
+bool Function::hasBlocks()
+{
+    return !blocks.empty();
+}
+
+///
+/// @brief 根据基本块末尾的跳转指令重新计算前驱后继、编号以及逆后序
+/// @brief 基本块有增删或者跳转目标改变后需要调用
+///
+void Function::updateCFG()
+{
+    // 跳转目标Label指令到基本块的映射
+    std::unordered_map<Instruction *, BasicBlock *> leaderMap;
+    for (int32_t k = 0; k < (int32_t) blocks.size(); k++) {
+        BasicBlock * block = blocks[k];
+        block->setIndex(k);
+        block->setRPO(-1);
+        block->getPreds().clear();
+        block->getSuccs().clear();
+        leaderMap[block->getLeader()] = block;
+    }
+
+    auto addEdge = [](BasicBlock * from, BasicBlock * to) {
+        auto & succs = from->getSuccs();
+        if (std::find(succs.begin(), succs.end(), to) == succs.end()) {
+            succs.push_back(to);
+            to->getPreds().push_back(from);
+        }
+    };
+
+    for (int32_t k = 0; k < (int32_t) blocks.size(); k++) {
+        BasicBlock * block = blocks[k];
+        Instruction * last = block->getTerminator();
+        if (!last) {
+            // 顺序执行到下一个基本块
+            if (k + 1 < (int32_t) blocks.size()) {
+                addEdge(block, blocks[k + 1]);
+            }
+        } else if (last->getOp() == IRInstOperator::IRINST_OP_GOTO) {
+            auto gotoInst = static_cast<GotoInstruction *>(last);
+            addEdge(block, leaderMap[gotoInst->iftrue]);
+            if (gotoInst->getCondiValue() && gotoInst->iffalse) {
+                addEdge(block, leaderMap[gotoInst->iffalse]);
+            }
+        }
+    }
+
+    // 深度优先遍历求后序，非递归实现，避免基本块过多时栈溢出
+    rpoBlocks.clear();
+    if (blocks.empty()) {
+        return;
+    }
+
+    std::vector<bool> visited(blocks.size(), false);
+    std::vector<std::pair<BasicBlock *, size_t>> stack;
+    stack.emplace_back(blocks[0], 0);
+    visited[0] = true;
+    while (!stack.empty()) {
+        auto & top = stack.back();
+        auto & succs = top.first->getSuccs();
+        if (top.second < succs.size()) {
+            BasicBlock * succ = succs[top.second++];
+            if (!visited[succ->getIndex()]) {
+                visited[succ->getIndex()] = true;
+                stack.emplace_back(succ, 0);
+            }
+        } else {
+            rpoBlocks.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+
+    std::reverse(rpoBlocks.begin(), rpoBlocks.end());
+    for (int32_t k = 0; k < (int32_t) rpoBlocks.size(); k++) {
+        rpoBlocks[k]->setRPO(k);
+    }
+}
+
+///
+/// @brief 删除从入口不可达的基本块，含出口指令的基本块保留
+/// @return true 有基本块被删除
+/// @return false 没有变化
+///
+bool Function::removeUnreachableBlocks()
+{
+    std::vector<BasicBlock *> deadBlocks, liveBlocks;
+    for (auto block: blocks) {
+        Instruction * last = block->getTerminator();
+        if (block->isReachable() || (last && last->getOp() == IRInstOperator::IRINST_OP_EXIT)) {
+            liveBlocks.push_back(block);
+        } else {
+            deadBlocks.push_back(block);
+        }
+    }
+
+    if (deadBlocks.empty()) {
+        return false;
+    }
+
+    // 后继基本块的Phi指令去掉来自被删除基本块的值
+    for (auto block: deadBlocks) {
+        for (auto succ: block->getSuccs()) {
+            for (auto phi: succ->getPhis()) {
+                for (int32_t k = phi->getIncomingCount() - 1; k >= 0; k--) {
+                    if (phi->getIncomingBlock(k) == block) {
+                        phi->removeIncoming(k);
+                    }
+                }
+            }
+        }
+    }
+
+    // 指令之间可能相互使用，先清除所有的操作数再释放
+    for (auto block: deadBlocks) {
+        for (auto inst: block->getInsts()) {
+            inst->clearOperands();
+        }
+    }
+    for (auto block: deadBlocks) {
+        for (auto inst: block->getInsts()) {
+            delete inst;
+        }
+        delete block;
     }
+
+    blocks.swap(liveBlocks);
+    updateCFG();
+
+    return true;
+}
+
+///
+/// @brief 获取基本块序列，即基本块在代码中的排列顺序，第一个为入口基本块
+/// @return std::vector<BasicBlock *>& 基本块序列
+///
+std::vector<BasicBlock *> & Function::getBlocks()
+{
+    return blocks;
+}
+
+///
+/// @brief 获取按逆后序排列的可达基本块
+/// @return std::vector<BasicBlock *>& 基本块序列
+///
+std::vector<BasicBlock *> & Function::getRPOBlocks()
+{
+    return rpoBlocks;
 }
 
 ///
@@ -24,7 +24,7 @@
 #include "LocalVariable.h"
 #include "MemVariable.h"
 #include "IRCode.h"
-#include "CFG.h"
+#include "BasicBlock.h"
 
 ///
 /// @brief 描述函数信息的类，是全局静态存储，其Value的类型为FunctionType
@@ -72,6 +72,22 @@ public:
     /// @return 出口Label指令
     Instruction * getExitLabel();
 
+    /// @brief 设置建立栈帧的Label指令，shrink-wrapping后栈帧在该Label处而不是函数入口处建立
+    /// @param inst Label指令，nullptr表示在函数入口处建立
+    void setFrameLabel(Instruction * inst);
+
+    /// @brief 获取建立栈帧的Label指令
+    /// @return Label指令，nullptr表示在函数入口处建立
+    Instruction * getFrameLabel();
+
+    /// @brief 设置不经过栈帧建立点的出口指令，该出口不需要恢复栈帧
+    /// @param inst 出口指令
+    void setFramelessExit(Instruction * inst);
+
+    /// @brief 获取不经过栈帧建立点的出口指令
+    /// @return 出口指令，没有时为nullptr
+    Instruction * getFramelessExit();
+
     /// @brief 设置函数返回值变量
     /// @param val 返回值变量，要求必须是局部变量，不能是临时变量
     void setReturnValue(LocalVariable * val);
@@ -155,6 +171,48 @@ public:
     ///
     void renameIR();
 
+    ///
+    /// @brief 把线性IR指令序列划分为基本块，指令移到基本块中，并建立控制流图
+    ///
+    void buildBlocks();
+
+    ///
+    /// @brief 基本块内的指令按基本块的顺序放回线性IR指令序列，并删除基本块
+    ///
+    void linearizeBlocks();
+
+    ///
+    /// @brief 是否已经划分了基本块
+    /// @return true 已划分，指令在基本块内
+    /// @return false 未划分，指令在线性IR指令序列中
+    ///
+    bool hasBlocks();
+
+    ///
+    /// @brief 根据基本块末尾的跳转指令重新计算前驱后继、编号以及逆后序
+    /// @brief 基本块有增删或者跳转目标改变后需要调用
+    ///
+    void updateCFG();
+
+    ///
+    /// @brief 删除从入口不可达的基本块，含出口指令的基本块保留
+    /// @return true 有基本块被删除
+    /// @return false 没有变化
+    ///
+    bool removeUnreachableBlocks();
+
+    ///
+    /// @brief 获取基本块序列，即基本块在代码中的排列顺序，第一个为入口基本块
+    /// @return std::vector<BasicBlock *>& 基本块序列
+    ///
+    std::vector<BasicBlock *> & getBlocks();
+
+    ///
+    /// @brief 获取按逆后序排列的可达基本块
+    /// @return std::vector<BasicBlock *>& 基本块序列
+    ///
+    std::vector<BasicBlock *> & getRPOBlocks();
+
     ///
     /// @brief 获取统计的ARG指令的个数
     /// @return int32_t 个数
@@ -192,6 +250,16 @@ private:
     ///
     InterCode code;
 
+    ///
+    /// @brief 基本块序列，划分基本块后指令归基本块所有，线性IR指令序列为空
+    ///
+    std::vector<BasicBlock *> blocks;
+
+    ///
+    /// @brief 按逆后序排列的可达基本块
+    ///
+    std::vector<BasicBlock *> rpoBlocks;
+
     ///
     /// @brief 函数内变量的向量表，可能重名，请注意
     ///
@@ -207,6 +275,16 @@ private:
     ///
     Instruction * exitLabel = nullptr;
 
+    ///
+    /// @brief 建立栈帧的Label指令，nullptr表示在函数入口处建立
+    ///
+    Instruction * frameLabel = nullptr;
+
+    ///
+    /// @brief 不经过栈帧建立点、不需要恢复栈帧的出口指令
+    ///
+    Instruction * framelessExit = nullptr;
+
     ///
     /// @brief 函数返回值变量，不能是临时变量，必须是局部变量
     ///
@@ -14,7 +14,8 @@
 /// <tr><td>2024-11-23 <td>1.1     <td>zenglj  <td>表达式版增强
 /// </table>
 ///
-// #include <algorithm>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstdio>
 #include <unordered_map>
@@ -33,6 +34,7 @@
 #include "BinaryInstruction.h"
 #include "MoveInstruction.h"
 #include "StoreInstruction.h"
+#include "MemsetInstruction.h"
 #include "LoadInstruction.h"
 #include "GotoInstruction.h"
 #include "TypeSystem.h"
@@ -58,6 +60,7 @@ static inline void backPatch(std::vector<LabelInstruction **> * a, LabelInstruct
 static inline std::vector<LabelInstruction **> * merge(std::vector<LabelInstruction **> *,
                                                        std::vector<LabelInstruction **> *);
 }
+static bool isZeroConst(Value * val);
 
 /// @brief 构造函数
 /// @param _root AST的根
@@ -352,6 +355,12 @@ bool IRGenerator::ir_function_call(ast_node * node)
         return false;
     }
 
+    // 全局变量的初值是常量表达式，不能有函数调用
+    if (!currentFunc) {
+        minic_log(LOG_ERROR, "全局变量的初值中不能调用函数%s", funcName.c_str());
+        return false;
+    }
+
     // 当前函数存在函数调用
     currentFunc->setExistFuncCall(true);
 
@@ -369,13 +378,20 @@ bool IRGenerator::ir_function_call(ast_node * node)
 
             // 遍历参数列表，孩子是表达式
             // 这里自左往右计算表达式
+            auto & formalParams = calledFunction->getParams();
             for (auto son: paramsNode->sons) {
 
                 // 遍历Block的每个语句，进行显示或者运算
                 ast_node * CHECK_NODE(temp, son);
 
-                realParams.push_back(temp->val);
                 node->blockInsts.addInst(temp->blockInsts);
+
+                // 实参按形参的类型进行整数与浮点之间的转换
+                Value * arg = temp->val;
+                if (realParams.size() < formalParams.size()) {
+                    arg = castValue(arg, formalParams[realParams.size()]->getType(), node->blockInsts);
+                }
+                realParams.push_back(arg);
             }
         }
     }
@@ -458,21 +474,10 @@ bool IRGenerator::ir_binary(ast_node * node)
 
     Function * func = module->getCurrentFunction();
 
-    // 如果操作数类型与结果类型不同，需要进行隐式类型转换
-    if (resultType->isFloatType()) {
-        if (!leftType->isFloatType()) {
-            // 整数转浮点 - 使用CastInstruction
-            Instruction * castInst =
-                new CastInstruction(func, leftVal, FloatType::getTypeFloat(), CastInstruction::INT_TO_FLOAT);
-            left->blockInsts.addInst(castInst);
-            leftVal = castInst;
-        } else if (!rightType->isFloatType()) {
-            // 整数转浮点 - 使用CastInstruction
-            Instruction * castInst =
-                new CastInstruction(func, rightVal, FloatType::getTypeFloat(), CastInstruction::INT_TO_FLOAT);
-            right->blockInsts.addInst(castInst);
-            rightVal = castInst;
-        }
+    // 如果操作数类型与运算类型不同，需要进行隐式类型转换，浮点比较的结果类型是bool，要看公共类型
+    if (TypeSystem::getCommonType(leftType, rightType)->isFloatType()) {
+        leftVal = castValue(leftVal, FloatType::getTypeFloat(), left->blockInsts);
+        rightVal = castValue(rightVal, FloatType::getTypeFloat(), right->blockInsts);
     }
 
     Instruction * addInst = new BinaryInstruction(func, op, leftVal, rightVal, resultType);
@@ -539,15 +544,16 @@ bool IRGenerator::ir_assign(ast_node * node)
         return false;
     }
 
-    // 这里只处理整型的数据，如需支持实数，则需要针对类型进行处理
-    // TODO real number add
+    // 整数与浮点之间赋值需要类型转换，数组元素的类型在左侧节点上
 
     Instruction * movInst;
     Function * func = module->getCurrentFunction();
     if (left->node_type == ASTOP(ARRAY_ACCESS)) {
-        movInst = new StoreInstruction(func, left->val, right->val);
+        Value * src = castValue(right->val, left->type, right->blockInsts);
+        movInst = new StoreInstruction(func, left->val, src);
     } else {
-        movInst = new MoveInstruction(func, left->val, right->val);
+        Value * src = castValue(right->val, left->val->getType(), right->blockInsts);
+        movInst = new MoveInstruction(func, left->val, src);
     }
 
     // 创建临时变量保存IR的值，以及线性IR指令
@@ -588,7 +594,8 @@ bool IRGenerator::ir_return(ast_node * node)
     node->blockInsts.addInst(right->blockInsts);
 
     // 返回值赋值到函数返回值变量上，然后跳转到函数的尾部
-    node->blockInsts.addInst(new MoveInstruction(currentFunc, currentFunc->getReturnValue(), right->val));
+    Value * retVal = castValue(right->val, currentFunc->getReturnType(), node->blockInsts);
+    node->blockInsts.addInst(new MoveInstruction(currentFunc, currentFunc->getReturnValue(), retVal));
 
     // 跳转到函数的尾部出口指令上
     node->blockInsts.addInst(new GotoInstruction(currentFunc, currentFunc->getExitLabel()));
@@ -666,38 +673,10 @@ bool IRGenerator::ir_variable_declare(ast_node * node)
     // 函数内定义
     if (func) {
         for (auto child:node->sons) {
-            // 检查是否是数组类型且需要计算维度
-            if (child->type && child->type->isArrayType() && 
-                static_cast<const ArrayType*>(child->type)->getElementType() == nullptr) {
-                
-                // 这是一个空的数组类型，需要计算维度
-                if (child->sons.size() >= 1 && child->sons[0]->node_type == ASTOP(ARRAY_INDICES)) {
-                    // 计算数组各维度的值
-                    ast_node* arrayIndicesNode = child->sons[0];
-                    std::vector<uint32_t> dimensions;
-                    
-                    for (auto dimExpr : arrayIndicesNode->sons) {
-                        if (dimExpr == nullptr) {
-                            // 空维度，使用0
-                            dimensions.push_back(0);
-                        } else {
-                            // 计算常量表达式
-                            ast_node* CHECK_NODE(dimResult, dimExpr);
-                            if (auto constInt = dynamic_cast<ConstInt*>(dimResult->val)) {
-                                dimensions.push_back(constInt->getVal());
-                            } else if (auto constFloat = dynamic_cast<ConstFloat*>(dimResult->val)) {
-                                dimensions.push_back((uint32_t)constFloat->getVal());
-                            } else {
-                                dimensions.push_back(1); // 默认值
-                            }
-                        }
-                    }
-                    
-                    // 使用计算出的维度创建新的数组类型
-                    child->type = ArrayType::createMultiDimensional(nullptr, dimensions);
-                }
+            if (!arrayDefineType(child)) {
+                return false;
             }
-            
+
             Value *val = module->newVarValue(child->type, child->name);
             child->val = val;
             
@@ -707,59 +686,82 @@ bool IRGenerator::ir_variable_declare(ast_node * node)
                 if (child->sons.size() > initNodeIndex) {
                     ast_node * CHECK_NODE(s, child->sons[initNodeIndex]);
                     if (s->node_type == ASTOP(ARRAY_INIT)) {
-                        Type *baseType = child->type;
-                        for (size_t i=0, l=s->sons.size(); i<l; i++) {
-                            ast_node *CHECK_NODE(item, s->sons[i]);
-                            node->blockInsts.addInst(item->blockInsts);
-                            Instruction *ptr = new BinaryInstruction(
-                                func, IRINST_OP_GEP, val, module->newConstInt(i), baseType
-                            );
-                            node->blockInsts.addInst(ptr);
-                            node->blockInsts.addInst(new StoreInstruction(func, ptr, item->val));
+                        if (!localArrayInit(s, val, node->blockInsts)) {
+                            return false;
                         }
                     } else {
+                        // 常量初值记下来，const变量可以出现在数组维度中
+                        std::unordered_map<Value *, Value *> consts;
+                        foldConstInit(s->blockInsts, consts);
+                        if (Value * init = constInitValue(s->val, consts)) {
+                            varConsts[val] = castValue(init, val->getType(), s->blockInsts);
+                        }
+
                         node->blockInsts.addInst(s->blockInsts);
-                        node->blockInsts.addInst(new MoveInstruction(func, child->val, s->val));
+                        Value *initVal = castValue(s->val, child->val->getType(), node->blockInsts);
+                        node->blockInsts.addInst(new MoveInstruction(func, child->val, initVal));
                     }
                 }
             }
         }
     } else for (auto child:node->sons) {
         // 全局变量定义，类似处理
-        if (child->type && child->type->isArrayType() && 
-            static_cast<const ArrayType*>(child->type)->getElementType() == nullptr) {
-            
-            if (child->sons.size() >= 1 && child->sons[0]->node_type == ASTOP(ARRAY_INDICES)) {
-                ast_node* arrayIndicesNode = child->sons[0];
-                std::vector<uint32_t> dimensions;
-                
-                for (auto dimExpr : arrayIndicesNode->sons) {
-                    if (dimExpr == nullptr) {
-                        dimensions.push_back(0);
-                    } else {
-                        ast_node* CHECK_NODE(dimResult, dimExpr);
-                        if (auto constInt = dynamic_cast<ConstInt*>(dimResult->val)) {
-                            dimensions.push_back(constInt->getVal());
-                        } else if (auto constFloat = dynamic_cast<ConstFloat*>(dimResult->val)) {
-                            dimensions.push_back((uint32_t)constFloat->getVal());
-                        } else {
-                            dimensions.push_back(1);
-                        }
-                    }
-                }
-                
-                child->type = ArrayType::createMultiDimensional(nullptr, dimensions);
-            }
+        if (!arrayDefineType(child)) {
+            return false;
         }
-        
+
         child->val = module->newVarValue(child->type, child->name);
         if (!child->sons.empty()) {
             int initNodeIndex = child->type && child->type->isArrayType() ? 1 : 0;
             if (child->sons.size() > initNodeIndex) {
                 ast_node *CHECK_NODE(s, child->sons[initNodeIndex]);
-                if (Instanceof(cexp, ConstInt *, s->val)) {
-                    Instanceof(gVal, GlobalVariable*, child->val);
-                    gVal->intVal = cexp->getVal();
+                Instanceof(gVal, GlobalVariable*, child->val);
+                // 全局变量的初值是常量表达式，在编译时求值，求值后表达式的指令不再需要
+                std::unordered_map<Value *, Value *> consts;
+                if (s->node_type == ASTOP(ARRAY_INIT)) {
+                    InterCode insts;
+                    std::vector<int32_t> dims;
+                    if (!arrayInitValues(s, child->type, dims, gVal->arrayInit, insts)) {
+                        return false;
+                    }
+                    foldConstInit(insts, consts);
+                    bool allZero = true;
+                    for (auto & val: gVal->arrayInit) {
+                        if (val && !(val = constInitValue(val, consts))) {
+                            minic_log(LOG_ERROR, "全局数组%s的初值不是常量表达式", child->name.c_str());
+                            gVal->arrayInit.clear();
+                            return false;
+                        }
+                        if (val && isZeroConst(val)) {
+                            val = nullptr;
+                        }
+                        allZero = allZero && !val;
+                    }
+                    insts.Delete();
+                    gVal->setInBSSSection(allZero);
+                } else {
+                    foldConstInit(s->blockInsts, consts);
+                    Value * init = constInitValue(s->val, consts);
+                    s->blockInsts.Delete();
+                    if (Instanceof(cexp, ConstInt *, init)) {
+                        if (child->type->isFloatType()) {
+                            gVal->floatVal = (float) cexp->getVal();
+                        } else {
+                            gVal->intVal = cexp->getVal();
+                        }
+                    } else if (Instanceof(fexp, ConstFloat *, init)) {
+                        if (child->type->isFloatType()) {
+                            gVal->floatVal = fexp->getVal();
+                        } else {
+                            gVal->intVal = (int32_t) fexp->getVal();
+                        }
+                    } else {
+                        minic_log(LOG_ERROR, "全局变量%s的初值不是常量表达式", child->name.c_str());
+                        return false;
+                    }
+                }
+                if (!child->type->isArrayType()) {
+                    gVal->setInBSSSection(gVal->intVal == 0);
                 }
             }
         }
@@ -767,6 +769,49 @@ bool IRGenerator::ir_variable_declare(ast_node * node)
     return true;
 }
 
+/// @brief 数组定义的各维度是常量表达式，在编译时求值后确定数组的类型
+/// @param child 变量定义节点
+/// @return 翻译是否成功，true：成功，false：失败
+bool IRGenerator::arrayDefineType(ast_node * child)
+{
+    // 不是数组，或者类型已确定
+    if (!child->type || !child->type->isArrayType() ||
+        static_cast<const ArrayType *>(child->type)->getNumElements() != 0) {
+        return true;
+    }
+    if (child->sons.empty() || child->sons[0]->node_type != ASTOP(ARRAY_INDICES)) {
+        return true;
+    }
+
+    // 元素类型在声明时已设置
+    Type * baseType = (Type *) static_cast<const ArrayType *>(child->type)->getElementType();
+    std::vector<uint32_t> dimensions;
+    for (auto dimExpr: child->sons[0]->sons) {
+        ast_node * CHECK_NODE(dimResult, dimExpr);
+
+        std::unordered_map<Value *, Value *> consts;
+        foldConstInit(dimResult->blockInsts, consts);
+        Value * dim = constInitValue(dimResult->val, consts);
+        dimResult->blockInsts.Delete();
+
+        int32_t size = 0;
+        if (Instanceof(constInt, ConstInt *, dim)) {
+            size = constInt->getVal();
+        } else if (Instanceof(constFloat, ConstFloat *, dim)) {
+            size = (int32_t) constFloat->getVal();
+        }
+        if (size <= 0) {
+            minic_log(LOG_ERROR, "数组%s的维度不是正的常量表达式", child->name.c_str());
+            return false;
+        }
+        dimensions.push_back((uint32_t) size);
+    }
+
+    child->type = ArrayType::createMultiDimensional(baseType, dimensions);
+
+    return true;
+}
+
 /// @brief 分支语句
 bool IRGenerator::ir_branch(ast_node * node)
 {
@@ -885,10 +930,12 @@ bool IRGenerator::ir_not(ast_node * node)
     ast_node * CHECK_NODE(kid, node->sons[0]);
     node->blockInsts.addInst(kid->blockInsts);
 
-    // TODO float cmp
     auto func = module->getCurrentFunction();
     Value * v = kid->val;
-    if (v->getType() != IntegerType::getTypeBool()) {
+    if (v->getType()->isFloatType()) {
+        v = new BinaryInstruction(func, IROP(FNE), kid->val, module->newConstFloat(0), IntegerType::getTypeBool());
+        node->blockInsts.addInst((Instruction *) v);
+    } else if (v->getType() != IntegerType::getTypeBool()) {
         v = new BinaryInstruction(func, IROP(INE), kid->val, module->newConstInt(0), IntegerType::getTypeBool());
         node->blockInsts.addInst((Instruction *) v);
     }
@@ -908,6 +955,39 @@ bool IRGenerator::ir_jump(ast_node * node)
     return true;
 }
 
+/// @brief 值隐式转换为指定类型，整数与浮点之间插入类型转换指令，常量直接转换
+/// @param val 值
+/// @param type 目标类型
+/// @param insts 类型转换指令追加的指令序列
+/// @return 转换后的值，不需要转换时为原值
+Value * IRGenerator::castValue(Value * val, const Type * type, InterCode & insts)
+{
+    Type * srcType = val->getType();
+    Function * func = module->getCurrentFunction();
+
+    if (type->isFloatType() && srcType->isIntegerType()) {
+        if (Instanceof(constInt, ConstInt *, val)) {
+            return module->newConstFloat((float) constInt->getVal());
+        }
+        Instruction * castInst =
+            new CastInstruction(func, val, FloatType::getTypeFloat(), CastInstruction::INT_TO_FLOAT);
+        insts.addInst(castInst);
+        return castInst;
+    }
+
+    if (type->isIntegerType() && srcType->isFloatType()) {
+        if (Instanceof(constFloat, ConstFloat *, val)) {
+            return module->newConstInt((int32_t) constFloat->getVal());
+        }
+        Instruction * castInst =
+            new CastInstruction(func, val, IntegerType::getTypeInt(), CastInstruction::FLOAT_TO_INT);
+        insts.addInst(castInst);
+        return castInst;
+    }
+
+    return val;
+}
+
 IRInstOperator irtype(ast_operator_type type)
 {
     switch (type) {
@@ -1014,19 +1094,301 @@ bool IRGenerator::ir_lval_to_r(ast_node * node)
 /// @return 翻译是否成功，true：成功，false：失败
 bool IRGenerator::ir_array_init(ast_node * node)
 {
-    // TODO: 实现数组初始化的IR生成
-    // 这里需要根据初始化列表生成相应的赋值指令
-    
-    //Function * currentFunc = module->getCurrentFunction();
-    for (size_t i=0; i<node->sons.size(); i++) {
-        ast_node *el = node->sons[i];
-        if (el->node_type == ASTOP(ARRAY_INIT)) {
-            ir_array_init(el);
-            auto x = node->sons.begin()+i;
-            node->sons.erase(x);
-            node->sons.insert(x, el->sons.begin(), el->sons.end());
+    // 花括号的嵌套决定初值对应的元素，要按数组的维度展开，在变量定义时由arrayInitLayout处理
+    (void) node;
+
+    return true;
+}
+
+/// @brief 按花括号的嵌套把初始化列表中的初值放到对应的元素位置，初值多于元素时报错
+/// @param node 初始化列表节点
+/// @param sizes sizes[k]为第k维及以后各维的元素个数，最后一项为1
+/// @param level 初始化列表对应的维度
+/// @param pos 初始化列表的起始元素位置
+/// @param vals 各元素位置的初值，未给出的为nullptr
+/// @param insts 初值表达式的指令追加到的指令序列
+/// @return 翻译是否成功，true：成功，false：失败
+bool IRGenerator::arrayInitLayout(ast_node * node,
+                                  const std::vector<int32_t> & sizes,
+                                  size_t level,
+                                  int32_t pos,
+                                  std::vector<Value *> & vals,
+                                  InterCode & insts)
+{
+    int32_t end = pos + sizes[level];
+
+    for (auto son: node->sons) {
+        if (pos >= end) {
+            minic_log(LOG_ERROR, "初始化列表中的初值多于数组的元素");
+            return false;
+        }
+
+        if (son->node_type == ASTOP(ARRAY_INIT)) {
+            // 内层的花括号对应能从当前位置开始的最大的子数组，没有时对应一个元素
+            size_t sub = level + 1;
+            while (sub + 1 < sizes.size() && pos % sizes[sub] != 0) {
+                sub++;
+            }
+            sub = std::min(sub, sizes.size() - 1);
+            if (!arrayInitLayout(son, sizes, sub, pos, vals, insts)) {
+                return false;
+            }
+            pos += sizes[sub];
+        } else {
+            ast_node * CHECK_NODE(item, son);
+            insts.addInst(item->blockInsts);
+            vals[pos++] = item->val;
         }
     }
-    
+
+    return true;
+}
+
+/// @brief 初始化列表按数组的维度展开，初值转换为数组的基本元素类型
+/// @param node 初始化列表节点
+/// @param type 数组类型
+/// @param dims 数组各维度
+/// @param vals 各元素位置的初值，未给出的为nullptr
+/// @param insts 初值表达式以及类型转换的指令追加到的指令序列
+/// @return 翻译是否成功，true：成功，false：失败
+bool IRGenerator::arrayInitValues(ast_node * node,
+                                  const Type * type,
+                                  std::vector<int32_t> & dims,
+                                  std::vector<Value *> & vals,
+                                  InterCode & insts)
+{
+    dims.clear();
+    while (type->isArrayType()) {
+        dims.push_back((int32_t) static_cast<const ArrayType *>(type)->getNumElements());
+        type = static_cast<const ArrayType *>(type)->getElementType();
+    }
+
+    // 各维度及以后的元素个数
+    std::vector<int32_t> sizes(dims.size() + 1, 1);
+    for (size_t k = dims.size(); k > 0; k--) {
+        sizes[k - 1] = sizes[k] * dims[k - 1];
+    }
+
+    vals.assign(sizes[0], nullptr);
+    if (!arrayInitLayout(node, sizes, 0, 0, vals, insts)) {
+        return false;
+    }
+
+    for (auto & val: vals) {
+        if (val) {
+            val = castValue(val, type, insts);
+        }
+    }
+
+    return true;
+}
+
+/// @brief 是否是值为0的常量，-0.0不算
+/// @param val 值
+/// @return true 是
+/// @return false 不是
+static bool isZeroConst(Value * val)
+{
+    if (Instanceof(constInt, ConstInt *, val)) {
+        return constInt->getVal() == 0;
+    }
+    if (Instanceof(constFloat, ConstFloat *, val)) {
+        return constFloat->getVal() == 0 && !std::signbit(constFloat->getVal());
+    }
+    return false;
+}
+
+/// @brief 全局变量初值表达式的指令在编译时逐条求值，整数运算按32位补码回绕，
+/// 除数为0、逻辑运算的跳转等不能求值的指令不在结果中
+/// @param insts 初值表达式的指令
+/// @param consts 指令对应的常量
+void IRGenerator::foldConstInit(InterCode & insts, std::unordered_map<Value *, Value *> & consts)
+{
+    for (auto inst: insts.getInsts()) {
+        Value * a = inst->getOperandsNum() > 0 ? constInitValue(inst->getOperand(0), consts) : nullptr;
+        Value * b = inst->getOperandsNum() > 1 ? constInitValue(inst->getOperand(1), consts) : nullptr;
+        Value * result = nullptr;
+
+        if (inst->getOp() == IRINST_OP_CAST && a) {
+            Instanceof(ia, ConstInt *, a);
+            float x = ia ? (float) ia->getVal() : static_cast<ConstFloat *>(a)->getVal();
+            switch (static_cast<CastInstruction *>(inst)->getCastType()) {
+                case CastInstruction::INT_TO_FLOAT:
+                    result = module->newConstFloat(x);
+                    break;
+                case CastInstruction::FLOAT_TO_INT:
+                    result = module->newConstInt(ia ? ia->getVal() : (int32_t) x);
+                    break;
+                default:
+                    result = module->newConstInt(ia ? ia->getVal() != 0 : x != 0);
+                    break;
+            }
+        } else if (inst->getOp() >= IRINST_OP_FADD && inst->getOp() <= IRINST_OP_FLE && a && b) {
+            float x = static_cast<ConstFloat *>(a)->getVal();
+            float y = static_cast<ConstFloat *>(b)->getVal();
+            switch (inst->getOp()) {
+                case IRINST_OP_FADD:
+                    result = module->newConstFloat(x + y);
+                    break;
+                case IRINST_OP_FSUB:
+                    result = module->newConstFloat(x - y);
+                    break;
+                case IRINST_OP_FMUL:
+                    result = module->newConstFloat(x * y);
+                    break;
+                case IRINST_OP_FDIV:
+                    result = module->newConstFloat(x / y);
+                    break;
+                case IRINST_OP_FMOD:
+                    result = module->newConstFloat(std::fmod(x, y));
+                    break;
+                case IRINST_OP_FEQ:
+                    result = module->newConstInt(x == y);
+                    break;
+                case IRINST_OP_FNE:
+                    result = module->newConstInt(x != y);
+                    break;
+                case IRINST_OP_FGT:
+                    result = module->newConstInt(x > y);
+                    break;
+                case IRINST_OP_FGE:
+                    result = module->newConstInt(x >= y);
+                    break;
+                case IRINST_OP_FLT:
+                    result = module->newConstInt(x < y);
+                    break;
+                default:
+                    result = module->newConstInt(x <= y);
+                    break;
+            }
+        } else if (inst->getOp() >= IRINST_OP_IADD && inst->getOp() <= IRINST_OP_XOR && a && b) {
+            int32_t x = static_cast<ConstInt *>(a)->getVal();
+            int32_t y = static_cast<ConstInt *>(b)->getVal();
+            switch (inst->getOp()) {
+                case IRINST_OP_IADD:
+                    result = module->newConstInt((int32_t) ((uint32_t) x + (uint32_t) y));
+                    break;
+                case IRINST_OP_ISUB:
+                    result = module->newConstInt((int32_t) ((uint32_t) x - (uint32_t) y));
+                    break;
+                case IRINST_OP_IMUL:
+                    result = module->newConstInt((int32_t) ((uint32_t) x * (uint32_t) y));
+                    break;
+                case IRINST_OP_IDIV:
+                case IRINST_OP_IMOD:
+                    if (y != 0 && !(x == INT32_MIN && y == -1)) {
+                        result = module->newConstInt(inst->getOp() == IRINST_OP_IDIV ? x / y : x % y);
+                    }
+                    break;
+                case IRINST_OP_IEQ:
+                    result = module->newConstInt(x == y);
+                    break;
+                case IRINST_OP_INE:
+                    result = module->newConstInt(x != y);
+                    break;
+                case IRINST_OP_IGT:
+                    result = module->newConstInt(x > y);
+                    break;
+                case IRINST_OP_ILE:
+                    result = module->newConstInt(x <= y);
+                    break;
+                case IRINST_OP_IGE:
+                    result = module->newConstInt(x >= y);
+                    break;
+                case IRINST_OP_ILT:
+                    result = module->newConstInt(x < y);
+                    break;
+                case IRINST_OP_XOR:
+                    result = module->newConstInt(x ^ y);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (result) {
+            consts[inst] = result;
+        }
+    }
+}
+
+/// @brief 全局变量的初值对应的常量，引用的全局变量取其初值
+/// @param val 初值
+/// @param consts foldConstInit得到的指令对应的常量
+/// @return 常量，不是常量表达式时为nullptr
+Value * IRGenerator::constInitValue(Value * val, const std::unordered_map<Value *, Value *> & consts)
+{
+    if (dynamic_cast<ConstInt *>(val) || dynamic_cast<ConstFloat *>(val)) {
+        return val;
+    }
+
+    // const局部变量的值就是其定义时的初值
+    auto local = varConsts.find(val);
+    if (local != varConsts.end()) {
+        return local->second;
+    }
+
+    // 全局变量在程序开始时的值就是其初值
+    Instanceof(global, GlobalVariable *, val);
+    if (global && !global->getType()->isArrayType()) {
+        if (global->getType()->isFloatType()) {
+            return module->newConstFloat(global->floatVal);
+        }
+        return module->newConstInt(global->intVal);
+    }
+
+    auto it = consts.find(val);
+    return it == consts.end() ? nullptr : it->second;
+}
+
+/// @brief 局部数组的初始化，先整体清零，再逐个存入不为0的初值
+/// @param node 初始化列表节点
+/// @param array 数组变量
+/// @param insts 初始化指令追加到的指令序列
+/// @return 翻译是否成功，true：成功，false：失败
+bool IRGenerator::localArrayInit(ast_node * node, Value * array, InterCode & insts)
+{
+    Function * func = module->getCurrentFunction();
+
+    std::vector<int32_t> dims;
+    std::vector<Value *> vals;
+    if (!arrayInitValues(node, array->getType(), dims, vals, insts)) {
+        return false;
+    }
+
+    // 有未给出或者为0的初值时整体清零，这些元素就不需要逐个存入
+    bool zeroed = false;
+    for (auto val: vals) {
+        zeroed = zeroed || !val || isZeroConst(val);
+    }
+    if (zeroed) {
+        insts.addInst(new MemsetInstruction(func, array, array->getType()->getSize()));
+    }
+
+    std::vector<int32_t> indices(dims.size());
+    for (int32_t pos = 0; pos < (int32_t) vals.size(); pos++) {
+        if (!vals[pos] || (zeroed && isZeroConst(vals[pos]))) {
+            continue;
+        }
+
+        // 元素位置分解为各维度的下标
+        for (int32_t k = (int32_t) dims.size() - 1, rest = pos; k >= 0; k--) {
+            indices[k] = rest % dims[k];
+            rest /= dims[k];
+        }
+
+        // 与数组元素访问一样按维度逐级计算地址
+        Value * ptr = array;
+        const Type * tp = array->getType();
+        for (auto index: indices) {
+            Instruction * gep =
+                new BinaryInstruction(func, IRINST_OP_GEP, ptr, module->newConstInt(index), (Type *) tp);
+            insts.addInst(gep);
+            ptr = gep;
+            tp = static_cast<const ArrayType *>(tp)->getElementType();
+        }
+        insts.addInst(new StoreInstruction(func, ptr, vals[pos]));
+    }
+
     return true;
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include "AST.h"
 #include "Module.h"
@@ -95,6 +96,52 @@ protected:
     /// @return 翻译是否成功，true：成功，false：失败
     bool ir_array_init(ast_node * node);
 
+    /// @brief 按花括号的嵌套把初始化列表中的初值放到对应的元素位置
+    /// @param node 初始化列表节点
+    /// @param sizes sizes[k]为第k维及以后各维的元素个数，最后一项为1
+    /// @param level 初始化列表对应的维度
+    /// @param pos 初始化列表的起始元素位置
+    /// @param vals 各元素位置的初值，未给出的为nullptr
+    /// @param insts 初值表达式的指令追加到的指令序列
+    /// @return 翻译是否成功，true：成功，false：失败
+    bool arrayInitLayout(ast_node * node,
+                         const std::vector<int32_t> & sizes,
+                         size_t level,
+                         int32_t pos,
+                         std::vector<Value *> & vals,
+                         InterCode & insts);
+
+    /// @brief 初始化列表按数组的维度展开，初值转换为数组的基本元素类型
+    /// @param node 初始化列表节点
+    /// @param type 数组类型
+    /// @param dims 数组各维度
+    /// @param vals 各元素位置的初值，未给出的为nullptr
+    /// @param insts 初值表达式以及类型转换的指令追加到的指令序列
+    /// @return 翻译是否成功，true：成功，false：失败
+    bool arrayInitValues(ast_node * node,
+                         const Type * type,
+                         std::vector<int32_t> & dims,
+                         std::vector<Value *> & vals,
+                         InterCode & insts);
+
+    /// @brief 局部数组的初始化翻译成线性中间IR
+    /// @param node 初始化列表节点
+    /// @param array 数组变量
+    /// @param insts 初始化指令追加到的指令序列
+    /// @return 翻译是否成功，true：成功，false：失败
+    bool localArrayInit(ast_node * node, Value * array, InterCode & insts);
+
+    /// @brief 全局变量初值表达式的指令在编译时逐条求值
+    /// @param insts 初值表达式的指令
+    /// @param consts 指令对应的常量，不能求值的指令不在其中
+    void foldConstInit(InterCode & insts, std::unordered_map<Value *, Value *> & consts);
+
+    /// @brief 全局变量的初值对应的常量，引用的全局变量取其初值
+    /// @param val 初值
+    /// @param consts foldConstInit得到的指令对应的常量
+    /// @return 常量，不是常量表达式时为nullptr
+    Value * constInitValue(Value * val, const std::unordered_map<Value *, Value *> & consts);
+
     bool ir_lval_to_r(ast_node * node);
 
     /// @brief 类型叶子节点翻译成线性中间IR
@@ -122,6 +169,11 @@ protected:
     /// @return 翻译是否成功，true：成功，false：失败
     bool ir_variable_declare(ast_node * node);
 
+    /// @brief 数组定义的各维度在编译时求值，确定数组的类型
+    /// @param child 变量定义节点
+    /// @return 翻译是否成功，true：成功，false：失败
+    bool arrayDefineType(ast_node * child);
+
     /// @brief 未知节点类型的节点处理
     /// @param node AST节点
     /// @return 翻译是否成功，true：成功，false：失败
@@ -139,6 +191,13 @@ protected:
 
     bool ir_jump(ast_node * node);
 
+    /// @brief 值隐式转换为指定类型，整数与浮点之间插入类型转换指令，常量直接转换
+    /// @param val 值
+    /// @param type 目标类型
+    /// @param insts 类型转换指令追加的指令序列
+    /// @return 转换后的值，不需要转换时为原值
+    Value * castValue(Value * val, const Type * type, InterCode & insts);
+
     /// @brief 根据AST的节点运算符查找对应的翻译函数并执行翻译动作
     /// @param node AST节点
     /// @return 成功返回node节点，否则返回nullptr
@@ -159,4 +218,7 @@ private:
 
     /// @brief 循环入口出口栈
     dbhead labs;
+
+    /// @brief 局部变量定义时的常量初值，数组维度等常量表达式中引用const变量时使用
+    std::unordered_map<Value *, Value *> varConsts;
 };
@@ -107,6 +107,15 @@ typedef enum IRInstOperator {
     /// @brief 载入指令
     IRINST_OP_LOAD,
 
+    /// @brief SSA形式的Phi指令，多目运算
+    IRINST_OP_PHI,
+
+    /// @brief 内存块清零指令
+    IRINST_OP_MEMSET,
+
+    /// @brief 取全局数组地址指令
+    IRINST_OP_ADDR,
+
     /* 后续可追加其他的IR指令 */
 
     /// @brief 最大指令码，也是无效指令
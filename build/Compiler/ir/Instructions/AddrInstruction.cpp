@@ -0,0 +1,38 @@
+///
+/// @file AddrInstruction.cpp
+/// @brief 取全局数组地址指令，使地址可以外提到循环外并保存在寄存器中
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-17
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-17 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "AddrInstruction.h"
+#include "PointerType.h"
+
+///
+/// @brief 构造函数
+/// @param _func 所属的函数
+/// @param global 全局数组
+///
+AddrInstruction::AddrInstruction(Function * _func, Value * global)
+    : Instruction(_func, IRINST_OP_ADDR, (Type *) PointerType::get(global->getType()))
+{
+    addOperand(global);
+}
+
+///
+/// @brief 转换成字符串
+/// @param str 字符串
+///
+void AddrInstruction::toString(std::string & str)
+{
+    str = getIRName() + " = addr " + getOperand(0)->getIRName();
+}
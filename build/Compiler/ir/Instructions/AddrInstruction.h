@@ -0,0 +1,41 @@
+///
+/// @file AddrInstruction.h
+/// @brief 取全局数组地址指令，使地址可以外提到循环外并保存在寄存器中
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-17
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-17 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <string>
+
+#include "Value.h"
+#include "Instruction.h"
+
+class Function;
+
+///
+/// @brief 取全局数组地址指令，操作数为全局数组，结果为其地址
+///
+class AddrInstruction : public Instruction {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _func 所属的函数
+    /// @param global 全局数组
+    ///
+    AddrInstruction(Function * _func, Value * global);
+
+    /// @brief 转换成字符串
+    void toString(std::string & str) override;
+};
@@ -49,10 +49,6 @@ void FuncCallInstruction::toString(std::string & str)
         }
     }
 
-    // TODO 这里应该根据函数名查找函数定义或者声明获取函数的类型
-    // 这里假定所有函数返回类型要么是i32，要么是void
-    // 函数参数的类型是i32
-
     if (type->isVoidType()) {
 
         // 函数没有返回值设置
@@ -60,7 +56,7 @@ void FuncCallInstruction::toString(std::string & str)
     } else {
 
         // 函数有返回值要设置到结果变量中
-        str = getIRName() + " = call i32 " + calledFunction->getIRName() + "(";
+        str = getIRName() + " = call " + type->toString() + " " + calledFunction->getIRName() + "(";
     }
 
     if (argCount == 0) {
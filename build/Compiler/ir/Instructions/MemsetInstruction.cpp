@@ -0,0 +1,39 @@
+///
+/// @file MemsetInstruction.cpp
+/// @brief 内存块清零指令，用于局部数组初始化时未给出初值的元素
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "MemsetInstruction.h"
+#include "VoidType.h"
+
+///
+/// @brief 构造函数
+/// @param _func 所属的函数
+/// @param ptr 内存块的起始地址
+/// @param _size 字节数
+///
+MemsetInstruction::MemsetInstruction(Function * _func, Value * ptr, int32_t _size)
+    : Instruction(_func, IRINST_OP_MEMSET, VoidType::getType()), size(_size)
+{
+    addOperand(ptr);
+}
+
+///
+/// @brief 转换成字符串
+/// @param str 字符串
+///
+void MemsetInstruction::toString(std::string & str)
+{
+    str = "memset ptr " + getOperand(0)->getIRName() + ", 0, " + std::to_string(size);
+}
@@ -0,0 +1,57 @@
+///
+/// @file MemsetInstruction.h
+/// @brief 内存块清零指令，用于局部数组初始化时未给出初值的元素
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <string>
+
+#include "Value.h"
+#include "Instruction.h"
+
+class Function;
+
+///
+/// @brief 内存块清零指令，操作数为数组的地址，字节数在指令内
+///
+class MemsetInstruction : public Instruction {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _func 所属的函数
+    /// @param ptr 内存块的起始地址
+    /// @param _size 字节数
+    ///
+    MemsetInstruction(Function * _func, Value * ptr, int32_t _size);
+
+    ///
+    /// @brief 获取清零的字节数
+    /// @return int32_t 字节数
+    ///
+    int32_t getSize() const
+    {
+        return size;
+    }
+
+    /// @brief 转换成字符串
+    void toString(std::string & str) override;
+
+private:
+    ///
+    /// @brief 字节数
+    ///
+    int32_t size;
+};
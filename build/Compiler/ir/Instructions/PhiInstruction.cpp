@@ -0,0 +1,100 @@
+///
+/// @file PhiInstruction.cpp
+/// @brief SSA形式的Phi指令
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "PhiInstruction.h"
+#include "BasicBlock.h"
+
+///
+/// @brief 构造函数
+/// @param _func 所属的函数
+/// @param _type 值的类型
+///
+PhiInstruction::PhiInstruction(Function * _func, Type * _type) : Instruction(_func, IRINST_OP_PHI, _type)
+{}
+
+///
+/// @brief 增加一个前驱基本块以及对应的值
+/// @param val 值
+/// @param block 前驱基本块
+///
+void PhiInstruction::addIncoming(Value * val, BasicBlock * block)
+{
+    addOperand(val);
+    blocks.push_back(block);
+}
+
+///
+/// @brief 删除指定位置的前驱基本块以及对应的值
+/// @param pos 位置
+///
+void PhiInstruction::removeIncoming(int32_t pos)
+{
+    if (pos < (int32_t) blocks.size()) {
+        removeOperand(pos);
+        blocks.erase(blocks.begin() + pos);
+    }
+}
+
+///
+/// @brief 获取前驱基本块的个数
+/// @return int32_t 个数
+///
+int32_t PhiInstruction::getIncomingCount()
+{
+    return (int32_t) blocks.size();
+}
+
+///
+/// @brief 获取指定位置的值
+/// @param pos 位置
+/// @return Value* 值
+///
+Value * PhiInstruction::getIncomingValue(int32_t pos)
+{
+    return getOperand(pos);
+}
+
+///
+/// @brief 获取指定位置的前驱基本块
+/// @param pos 位置
+/// @return BasicBlock* 前驱基本块
+///
+BasicBlock * PhiInstruction::getIncomingBlock(int32_t pos)
+{
+    return blocks[pos];
+}
+
+///
+/// @brief 修改指定位置的前驱基本块，用于拆分关键边等CFG变换
+/// @param pos 位置
+/// @param block 新的前驱基本块
+///
+void PhiInstruction::setIncomingBlock(int32_t pos, BasicBlock * block)
+{
+    blocks[pos] = block;
+}
+
+/// @brief 转换成字符串
+/// @param str 转换后的字符串
+void PhiInstruction::toString(std::string & str)
+{
+    str = getIRName() + " = phi " + getType()->toString();
+
+    for (int32_t k = 0; k < (int32_t) blocks.size(); k++) {
+
+        str += (k ? ", [" : " [") + getOperand(k)->getIRName() + ", " + blocks[k]->getName() + "]";
+    }
+}
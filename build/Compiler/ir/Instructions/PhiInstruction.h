@@ -0,0 +1,90 @@
+///
+/// @file PhiInstruction.h
+/// @brief SSA形式的Phi指令
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Instruction.h"
+
+class Function;
+class BasicBlock;
+
+///
+/// @brief Phi指令，位于基本块的开头（Label指令之后），按前驱基本块选择值
+///
+/// 操作数i为来自第i个前驱基本块的值
+///
+class PhiInstruction final : public Instruction {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _func 所属的函数
+    /// @param _type 值的类型
+    ///
+    PhiInstruction(Function * _func, Type * _type);
+
+    ///
+    /// @brief 增加一个前驱基本块以及对应的值
+    /// @param val 值
+    /// @param block 前驱基本块
+    ///
+    void addIncoming(Value * val, BasicBlock * block);
+
+    ///
+    /// @brief 删除指定位置的前驱基本块以及对应的值
+    /// @param pos 位置
+    ///
+    void removeIncoming(int32_t pos);
+
+    ///
+    /// @brief 获取前驱基本块的个数
+    /// @return int32_t 个数
+    ///
+    int32_t getIncomingCount();
+
+    ///
+    /// @brief 获取指定位置的值
+    /// @param pos 位置
+    /// @return Value* 值
+    ///
+    Value * getIncomingValue(int32_t pos);
+
+    ///
+    /// @brief 获取指定位置的前驱基本块
+    /// @param pos 位置
+    /// @return BasicBlock* 前驱基本块
+    ///
+    BasicBlock * getIncomingBlock(int32_t pos);
+
+    ///
+    /// @brief 修改指定位置的前驱基本块，用于拆分关键边等CFG变换
+    /// @param pos 位置
+    /// @param block 新的前驱基本块
+    ///
+    void setIncomingBlock(int32_t pos, BasicBlock * block);
+
+    /// @brief 转换成字符串
+    void toString(std::string & str) override;
+
+private:
+    ///
+    /// @brief 前驱基本块，与操作数一一对应
+    ///
+    std::vector<BasicBlock *> blocks;
+};
@@ -90,7 +90,7 @@ uint32_t ArrayType::getDimensionSize() {
 ArrayType* ArrayType::empty()
 {
     // 返回一个空的数组类型，用于表示维度待定的数组
-    // 元素类型为nullptr，大小为0，后续在IRGenerator中填充具体信息
-    static ArrayType* emptyArrayType = new ArrayType(nullptr, 0);
-    return emptyArrayType;
+    // 元素数量为0，声明时设置基本元素类型，维度在IRGenerator中计算。
+    // 每个数组定义各自一个，否则不同类型的数组会互相改写基本元素类型
+    return new ArrayType(nullptr, 0);
 }
@@ -29,7 +29,7 @@ class Value;
 /// Use可以跟踪每个Value的所有使用情况，并且当Value被修改或删除时，可以更新所有引用它的地方
 ///
 /// User和Use之间存在一个双向关系：
-/// User持有一个Use链表(成员uses)，每个Use指向一个Value
+/// User持有一个Use链表(成员operands)，每个Use指向一个Value
 /// Value持有一个User链表(成员uses)，每个User指向一个使用该Value的User对象
 ///
 class Use {
@@ -103,4 +103,10 @@ public:
     /// @brief 清除所有的操作数
     ///
     void clearOperands();
+
+protected:
+    ///
+    /// @brief 操作数，即本User使用其它Value的所有边。注意与Value::uses(被其它User使用的边)区分
+    ///
+    std::vector<Use *> operands;
 };
@@ -93,6 +93,29 @@ void Value::removeUse(Use * use)
     }
 }
 
+///
+/// @brief 获取define-use链，即该Value被使用的所有边
+/// @return std::vector<Use *>&
+///
+std::vector<Use *> & Value::getUseList()
+{
+    return uses;
+}
+
+///
+/// @brief 把所有使用该Value的地方替换成新的Value
+/// @param newVal 新的Value
+///
+void Value::replaceAllUseWith(Value * newVal)
+{
+    // setUsee会修改uses，因此这里先复制一份
+    std::vector<Use *> oldUses = uses;
+
+    for (auto use: oldUses) {
+        use->setUsee(newVal);
+    }
+}
+
 ///
 /// @brief 取得变量所在的作用域层级
 /// @return int32_t 层级
@@ -92,6 +92,18 @@ public:
     ///
     void removeUse(Use * use);
 
+    ///
+    /// @brief 获取define-use链，即该Value被使用的所有边
+    /// @return std::vector<Use *>&
+    ///
+    std::vector<Use *> & getUseList();
+
+    ///
+    /// @brief 把所有使用该Value的地方替换成新的Value
+    /// @param newVal 新的Value
+    ///
+    void replaceAllUseWith(Value * newVal);
+
     ///
     /// @brief 取得变量所在的作用域层级
     /// @return int32_t 层级
@@ -16,6 +16,8 @@
 ///
 #pragma once
 
+#include <vector>
+
 #include "GlobalValue.h"
 #include "IRConstant.h"
 
@@ -34,6 +36,7 @@ public:
     {
         // 设置对齐大小
         setAlignment(4);
+        intVal = 0;
     }
 
     ///
@@ -56,6 +59,15 @@ public:
         return this->inBSSSection;
     }
 
+    ///
+    /// @brief 设置是否属于BSS段
+    /// @param inBSS 初值全为0时为true
+    ///
+    void setInBSSSection(bool inBSS)
+    {
+        this->inBSSSection = inBSS;
+    }
+
     ///
     /// @brief 取得变量所在的作用域层级
     /// @return int32_t 层级
@@ -89,9 +101,21 @@ public:
     ///
     void toDeclareString(std::string & str)
     {
+        std::string init;
+        if (!getType()->isArrayType()) {
+            init = std::to_string(intVal);
+        } else if (inBSSSection) {
+            init = "zeroinitializer";
+        } else {
+            for (auto val: arrayInit) {
+                init += (init.empty() ? "[" : ", ") + (val ? val->getIRName() : std::string("0"));
+            }
+            init += "]";
+        }
+
         str = getIRName()
             +" dso_local global "+getType()->toString()
-            +" "+std::to_string(intVal)
+            +" "+init
             +", align "+std::to_string(alignment);
     }
 
@@ -99,6 +123,12 @@ public:
         int32_t intVal;
         float floatVal;
     };
+
+    ///
+    /// @brief 数组按元素顺序展开后的初值，都是常量，为0的元素是nullptr
+    ///
+    std::vector<Value *> arrayInit;
+
 private:
     ///
     /// @brief 变量加载到寄存器中时对应的寄存器编号
@@ -108,5 +138,5 @@ private:
     ///
     /// @brief 默认全局变量在BSS段，没有初始化，或者即使初始化过，但都值都为0
     ///
-    bool inBSSSection = false;
+    bool inBSSSection = true;
 };
@@ -28,6 +28,8 @@
 #include "IRGenerator.h"
 #include "Module.h"
 #include "CFG.h"
+#include "PassManager.h"
+#include "OutOfSSA.h"
 #include "getopt-port.h"
 
 ///
@@ -70,6 +72,15 @@ static bool gCFG = false;
 /// @brief 优化的级别，即-O后面的数字，默认为0
 static int gOptLevel = 0;
 
+/// @brief 是否通过-passes=指定了优化遍的序列，指定时忽略优化级别
+static bool gPassesGiven = false;
+
+/// @brief -passes=后面逗号分隔的优化遍名字
+static std::string gPasses;
+
+/// @brief 寄存器分配算法，linear为线性扫描，graph为图着色
+static std::string gRegAlloc = "linear";
+
 /// @brief 指定CPU目标架构，这里默认为ARM32
 static std::string gCPUTarget = "ARM64";
 
@@ -83,7 +94,7 @@ static std::string gOutputFile;
 /// @param exeName
 static void showHelp(const std::string & exeName)
 {
-    std::cout << exeName + " -S [-A | -D] [-T | -I] [-o output] source\n";
+    std::cout << exeName + " -S [-A | -D] [-T | -I] [-O level] [-passes=a,b,c] [-regalloc=linear|graph] [-o output] source\n";
 }
 
 /// @brief 参数解析与有效性检查
@@ -102,12 +113,17 @@ static int ArgsAnalysis(int argc, char * argv[])
     // -t要求必须带有目标CPU，指明目标CPU的汇编
     // -c选项在输出汇编时有效，附带输出IR指令内容
     // -g生成CFG图
+    // -passes=要求必须带有逗号分隔的优化遍名字，按给定的顺序执行，用于优化的调试
+    // -regalloc=要求必须带有寄存器分配算法，linear或graph，目前只对ARM64有效
     const char options[] = "ho:STIO:t:c:g";
+    const struct option longOptions[] = {{"passes", required_argument, nullptr, 'p'},
+                                         {"regalloc", required_argument, nullptr, 'r'},
+                                         {nullptr, 0, nullptr, 0}};
 
     opterr = 1;
 
 lb_check:
-    while ((ch = getopt(argc, argv, options)) != -1) {
+    while ((ch = getopt_long_only(argc, argv, options, longOptions, nullptr)) != -1) {
         switch (ch) {
             case 'h':
                 gShowHelp = true;
@@ -130,7 +146,7 @@ lb_check:
                 break;
                 break;
             case 'O':
-                // 优化级别分析，暂时没有用，如开启优化时请使用
+                // 优化级别分析，大于0时开启优化
                 gOptLevel = std::stoi(optarg);
                 break;
             case 't':
@@ -142,6 +158,16 @@ lb_check:
             case 'g':
                 gCFG = true;
                 break;
+            case 'p':
+                gPassesGiven = true;
+                gPasses = optarg;
+                break;
+            case 'r':
+                gRegAlloc = optarg;
+                if (gRegAlloc != "linear" && gRegAlloc != "graph") {
+                    return -1;
+                }
+                break;
             default:
                 return -1;
                 break; /* no break */
@@ -227,7 +253,7 @@ static int compile(std::string inputFile, std::string outputFile)
         // 编译过程主要包括：
         // 1）词法语法分析生成AST
         // 2) 遍历AST生成线性IR
-        // 3) 对线性IR进行优化：目前不支持
+        // 3) 对线性IR进行优化：由PassManager调度
         // 4) 把线性IR转换成汇编
 
         // 创建词法语法分析器
@@ -285,6 +311,19 @@ static int compile(std::string inputFile, std::string outputFile)
         // 清理抽象语法树
         free_ast(astRoot);
 
+        // 中间代码优化，遍的序列由-passes=指定或者由优化级别确定
+        PassManager passManager(module, gOptLevel);
+        if (gPassesGiven) {
+            std::string badName;
+            if (!passManager.parsePipeline(gPasses, badName)) {
+                minic_log(LOG_ERROR, "未知的优化遍(%s)", badName.c_str());
+                break;
+            }
+        } else {
+            passManager.buildPipeline(gOptLevel);
+        }
+        passManager.run();
+
         if (gShowLineIR) {
 
             // 对IR的名字重命名
@@ -312,14 +351,22 @@ static int compile(std::string inputFile, std::string outputFile)
             break;
         }
 
+        // 后端不能处理Phi指令，指令选择前要进行SSA析构
+        if (!passManager.empty()) {
+            OutOfSSA(module).run();
+        }
+
+        // 后端处理的是线性IR指令序列，基本块内的指令按顺序放回
+        for (auto func: module->getFunctionList()) {
+            func->linearizeBlocks();
+        }
+
         // 要使得汇编能输出IR指令作为注释，必须对IR的名字进行命名，否则为空值
         if (gAsmAlsoShowIR) {
             // 对IR的名字重命名
             module->renameIR();
         }
 
-        // 这里可追加中间代码优化，体系结果无关的优化等
-
         // 后端处理，体系结果相关的操作
         // 这里提供一种面向ARM32的汇编产生器CodeGeneratorArm32作为参考
         // 需要时可根据需要修改或追加新的目标体系架构
@@ -330,7 +377,9 @@ static int compile(std::string inputFile, std::string outputFile)
             if (gCPUTarget == "ARM32") {
                 generator = new CodeGeneratorArm32(module);
             } else if (gCPUTarget == "ARM64") {
-                generator = new CodeGeneratorArm64(module);
+                CodeGeneratorArm64 * arm64Generator = new CodeGeneratorArm64(module);
+                arm64Generator->setGraphColoring(gRegAlloc == "graph");
+                generator = arm64Generator;
             } else {
                 // 不支持指定的CPU架构
                 minic_log(LOG_ERROR, "指定的目标CPU架构(%s)不支持", gCPUTarget.c_str());
@@ -0,0 +1,78 @@
+///
+/// @file AnalysisManager.cpp
+/// @brief 函数级分析结果的缓存
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "AnalysisManager.h"
+
+///
+/// @brief 获取函数的支配树
+/// @param func 函数，要求已经划分了基本块
+/// @return DominatorTree& 支配树
+///
+DominatorTree & AnalysisManager::getDomTree(Function * func)
+{
+    auto & result = results[func];
+    if (!result.domTree) {
+        result.domTree.reset(new DominatorTree(func));
+    }
+    return *result.domTree;
+}
+
+///
+/// @brief 获取函数的后支配树
+/// @param func 函数，要求已经划分了基本块
+/// @return DominatorTree& 后支配树
+///
+DominatorTree & AnalysisManager::getPostDomTree(Function * func)
+{
+    auto & result = results[func];
+    if (!result.postDomTree) {
+        result.postDomTree.reset(new DominatorTree(func, true));
+    }
+    return *result.postDomTree;
+}
+
+///
+/// @brief 获取函数的循环分析结果
+/// @param func 函数，要求已经划分了基本块
+/// @return LoopInfo& 循环分析结果
+///
+LoopInfo & AnalysisManager::getLoopInfo(Function * func)
+{
+    DominatorTree & domTree = getDomTree(func);
+
+    auto & result = results[func];
+    if (!result.loopInfo) {
+        result.loopInfo.reset(new LoopInfo(func, domTree));
+    }
+    return *result.loopInfo;
+}
+
+///
+/// @brief 使函数的全部分析结果失效
+/// @param func 函数
+///
+void AnalysisManager::invalidate(Function * func)
+{
+    results.erase(func);
+}
+
+///
+/// @brief 使全部函数的分析结果失效
+///
+void AnalysisManager::clear()
+{
+    results.clear();
+}
@@ -0,0 +1,88 @@
+///
+/// @file AnalysisManager.h
+/// @brief 函数级分析结果的缓存
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "DominatorTree.h"
+#include "LoopInfo.h"
+
+class Function;
+
+///
+/// @brief 分析管理器，按函数缓存支配树、后支配树以及循环分析的结果
+///
+/// 分析在第一次请求时计算。改变了函数控制流图的变换必须调用invalidate使缓存失效，
+/// 只改变基本块内指令的变换不影响这些分析的结果。
+///
+class AnalysisManager {
+
+public:
+    ///
+    /// @brief 获取函数的支配树
+    /// @param func 函数，要求已经划分了基本块
+    /// @return DominatorTree& 支配树
+    ///
+    DominatorTree & getDomTree(Function * func);
+
+    ///
+    /// @brief 获取函数的后支配树
+    /// @param func 函数，要求已经划分了基本块
+    /// @return DominatorTree& 后支配树
+    ///
+    DominatorTree & getPostDomTree(Function * func);
+
+    ///
+    /// @brief 获取函数的循环分析结果
+    /// @param func 函数，要求已经划分了基本块
+    /// @return LoopInfo& 循环分析结果
+    ///
+    LoopInfo & getLoopInfo(Function * func);
+
+    ///
+    /// @brief 使函数的全部分析结果失效
+    /// @param func 函数
+    ///
+    void invalidate(Function * func);
+
+    ///
+    /// @brief 使全部函数的分析结果失效
+    ///
+    void clear();
+
+private:
+    ///
+    /// @brief 一个函数的分析结果
+    ///
+    struct Results {
+
+        /// @brief 支配树
+        std::unique_ptr<DominatorTree> domTree;
+
+        /// @brief 后支配树
+        std::unique_ptr<DominatorTree> postDomTree;
+
+        /// @brief 循环分析，依赖支配树
+        std::unique_ptr<LoopInfo> loopInfo;
+    };
+
+    ///
+    /// @brief 各函数的分析结果
+    ///
+    std::unordered_map<Function *, Results> results;
+};
@@ -0,0 +1,339 @@
+///
+/// @file DominatorTree.cpp
+/// @brief 支配树与后支配树分析
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <utility>
+
+#include "DominatorTree.h"
+#include "Function.h"
+#include "BasicBlock.h"
+
+///
+/// @brief 构造函数，计算支配树
+/// @param _func 函数，要求已经划分了基本块
+/// @param _post true表示计算后支配树，根为含出口指令的基本块
+///
+DominatorTree::DominatorTree(Function * _func, bool _post) : func(_func), post(_post)
+{
+    auto & blocks = func->getBlocks();
+    nodes.resize(blocks.size());
+
+    if (blocks.empty()) {
+        return;
+    }
+
+    if (!post) {
+        root = blocks.front();
+    } else {
+        for (auto block: blocks) {
+            Instruction * last = block->getTerminator();
+            if (last && last->getOp() == IRINST_OP_EXIT) {
+                root = block;
+                break;
+            }
+        }
+        if (!root) {
+            return;
+        }
+    }
+
+    computeIDoms();
+    numberTree();
+    computeFrontiers();
+}
+
+///
+/// @brief 是否是后支配树
+/// @return true 后支配树
+/// @return false 支配树
+///
+bool DominatorTree::isPostDom() const
+{
+    return post;
+}
+
+///
+/// @brief 获取树根，即入口基本块或出口基本块
+/// @return BasicBlock* 树根
+///
+BasicBlock * DominatorTree::getRoot()
+{
+    return root;
+}
+
+///
+/// @brief 获取直接支配者
+/// @param block 基本块
+/// @return BasicBlock* 直接支配者，树根以及不在树中的基本块返回nullptr
+///
+BasicBlock * DominatorTree::getIDom(BasicBlock * block)
+{
+    return block == root ? nullptr : nodes[block->getIndex()].idom;
+}
+
+///
+/// @brief 获取支配树中的孩子
+/// @param block 基本块
+/// @return std::vector<BasicBlock *>& 直接支配的基本块
+///
+std::vector<BasicBlock *> & DominatorTree::getChildren(BasicBlock * block)
+{
+    return nodes[block->getIndex()].children;
+}
+
+///
+/// @brief 获取支配边界，后支配树时为后支配边界
+/// @param block 基本块
+/// @return std::vector<BasicBlock *>& 支配边界
+///
+std::vector<BasicBlock *> & DominatorTree::getFrontier(BasicBlock * block)
+{
+    return nodes[block->getIndex()].frontier;
+}
+
+///
+/// @brief 基本块是否在树中，即从树根可达
+/// @param block 基本块
+/// @return true 在树中
+/// @return false 不在树中
+///
+bool DominatorTree::contains(BasicBlock * block)
+{
+    return nodes[block->getIndex()].order >= 0;
+}
+
+///
+/// @brief a是否支配b（后支配树时为a是否后支配b），基本块支配自身
+/// @param a 基本块
+/// @param b 基本块
+/// @return true 支配
+/// @return false 不支配
+///
+bool DominatorTree::dominates(BasicBlock * a, BasicBlock * b)
+{
+    Node & na = nodes[a->getIndex()];
+    Node & nb = nodes[b->getIndex()];
+
+    // 不在树中的基本块认为被任何基本块支配
+    if (nb.order < 0) {
+        return true;
+    }
+    if (na.order < 0) {
+        return false;
+    }
+
+    return na.in <= nb.in && nb.out <= na.out;
+}
+
+///
+/// @brief a是否严格支配b
+/// @param a 基本块
+/// @param b 基本块
+/// @return true 严格支配
+/// @return false 不严格支配
+///
+bool DominatorTree::properlyDominates(BasicBlock * a, BasicBlock * b)
+{
+    return a != b && dominates(a, b);
+}
+
+///
+/// @brief 获取基本块在支配树中的深度，树根为0
+/// @param block 基本块
+/// @return int32_t 深度，不在树中时为-1
+///
+int32_t DominatorTree::getLevel(BasicBlock * block)
+{
+    return nodes[block->getIndex()].level;
+}
+
+///
+/// @brief 获取支配树的先序遍历序列，父节点总在子节点之前
+/// @return std::vector<BasicBlock *>& 先序序列
+///
+std::vector<BasicBlock *> & DominatorTree::getPreOrder()
+{
+    return preOrder;
+}
+
+///
+/// @brief 获取两个基本块最近的公共支配者
+/// @param a 基本块
+/// @param b 基本块
+/// @return BasicBlock* 最近公共支配者
+///
+BasicBlock * DominatorTree::findNearestCommonDominator(BasicBlock * a, BasicBlock * b)
+{
+    while (nodes[a->getIndex()].level > nodes[b->getIndex()].level) {
+        a = nodes[a->getIndex()].idom;
+    }
+    while (nodes[b->getIndex()].level > nodes[a->getIndex()].level) {
+        b = nodes[b->getIndex()].idom;
+    }
+    while (a != b) {
+        a = nodes[a->getIndex()].idom;
+        b = nodes[b->getIndex()].idom;
+    }
+    return a;
+}
+
+///
+/// @brief 沿分析方向的后继，后支配树时为前驱
+/// @param block 基本块
+/// @return std::vector<BasicBlock *>& 后继
+///
+std::vector<BasicBlock *> & DominatorTree::forward(BasicBlock * block)
+{
+    return post ? block->getPreds() : block->getSuccs();
+}
+
+///
+/// @brief 沿分析方向的前驱，后支配树时为后继
+/// @param block 基本块
+/// @return std::vector<BasicBlock *>& 前驱
+///
+std::vector<BasicBlock *> & DominatorTree::backward(BasicBlock * block)
+{
+    return post ? block->getSuccs() : block->getPreds();
+}
+
+///
+/// @brief 计算直接支配者
+///
+void DominatorTree::computeIDoms()
+{
+    // 沿分析方向深度优先遍历求后序，非递归实现，避免基本块过多时栈溢出
+    std::vector<bool> visited(nodes.size(), false);
+    std::vector<std::pair<BasicBlock *, size_t>> stack;
+
+    stack.emplace_back(root, 0);
+    visited[root->getIndex()] = true;
+    while (!stack.empty()) {
+        auto & top = stack.back();
+        auto & succs = forward(top.first);
+        if (top.second < succs.size()) {
+            BasicBlock * succ = succs[top.second++];
+            if (!visited[succ->getIndex()]) {
+                visited[succ->getIndex()] = true;
+                stack.emplace_back(succ, 0);
+            }
+        } else {
+            order.push_back(top.first);
+            stack.pop_back();
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    for (int32_t k = 0; k < (int32_t) order.size(); k++) {
+        nodes[order[k]->getIndex()].order = k;
+    }
+
+    // Cooper-Harvey-Kennedy迭代算法计算直接支配者
+    nodes[root->getIndex()].idom = root;
+
+    auto intersect = [this](BasicBlock * b1, BasicBlock * b2) {
+        while (b1 != b2) {
+            while (nodes[b1->getIndex()].order > nodes[b2->getIndex()].order) {
+                b1 = nodes[b1->getIndex()].idom;
+            }
+            while (nodes[b2->getIndex()].order > nodes[b1->getIndex()].order) {
+                b2 = nodes[b2->getIndex()].idom;
+            }
+        }
+        return b1;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t k = 1; k < order.size(); k++) {
+            BasicBlock * block = order[k];
+            BasicBlock * newIdom = nullptr;
+            for (auto pred: backward(block)) {
+                if (!nodes[pred->getIndex()].idom) {
+                    continue;
+                }
+                newIdom = newIdom ? intersect(pred, newIdom) : pred;
+            }
+            if (nodes[block->getIndex()].idom != newIdom) {
+                nodes[block->getIndex()].idom = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    for (size_t k = 1; k < order.size(); k++) {
+        BasicBlock * block = order[k];
+        nodes[nodes[block->getIndex()].idom->getIndex()].children.push_back(block);
+    }
+}
+
+///
+/// @brief 先序遍历支配树，计算进入退出编号与深度
+///
+void DominatorTree::numberTree()
+{
+    int32_t counter = 0;
+    std::vector<std::pair<BasicBlock *, size_t>> stack;
+
+    stack.emplace_back(root, 0);
+    nodes[root->getIndex()].in = counter++;
+    nodes[root->getIndex()].level = 0;
+    preOrder.push_back(root);
+
+    while (!stack.empty()) {
+        auto & top = stack.back();
+        Node & node = nodes[top.first->getIndex()];
+        if (top.second < node.children.size()) {
+            BasicBlock * child = node.children[top.second++];
+            Node & childNode = nodes[child->getIndex()];
+            childNode.in = counter++;
+            childNode.level = node.level + 1;
+            preOrder.push_back(child);
+            stack.emplace_back(child, 0);
+        } else {
+            node.out = counter++;
+            stack.pop_back();
+        }
+    }
+}
+
+///
+/// @brief 计算支配边界
+///
+void DominatorTree::computeFrontiers()
+{
+    for (auto block: order) {
+        auto & preds = backward(block);
+        if (preds.size() < 2) {
+            continue;
+        }
+        BasicBlock * idom = nodes[block->getIndex()].idom;
+        for (auto pred: preds) {
+            if (nodes[pred->getIndex()].order < 0) {
+                continue;
+            }
+            BasicBlock * runner = pred;
+            while (runner != idom) {
+                auto & frontier = nodes[runner->getIndex()].frontier;
+                if (frontier.empty() || frontier.back() != block) {
+                    frontier.push_back(block);
+                }
+                runner = nodes[runner->getIndex()].idom;
+            }
+        }
+    }
+}
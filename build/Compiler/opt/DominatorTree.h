@@ -0,0 +1,206 @@
+///
+/// @file DominatorTree.h
+/// @brief 支配树与后支配树分析
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Function;
+class BasicBlock;
+
+///
+/// @brief 支配树，也可在反向控制流图上计算得到后支配树
+///
+/// 采用Cooper-Harvey-Kennedy迭代算法，按逆后序迭代求直接支配者。
+/// 支配关系的查询借助支配树先序遍历的进入、退出编号在常数时间内完成。
+/// 基本块按Function维护的编号索引，CFG改变后分析结果失效，需要重新计算。
+///
+class DominatorTree {
+
+public:
+    ///
+    /// @brief 构造函数，计算支配树
+    /// @param _func 函数，要求已经划分了基本块
+    /// @param _post true表示计算后支配树，根为含出口指令的基本块
+    ///
+    explicit DominatorTree(Function * _func, bool _post = false);
+
+    ///
+    /// @brief 是否是后支配树
+    /// @return true 后支配树
+    /// @return false 支配树
+    ///
+    bool isPostDom() const;
+
+    ///
+    /// @brief 获取树根，即入口基本块或出口基本块
+    /// @return BasicBlock* 树根
+    ///
+    BasicBlock * getRoot();
+
+    ///
+    /// @brief 获取直接支配者
+    /// @param block 基本块
+    /// @return BasicBlock* 直接支配者，树根以及不在树中的基本块返回nullptr
+    ///
+    BasicBlock * getIDom(BasicBlock * block);
+
+    ///
+    /// @brief 获取支配树中的孩子
+    /// @param block 基本块
+    /// @return std::vector<BasicBlock *>& 直接支配的基本块
+    ///
+    std::vector<BasicBlock *> & getChildren(BasicBlock * block);
+
+    ///
+    /// @brief 获取支配边界，后支配树时为后支配边界
+    /// @param block 基本块
+    /// @return std::vector<BasicBlock *>& 支配边界
+    ///
+    std::vector<BasicBlock *> & getFrontier(BasicBlock * block);
+
+    ///
+    /// @brief 基本块是否在树中，即从树根可达
+    /// @param block 基本块
+    /// @return true 在树中
+    /// @return false 不在树中
+    ///
+    bool contains(BasicBlock * block);
+
+    ///
+    /// @brief a是否支配b（后支配树时为a是否后支配b），基本块支配自身
+    /// @param a 基本块
+    /// @param b 基本块
+    /// @return true 支配
+    /// @return false 不支配
+    ///
+    bool dominates(BasicBlock * a, BasicBlock * b);
+
+    ///
+    /// @brief a是否严格支配b
+    /// @param a 基本块
+    /// @param b 基本块
+    /// @return true 严格支配
+    /// @return false 不严格支配
+    ///
+    bool properlyDominates(BasicBlock * a, BasicBlock * b);
+
+    ///
+    /// @brief 获取基本块在支配树中的深度，树根为0
+    /// @param block 基本块
+    /// @return int32_t 深度，不在树中时为-1
+    ///
+    int32_t getLevel(BasicBlock * block);
+
+    ///
+    /// @brief 获取支配树的先序遍历序列，父节点总在子节点之前
+    /// @return std::vector<BasicBlock *>& 先序序列
+    ///
+    std::vector<BasicBlock *> & getPreOrder();
+
+    ///
+    /// @brief 获取两个基本块最近的公共支配者
+    /// @param a 基本块
+    /// @param b 基本块
+    /// @return BasicBlock* 最近公共支配者
+    ///
+    BasicBlock * findNearestCommonDominator(BasicBlock * a, BasicBlock * b);
+
+private:
+    ///
+    /// @brief 基本块在树中的信息，按基本块编号索引
+    ///
+    struct Node {
+
+        /// @brief 直接支配者
+        BasicBlock * idom = nullptr;
+
+        /// @brief 孩子
+        std::vector<BasicBlock *> children;
+
+        /// @brief 支配边界
+        std::vector<BasicBlock *> frontier;
+
+        /// @brief 计算用的遍历序号，逆后序编号，-1表示不在树中
+        int32_t order = -1;
+
+        /// @brief 支配树先序遍历的进入与退出编号
+        int32_t in = -1, out = -1;
+
+        /// @brief 深度
+        int32_t level = -1;
+    };
+
+    ///
+    /// @brief 沿分析方向的后继，后支配树时为前驱
+    /// @param block 基本块
+    /// @return std::vector<BasicBlock *>& 后继
+    ///
+    std::vector<BasicBlock *> & forward(BasicBlock * block);
+
+    ///
+    /// @brief 沿分析方向的前驱，后支配树时为后继
+    /// @param block 基本块
+    /// @return std::vector<BasicBlock *>& 前驱
+    ///
+    std::vector<BasicBlock *> & backward(BasicBlock * block);
+
+    ///
+    /// @brief 计算直接支配者
+    ///
+    void computeIDoms();
+
+    ///
+    /// @brief 先序遍历支配树，计算进入退出编号与深度
+    ///
+    void numberTree();
+
+    ///
+    /// @brief 计算支配边界
+    ///
+    void computeFrontiers();
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func;
+
+    ///
+    /// @brief 是否是后支配树
+    ///
+    bool post;
+
+    ///
+    /// @brief 树根
+    ///
+    BasicBlock * root = nullptr;
+
+    ///
+    /// @brief 树节点信息，按基本块编号索引
+    ///
+    std::vector<Node> nodes;
+
+    ///
+    /// @brief 沿分析方向的逆后序
+    ///
+    std::vector<BasicBlock *> order;
+
+    ///
+    /// @brief 支配树先序序列
+    ///
+    std::vector<BasicBlock *> preOrder;
+};
@@ -0,0 +1,203 @@
+///
+/// @file GVN.cpp
+/// @brief 基于支配树的全局值编号
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <utility>
+
+#include "GVN.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "DominatorTree.h"
+#include "AnalysisManager.h"
+#include "BinaryInstruction.h"
+#include "CastInstruction.h"
+#include "Constant.h"
+#include "GlobalValue.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+GVN::GVN(Module * _module) : FunctionPass(_module)
+{}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string GVN::getName() const
+{
+    return "gvn";
+}
+
+///
+/// @brief 只删除指令，不改变控制流图
+/// @return true 控制流图不变
+///
+bool GVN::preservesCFG() const
+{
+    return true;
+}
+
+///
+/// @brief 操作数在函数内是否总是同一个值
+/// @param val 操作数
+/// @return true 值不变
+/// @return false 可能被赋值或者被别的函数改变
+///
+bool GVN::isInvariant(Value * val)
+{
+    // 全局变量只有数组的地址不变，标量的值可能被任意函数改变
+    if (dynamic_cast<GlobalValue *>(val)) {
+        return val->getType()->isArrayType();
+    }
+
+    if (dynamic_cast<Constant *>(val)) {
+        return true;
+    }
+
+    // 指令的结果只定义一次，未提升的局部变量与形参只要没有被赋值过
+    return assigned.find(val) == assigned.end();
+}
+
+///
+/// @brief 计算指令的键
+/// @param inst 指令
+/// @param key 返回的键
+/// @return true 指令可以参与编号
+/// @return false 指令不参与编号
+///
+bool GVN::makeKey(Instruction * inst, Key & key)
+{
+    // 布尔值由比较产生，后端依赖条件标志，必须紧挨着使用者，不能复用
+    if (inst->getType()->isInt1Byte()) {
+        return false;
+    }
+
+    for (int32_t k = 0; k < inst->getOperandsNum(); k++) {
+        if (!isInvariant(inst->getOperand(k))) {
+            return false;
+        }
+    }
+
+    Instanceof(castInst, CastInstruction *, inst);
+    if (castInst) {
+        key = Key(inst->getOp(), inst->getOperand(0), nullptr, inst->getType(), castInst->getCastType());
+        return true;
+    }
+
+    Instanceof(binInst, BinaryInstruction *, inst);
+    if (!binInst) {
+        return false;
+    }
+
+    Value * lhs = inst->getOperand(0);
+    Value * rhs = inst->getOperand(1);
+
+    switch (inst->getOp()) {
+        case IROP(IADD):
+        case IROP(IMUL):
+        case IROP(FADD):
+        case IROP(FMUL):
+        case IROP(XOR):
+            // 可交换的运算，操作数按地址排序后a+b与b+a编号相同
+            if (rhs < lhs) {
+                std::swap(lhs, rhs);
+            }
+            break;
+        default:
+            break;
+    }
+
+    key = Key(inst->getOp(), lhs, rhs, inst->getType(), -1);
+
+    return true;
+}
+
+///
+/// @brief 对一个函数进行全局值编号
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool GVN::runOnFunction(Function * func, AnalysisManager & am)
+{
+    DominatorTree & domTree = am.getDomTree(func);
+
+    table.clear();
+    instBlock.clear();
+    assigned.clear();
+
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            if (inst->getOp() == IROP(ASSIGN)) {
+                assigned.insert(inst->getOperand(0));
+            }
+        }
+    }
+
+    std::vector<Instruction *> deadInsts;
+
+    // 先序遍历支配树，支配者上的指令总是先于被支配者上的指令编号，
+    // 前面指令的使用已被替换，后面指令的键中的操作数都是代表值
+    for (auto block: domTree.getPreOrder()) {
+        auto & insts = block->getInsts();
+        std::vector<Instruction *> newInsts;
+
+        for (auto inst: insts) {
+            Key key;
+            if (!makeKey(inst, key)) {
+                newInsts.push_back(inst);
+                continue;
+            }
+
+            // 键相同的指令中找到支配当前基本块的那个
+            Instruction * leader = nullptr;
+            auto & candidates = table[key];
+            for (auto cand: candidates) {
+                if (domTree.dominates(instBlock[cand], block)) {
+                    leader = cand;
+                    break;
+                }
+            }
+
+            if (leader) {
+                inst->replaceAllUseWith(leader);
+                deadInsts.push_back(inst);
+                continue;
+            }
+
+            candidates.push_back(inst);
+            instBlock[inst] = block;
+            newInsts.push_back(inst);
+        }
+
+        insts.swap(newInsts);
+    }
+
+    for (auto inst: deadInsts) {
+        inst->clearOperands();
+    }
+    for (auto inst: deadInsts) {
+        delete inst;
+    }
+
+    table.clear();
+    instBlock.clear();
+    assigned.clear();
+
+    return !deadInsts.empty();
+}
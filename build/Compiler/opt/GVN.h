@@ -0,0 +1,109 @@
+///
+/// @file GVN.h
+/// @brief 基于支配树的全局值编号
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "Pass.h"
+
+class Instruction;
+class BasicBlock;
+class Value;
+class Type;
+
+///
+/// @brief 基于支配树的全局值编号(GVN)
+///
+/// 按支配树的先序遍历指令，以运算符、操作数、类型以及类型转换的种类作为键进行哈希合并，
+/// 键相同且定义所在位置支配当前指令的计算是冗余的，其全部使用替换为支配它的那个值后删除。
+/// 只处理二元运算、数组元素寻址(GEP)以及类型转换指令。合并后作为多处寻址公共前缀的GEP，
+/// 后端把其地址保存在寄存器中，如c[i][j] = c[i][j] + c[i][k]中c[i]的地址只计算一次。
+/// 结果为布尔值的比较与转换要紧挨着后面的条件跳转或cset指令，不参与编号。
+/// 操作数中有被赋值的变量或者全局标量时，同名的值不一定相同，也不参与编号。
+///
+class GVN : public FunctionPass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit GVN(Module * _module);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对一个函数进行全局值编号
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func, AnalysisManager & am) override;
+
+    ///
+    /// @brief 只删除指令，不改变控制流图
+    /// @return true 控制流图不变
+    ///
+    bool preservesCFG() const override;
+
+private:
+    ///
+    /// @brief 值编号的键：运算符、两个操作数、结果类型、类型转换的种类
+    ///
+    using Key = std::tuple<int32_t, Value *, Value *, Type *, int32_t>;
+
+    ///
+    /// @brief 计算指令的键
+    /// @param inst 指令
+    /// @param key 返回的键
+    /// @return true 指令可以参与编号
+    /// @return false 指令不参与编号
+    ///
+    bool makeKey(Instruction * inst, Key & key);
+
+    ///
+    /// @brief 操作数在函数内是否总是同一个值
+    /// @param val 操作数
+    /// @return true 值不变
+    /// @return false 可能被赋值或者被别的函数改变
+    ///
+    bool isInvariant(Value * val);
+
+    ///
+    /// @brief 键相同的指令，按支配树先序的遍历次序排列
+    ///
+    std::map<Key, std::vector<Instruction *>> table;
+
+    ///
+    /// @brief 参与编号的指令所在的基本块
+    ///
+    std::map<Instruction *, BasicBlock *> instBlock;
+
+    ///
+    /// @brief 函数内作为赋值目标的变量
+    ///
+    std::set<Value *> assigned;
+};
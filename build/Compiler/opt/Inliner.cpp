@@ -0,0 +1,465 @@
+///
+/// @file Inliner.cpp
+/// @brief 函数内联
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <set>
+
+#include "Inliner.h"
+#include "InstCloner.h"
+#include "Module.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "ConstInt.h"
+#include "FormalParam.h"
+#include "GlobalValue.h"
+#include "LocalVariable.h"
+#include "FuncCallInstruction.h"
+#include "GotoInstruction.h"
+#include "LabelInstruction.h"
+#include "MoveInstruction.h"
+#include "PhiInstruction.h"
+
+/// @brief 调用者内联后的指令条数上限，避免代码膨胀
+static const int32_t MAX_CALLER_SIZE = 2000;
+
+///
+/// @brief 是否是全局标量，其值可能被任意函数改变
+/// @param val 值
+/// @return true 全局标量
+/// @return false 不是
+///
+static bool isGlobalScalar(Value * val)
+{
+    return dynamic_cast<GlobalValue *>(val) && !val->getType()->isArrayType() && !val->getType()->isFunctionType();
+}
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+/// @param level 优化级别，决定内联的阈值
+///
+Inliner::Inliner(Module * _module, int32_t level) : ModulePass(_module)
+{
+    if (level <= 1) {
+        threshold = 15;
+    } else if (level == 2) {
+        threshold = 60;
+    } else {
+        threshold = 150;
+    }
+}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string Inliner::getName() const
+{
+    return "inline";
+}
+
+///
+/// @brief 对模块进行函数内联
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool Inliner::runOnModule(AnalysisManager & am)
+{
+    (void) am;
+
+    callees.clear();
+    for (auto func: module->getFunctionList()) {
+        if (func->isBuiltin()) {
+            continue;
+        }
+
+        func->buildBlocks();
+
+        auto & funcCallees = callees[func];
+        for (auto block: func->getBlocks()) {
+            for (auto inst: block->getInsts()) {
+                Instanceof(call, FuncCallInstruction *, inst);
+                if (call && !call->calledFunction->isBuiltin()) {
+                    funcCallees.push_back(call->calledFunction);
+                }
+            }
+        }
+    }
+
+    computeSCCs();
+
+    bool changed = false;
+
+    // 被调用者在前，内联到调用者的总是已经完成内联的函数体
+    for (auto caller: order) {
+        std::set<Instruction *> rejected;
+        bool inlined = false;
+
+        for (;;) {
+            // 每次内联都会改变基本块，重新查找调用点
+            BasicBlock * siteBlock = nullptr;
+            FuncCallInstruction * site = nullptr;
+            for (auto block: caller->getBlocks()) {
+                for (auto inst: block->getInsts()) {
+                    Instanceof(call, FuncCallInstruction *, inst);
+                    if (!call || rejected.count(call)) {
+                        continue;
+                    }
+                    if (!shouldInline(caller, call)) {
+                        rejected.insert(call);
+                        continue;
+                    }
+                    siteBlock = block;
+                    site = call;
+                    break;
+                }
+                if (site) {
+                    break;
+                }
+            }
+
+            if (!site) {
+                break;
+            }
+
+            Function * callee = site->calledFunction;
+            if (callee->getMaxFuncCallArgCnt() > caller->getMaxFuncCallArgCnt()) {
+                caller->setMaxFuncCallArgCnt(callee->getMaxFuncCallArgCnt());
+            }
+
+            inlineCall(caller, siteBlock, site);
+            inlined = true;
+        }
+
+        if (!inlined) {
+            continue;
+        }
+
+        // 全部调用都被内联的函数成为叶子函数，后端可以使用调用者保存的寄存器
+        bool existFuncCall = false;
+        for (auto block: caller->getBlocks()) {
+            for (auto inst: block->getInsts()) {
+                existFuncCall = existFuncCall || inst->getOp() == IROP(FUNC_CALL);
+            }
+        }
+        caller->setExistFuncCall(existFuncCall);
+
+        changed = true;
+    }
+
+    callees.clear();
+    sccId.clear();
+    order.clear();
+    dfn.clear();
+
+    return changed;
+}
+
+///
+/// @brief 求调用图的强连通分量，结果按被调用者在前的次序排列
+///
+void Inliner::computeSCCs()
+{
+    sccId.clear();
+    order.clear();
+    dfn.clear();
+    sccStack.clear();
+
+    for (auto func: module->getFunctionList()) {
+        if (!func->isBuiltin() && !dfn.count(func)) {
+            visitSCC(func);
+        }
+    }
+}
+
+///
+/// @brief Tarjan算法的深度优先遍历
+/// @param func 函数
+///
+void Inliner::visitSCC(Function * func)
+{
+    int32_t index = (int32_t) dfn.size();
+    dfn[func] = {index, index};
+    sccStack.push_back(func);
+
+    for (auto callee: callees[func]) {
+        if (!dfn.count(callee)) {
+            visitSCC(callee);
+            dfn[func].second = std::min(dfn[func].second, dfn[callee].second);
+        } else if (!sccId.count(callee)) {
+            // 仍在栈中，属于同一个强连通分量
+            dfn[func].second = std::min(dfn[func].second, dfn[callee].first);
+        }
+    }
+
+    if (dfn[func].second != index) {
+        return;
+    }
+
+    // 强连通分量的全部函数出栈，后完成的强连通分量只会调用先完成的
+    Function * member;
+    do {
+        member = sccStack.back();
+        sccStack.pop_back();
+        sccId[member] = index;
+        order.push_back(member);
+    } while (member != func);
+}
+
+///
+/// @brief 函数的规模，即Label、Entry、Exit之外的指令条数
+/// @param func 函数
+/// @return int32_t 指令条数
+///
+int32_t Inliner::getSize(Function * func)
+{
+    int32_t size = 0;
+
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            switch (inst->getOp()) {
+                case IROP(LABEL):
+                case IROP(ENTRY):
+                case IROP(EXIT):
+                    break;
+                default:
+                    size++;
+                    break;
+            }
+        }
+    }
+
+    return size;
+}
+
+///
+/// @brief 调用点是否值得内联
+/// @param caller 调用者
+/// @param call 函数调用指令
+/// @return true 内联
+/// @return false 不内联
+///
+bool Inliner::shouldInline(Function * caller, FuncCallInstruction * call)
+{
+    Function * callee = call->calledFunction;
+    if (callee->isBuiltin() || callee == caller) {
+        return false;
+    }
+
+    // 递归的函数不内联：强连通分量有多个函数，或者函数调用自身
+    int32_t id = sccId[callee];
+    if (id == sccId[caller]) {
+        return false;
+    }
+    for (auto other: order) {
+        if (other != callee && sccId[other] == id) {
+            return false;
+        }
+    }
+    auto & calleeCallees = callees[callee];
+    if (std::find(calleeCallees.begin(), calleeCallees.end(), callee) != calleeCallees.end()) {
+        return false;
+    }
+
+    int32_t size = getSize(callee);
+    if (getSize(caller) + size > MAX_CALLER_SIZE) {
+        return false;
+    }
+
+    // 收益：省去实参传递、调用与返回、保护现场，常量实参在内联后还能常量传播
+    int32_t benefit = 5 + call->getOperandsNum();
+    for (int32_t k = 0; k < call->getOperandsNum(); k++) {
+        if (dynamic_cast<ConstInt *>(call->getOperand(k))) {
+            benefit += 3;
+        }
+    }
+
+    return size - benefit <= threshold;
+}
+
+///
+/// @brief 被调用函数中的值映射到调用者中的值，局部变量第一次遇到时新建
+/// @param caller 调用者
+/// @param val 被调用函数中的值
+/// @return Value* 调用者中的值
+///
+Value * Inliner::mapValue(Function * caller, Value * val)
+{
+    auto iter = valueMap.find(val);
+    if (iter != valueMap.end()) {
+        return iter->second;
+    }
+
+    if (dynamic_cast<LocalVariable *>(val)) {
+        Value * var = caller->newLocalVarValue(val->getType(), val->getName(), val->getScopeLevel());
+        valueMap[val] = var;
+        return var;
+    }
+
+    // 常量、全局变量等不需要映射
+    return val;
+}
+
+///
+/// @brief 把一个调用点替换为被调用函数的复制
+/// @param caller 调用者
+/// @param block 调用指令所在的基本块
+/// @param call 函数调用指令
+///
+void Inliner::inlineCall(Function * caller, BasicBlock * block, FuncCallInstruction * call)
+{
+    Function * callee = call->calledFunction;
+    auto & calleeBlocks = callee->getBlocks();
+
+    valueMap.clear();
+
+    // 形参在被调用函数内被赋值时复制到新的局部变量，否则直接替换为实参。
+    // 全局标量作为操作数时读的是使用时的值，被调用函数可能改变它，也要复制
+    std::set<Value *> assigned;
+    for (auto calleeBlock: calleeBlocks) {
+        for (auto inst: calleeBlock->getInsts()) {
+            if (inst->getOp() == IROP(ASSIGN)) {
+                assigned.insert(inst->getOperand(0));
+            }
+        }
+    }
+
+    std::vector<Instruction *> paramCopies;
+    auto & params = callee->getParams();
+    for (size_t k = 0; k < params.size(); k++) {
+        Value * arg = call->getOperand((int32_t) k);
+        if (assigned.count(params[k]) || isGlobalScalar(arg)) {
+            Value * var = caller->newLocalVarValue(params[k]->getType(), params[k]->getName());
+            paramCopies.push_back(new MoveInstruction(caller, var, arg));
+            valueMap[params[k]] = var;
+        } else {
+            valueMap[params[k]] = arg;
+        }
+    }
+
+    // 被调用函数的入口基本块并入调用点所在的基本块，其余基本块新建
+    std::unordered_map<BasicBlock *, BasicBlock *> blockMap;
+    std::vector<BasicBlock *> newBlocks;
+    for (auto calleeBlock: calleeBlocks) {
+        if (calleeBlock == calleeBlocks.front()) {
+            blockMap[calleeBlock] = block;
+        } else {
+            blockMap[calleeBlock] = new BasicBlock(caller);
+            newBlocks.push_back(blockMap[calleeBlock]);
+        }
+    }
+
+    // 第一遍复制Label与有值的指令，操作数暂时是被调用函数中的值
+    std::vector<Instruction *> clones;
+    for (auto calleeBlock: calleeBlocks) {
+        for (auto inst: calleeBlock->getInsts()) {
+            Instruction * clone = cloneInstruction(caller, inst, blockMap);
+            if (!clone) {
+                continue;
+            }
+
+            valueMap[inst] = clone;
+            clones.push_back(clone);
+        }
+    }
+
+    // 操作数换成调用者中的值
+    for (auto clone: clones) {
+        for (int32_t k = 0; k < clone->getOperandsNum(); k++) {
+            clone->setOperand(k, mapValue(caller, clone->getOperand(k)));
+        }
+    }
+
+    // 调用点之后的指令移到新的基本块，被调用函数的出口跳转到这里
+    auto & insts = block->getInsts();
+    auto callPos = std::find(insts.begin(), insts.end(), call);
+    auto afterLabel = new LabelInstruction(caller);
+    BasicBlock * afterBlock = new BasicBlock(caller);
+    afterBlock->getInsts().push_back(afterLabel);
+    afterBlock->getInsts().insert(afterBlock->getInsts().end(), callPos + 1, insts.end());
+    insts.erase(callPos, insts.end());
+    insts.insert(insts.end(), paramCopies.begin(), paramCopies.end());
+
+    // 第二遍按原来的次序放入指令，跳转指令此时才能确定条件与目标
+    Value * retVal = nullptr;
+    for (auto calleeBlock: calleeBlocks) {
+        BasicBlock * target = blockMap[calleeBlock];
+        for (auto inst: calleeBlock->getInsts()) {
+            switch (inst->getOp()) {
+                case IROP(ENTRY):
+                    break;
+                case IROP(GOTO): {
+                    auto gotoInst = static_cast<GotoInstruction *>(inst);
+                    auto iftrue = static_cast<Instruction *>(valueMap[gotoInst->iftrue]);
+                    if (gotoInst->getCondiValue()) {
+                        auto iffalse = static_cast<Instruction *>(valueMap[gotoInst->iffalse]);
+                        Value * cond = mapValue(caller, gotoInst->getCondiValue());
+                        target->getInsts().push_back(new GotoInstruction(caller, cond, iftrue, iffalse));
+                    } else {
+                        target->getInsts().push_back(new GotoInstruction(caller, iftrue));
+                    }
+                    break;
+                }
+                case IROP(EXIT):
+                    // 返回值替换调用的结果，出口不是最后一个基本块时跳转到调用点之后
+                    if (inst->getOperandsNum() > 0) {
+                        retVal = mapValue(caller, inst->getOperand(0));
+                    }
+                    if (calleeBlock != calleeBlocks.back()) {
+                        target->getInsts().push_back(new GotoInstruction(caller, afterLabel));
+                    }
+                    break;
+                default:
+                    target->getInsts().push_back(static_cast<Instruction *>(valueMap[inst]));
+                    break;
+            }
+        }
+    }
+
+    // 原来的后继上Phi指令的入边来自调用点之后的基本块
+    for (auto succ: block->getSuccs()) {
+        for (auto phi: succ->getPhis()) {
+            for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                if (phi->getIncomingBlock(k) == block) {
+                    phi->setIncomingBlock(k, afterBlock);
+                }
+            }
+        }
+    }
+
+    // 返回全局标量时，调用点之后读到的值可能已被改变，先复制到局部变量
+    if (retVal && isGlobalScalar(retVal)) {
+        Value * var = caller->newLocalVarValue(retVal->getType());
+        auto & afterInsts = afterBlock->getInsts();
+        afterInsts.insert(afterInsts.begin() + 1, new MoveInstruction(caller, var, retVal));
+        retVal = var;
+    }
+
+    if (retVal) {
+        call->replaceAllUseWith(retVal);
+    }
+    call->clearOperands();
+    delete call;
+
+    newBlocks.push_back(afterBlock);
+    auto & blocks = caller->getBlocks();
+    blocks.insert(std::find(blocks.begin(), blocks.end(), block) + 1, newBlocks.begin(), newBlocks.end());
+
+    caller->updateCFG();
+
+    valueMap.clear();
+}
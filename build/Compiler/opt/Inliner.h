@@ -0,0 +1,141 @@
+///
+/// @file Inliner.h
+/// @brief 函数内联
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Pass.h"
+
+class Function;
+class BasicBlock;
+class Value;
+class Instruction;
+class FuncCallInstruction;
+
+///
+/// @brief 函数内联
+///
+/// 由FuncCallInstruction建立调用图，求强连通分量后自底向上处理，被调用函数先于调用者完成内联。
+/// 同一强连通分量内的调用(递归)不内联。被调用函数的规模减去调用的开销以及常量实参的收益，
+/// 不超过优化级别对应的阈值时，复制被调用函数的基本块并拼接到调用点，
+/// 形参替换为实参，局部变量在调用者中新建。
+///
+class Inliner : public ModulePass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    /// @param level 优化级别，决定内联的阈值
+    ///
+    Inliner(Module * _module, int32_t level);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对模块进行函数内联
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnModule(AnalysisManager & am) override;
+
+private:
+    ///
+    /// @brief 求调用图的强连通分量，结果按被调用者在前的次序排列
+    ///
+    void computeSCCs();
+
+    ///
+    /// @brief Tarjan算法的深度优先遍历
+    /// @param func 函数
+    ///
+    void visitSCC(Function * func);
+
+    ///
+    /// @brief 函数的规模，即Label、Entry、Exit之外的指令条数
+    /// @param func 函数
+    /// @return int32_t 指令条数
+    ///
+    int32_t getSize(Function * func);
+
+    ///
+    /// @brief 调用点是否值得内联
+    /// @param caller 调用者
+    /// @param call 函数调用指令
+    /// @return true 内联
+    /// @return false 不内联
+    ///
+    bool shouldInline(Function * caller, FuncCallInstruction * call);
+
+    ///
+    /// @brief 把一个调用点替换为被调用函数的复制
+    /// @param caller 调用者
+    /// @param block 调用指令所在的基本块
+    /// @param call 函数调用指令
+    ///
+    void inlineCall(Function * caller, BasicBlock * block, FuncCallInstruction * call);
+
+    ///
+    /// @brief 被调用函数中的值映射到调用者中的值，局部变量第一次遇到时新建
+    /// @param caller 调用者
+    /// @param val 被调用函数中的值
+    /// @return Value* 调用者中的值
+    ///
+    Value * mapValue(Function * caller, Value * val);
+
+    ///
+    /// @brief 内联的阈值
+    ///
+    int32_t threshold;
+
+    ///
+    /// @brief 调用图，函数到其调用的非内置函数
+    ///
+    std::unordered_map<Function *, std::vector<Function *>> callees;
+
+    ///
+    /// @brief 函数所在的强连通分量的编号
+    ///
+    std::unordered_map<Function *, int32_t> sccId;
+
+    ///
+    /// @brief 按被调用者在前的次序排列的函数
+    ///
+    std::vector<Function *> order;
+
+    ///
+    /// @brief Tarjan算法的深度优先编号与能回到的最小编号
+    ///
+    std::unordered_map<Function *, std::pair<int32_t, int32_t>> dfn;
+
+    ///
+    /// @brief Tarjan算法的栈
+    ///
+    std::vector<Function *> sccStack;
+
+    ///
+    /// @brief 当前内联中被调用函数的值到复制的值
+    ///
+    std::unordered_map<Value *, Value *> valueMap;
+};
@@ -0,0 +1,85 @@
+///
+/// @file InstCloner.cpp
+/// @brief 指令的复制，供函数内联、循环展开等需要复制代码的遍使用
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <vector>
+
+#include "InstCloner.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "AddrInstruction.h"
+#include "BinaryInstruction.h"
+#include "CastInstruction.h"
+#include "FuncCallInstruction.h"
+#include "LabelInstruction.h"
+#include "LoadInstruction.h"
+#include "MemsetInstruction.h"
+#include "MoveInstruction.h"
+#include "PhiInstruction.h"
+#include "StoreInstruction.h"
+
+///
+/// @brief 复制一条指令，复制的操作数仍是原来的值，由调用者再替换
+/// @param func 复制的指令所属的函数
+/// @param inst 被复制的指令
+/// @param blockMap 原基本块到复制的基本块，用于Phi指令的入边，不在其中的基本块保持不变
+/// @return Instruction* 复制的指令，Entry、Exit与跳转指令不复制，返回nullptr
+///
+Instruction * cloneInstruction(Function * func, Instruction * inst, std::unordered_map<BasicBlock *, BasicBlock *> & blockMap)
+{
+    switch (inst->getOp()) {
+        case IROP(ENTRY):
+        case IROP(EXIT):
+        case IROP(GOTO):
+            return nullptr;
+        case IROP(LABEL):
+            return new LabelInstruction(func);
+        case IROP(ASSIGN):
+            return new MoveInstruction(func, inst->getOperand(0), inst->getOperand(1));
+        case IROP(CAST):
+            return new CastInstruction(func,
+                                       inst->getOperand(0),
+                                       inst->getType(),
+                                       static_cast<CastInstruction *>(inst)->getCastType());
+        case IROP(FUNC_CALL): {
+            std::vector<Value *> args = inst->getOperandsValue();
+            return new FuncCallInstruction(func,
+                                           static_cast<FuncCallInstruction *>(inst)->calledFunction,
+                                           args,
+                                           inst->getType());
+        }
+        case IROP(STORE):
+            return new StoreInstruction(func, inst->getOperand(0), inst->getOperand(1));
+        case IROP(LOAD):
+            return new LoadInstruction(func, inst->getOperand(0), inst->getType());
+        case IROP(ADDR):
+            return new AddrInstruction(func, inst->getOperand(0));
+        case IROP(MEMSET):
+            return new MemsetInstruction(func, inst->getOperand(0), static_cast<MemsetInstruction *>(inst)->getSize());
+        case IROP(PHI): {
+            auto phi = static_cast<PhiInstruction *>(inst);
+            auto newPhi = new PhiInstruction(func, inst->getType());
+            for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                BasicBlock * block = phi->getIncomingBlock(k);
+                auto iter = blockMap.find(block);
+                newPhi->addIncoming(phi->getIncomingValue(k), iter == blockMap.end() ? block : iter->second);
+            }
+            return newPhi;
+        }
+        default:
+            // 其余的都是二元运算与GEP
+            return new BinaryInstruction(func, inst->getOp(), inst->getOperand(0), inst->getOperand(1), inst->getType());
+    }
+}
@@ -0,0 +1,32 @@
+///
+/// @file InstCloner.h
+/// @brief 指令的复制，供函数内联、循环展开等需要复制代码的遍使用
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <unordered_map>
+
+class Function;
+class BasicBlock;
+class Instruction;
+
+///
+/// @brief 复制一条指令，复制的操作数仍是原来的值，由调用者再替换
+/// @param func 复制的指令所属的函数
+/// @param inst 被复制的指令
+/// @param blockMap 原基本块到复制的基本块，用于Phi指令的入边，不在其中的基本块保持不变
+/// @return Instruction* 复制的指令，Entry、Exit与跳转指令不复制，返回nullptr
+///
+Instruction * cloneInstruction(Function * func, Instruction * inst, std::unordered_map<BasicBlock *, BasicBlock *> & blockMap);
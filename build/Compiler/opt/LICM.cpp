@@ -0,0 +1,426 @@
+///
+/// @file LICM.cpp
+/// @brief 循环不变量外提
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <utility>
+
+#include "LICM.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "GlobalValue.h"
+#include "DominatorTree.h"
+#include "LoopInfo.h"
+#include "AnalysisManager.h"
+#include "AddrInstruction.h"
+#include "BinaryInstruction.h"
+#include "CastInstruction.h"
+#include "GotoInstruction.h"
+#include "LabelInstruction.h"
+#include "PhiInstruction.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+LICM::LICM(Module * _module) : FunctionPass(_module)
+{}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string LICM::getName() const
+{
+    return "licm";
+}
+
+///
+/// @brief 对一个函数进行循环不变量外提
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool LICM::runOnFunction(Function * func, AnalysisManager & am)
+{
+    if (am.getLoopInfo(func).getLoops().empty()) {
+        return false;
+    }
+
+    bool changed = insertPreheaders(func, am);
+
+    instBlock.clear();
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            instBlock[inst] = block;
+        }
+    }
+
+    // 外提只在基本块之间移动指令，不改变控制流图，分析结果在整个过程中有效
+    DominatorTree & domTree = am.getDomTree(func);
+    for (auto loop: am.getLoopInfo(func).getLoops()) {
+        changed |= hoist(loop, domTree);
+    }
+
+    instBlock.clear();
+
+    return changed;
+}
+
+///
+/// @brief 为没有合适前置块的循环新建前置块
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true 新建了前置块
+/// @return false 控制流图没有改变
+///
+bool LICM::insertPreheaders(Function * func, AnalysisManager & am)
+{
+    // 新建基本块后编号改变，循环分析结果不再可用，先记下要处理的循环头及其基本块
+    std::vector<std::pair<BasicBlock *, std::set<BasicBlock *>>> pending;
+
+    for (auto loop: am.getLoopInfo(func).getLoops()) {
+        auto & blocks = loop->getBlocks();
+
+        // 后端的线性扫描寄存器分配按指令的线性位置计算活跃区间，
+        // 外提的值必须在循环的全部基本块之前定义
+        int32_t first = blocks.front()->getIndex();
+        for (auto block: blocks) {
+            first = std::min(first, block->getIndex());
+        }
+
+        BasicBlock * preheader = loop->getPreheader();
+        if (preheader && preheader->getIndex() < first) {
+            continue;
+        }
+
+        // 入口基本块是循环头时没有Label可以跳转，不处理
+        if (loop->getHeader()->getLeader()->getOp() != IROP(LABEL)) {
+            continue;
+        }
+
+        pending.emplace_back(loop->getHeader(), std::set<BasicBlock *>(blocks.begin(), blocks.end()));
+    }
+
+    if (pending.empty()) {
+        return false;
+    }
+
+    for (auto & item: pending) {
+        insertPreheader(func, item.first, item.second);
+    }
+
+    am.invalidate(func);
+
+    return true;
+}
+
+///
+/// @brief 在循环的第一个基本块之前新建前置块，循环外的前驱都改为跳到前置块
+/// @param func 函数
+/// @param header 循环头
+/// @param loopBlocks 循环的基本块
+///
+void LICM::insertPreheader(Function * func, BasicBlock * header, const std::set<BasicBlock *> & loopBlocks)
+{
+    auto & blocks = func->getBlocks();
+
+    int32_t first = header->getIndex();
+    for (auto block: loopBlocks) {
+        first = std::min(first, block->getIndex());
+    }
+
+    auto headerLabel = static_cast<LabelInstruction *>(header->getLeader());
+
+    BasicBlock * preheader = new BasicBlock(func);
+    auto label = new LabelInstruction(func);
+    preheader->getInsts().push_back(label);
+
+    // 循环外的前驱跳转到前置块
+    for (auto pred: header->getPreds()) {
+        if (loopBlocks.count(pred)) {
+            continue;
+        }
+
+        Instanceof(gotoInst, GotoInstruction *, pred->getTerminator());
+        if (gotoInst) {
+            if (gotoInst->iftrue == headerLabel) {
+                gotoInst->iftrue = label;
+            }
+            if (gotoInst->iffalse == headerLabel) {
+                gotoInst->iffalse = label;
+            }
+        } else if (first != header->getIndex()) {
+            // 顺序执行到循环头，前置块不紧挨着循环头时要显式跳转
+            pred->getInsts().push_back(new GotoInstruction(func, label));
+        }
+    }
+
+    // 前置块插在循环头之前时，顺序执行到循环头的回边要显式跳转
+    if (first == header->getIndex() && first > 0) {
+        BasicBlock * prev = blocks[first - 1];
+        if (loopBlocks.count(prev) && !prev->getTerminator()) {
+            prev->getInsts().push_back(new GotoInstruction(func, headerLabel));
+        }
+    }
+
+    // 循环头Phi指令上循环外的入边合并到前置块
+    for (auto phi: header->getPhis()) {
+        std::vector<int32_t> outside;
+        for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+            if (!loopBlocks.count(phi->getIncomingBlock(k))) {
+                outside.push_back(k);
+            }
+        }
+
+        if (outside.size() == 1) {
+            phi->setIncomingBlock(outside.front(), preheader);
+        } else if (outside.size() > 1) {
+            auto newPhi = new PhiInstruction(func, phi->getType());
+            for (auto k: outside) {
+                newPhi->addIncoming(phi->getIncomingValue(k), phi->getIncomingBlock(k));
+            }
+            for (auto iter = outside.rbegin(); iter != outside.rend(); ++iter) {
+                phi->removeIncoming(*iter);
+            }
+            phi->addIncoming(newPhi, preheader);
+            preheader->getInsts().push_back(newPhi);
+        }
+    }
+
+    if (first != header->getIndex()) {
+        preheader->getInsts().push_back(new GotoInstruction(func, headerLabel));
+    }
+
+    blocks.insert(blocks.begin() + first, preheader);
+
+    func->updateCFG();
+}
+
+///
+/// @brief 外提一个循环中的不变量
+/// @param loop 循环
+/// @param domTree 支配树
+/// @return true 有指令外提
+/// @return false 没有改变
+///
+bool LICM::hoist(Loop * loop, DominatorTree & domTree)
+{
+    BasicBlock * preheader = loop->getPreheader();
+    if (!preheader) {
+        return false;
+    }
+
+    loopAssigned.clear();
+    hasCall = false;
+    hasStore = false;
+    for (auto block: loop->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            switch (inst->getOp()) {
+                case IROP(ASSIGN):
+                    loopAssigned.insert(inst->getOperand(0));
+                    break;
+                case IROP(FUNC_CALL):
+                    hasCall = true;
+                    break;
+                case IROP(STORE):
+                case IROP(MEMSET):
+                    hasStore = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    // 支配全部出口的基本块每次迭代都执行，没有出口的循环当作都不执行
+    std::vector<BasicBlock *> exiting = loop->getExitingBlocks();
+
+    bool changed = false;
+
+    // 按逆后序处理，操作数的定义先于使用者被外提
+    for (auto block: loop->getHeader()->getFunction()->getRPOBlocks()) {
+        if (!loop->contains(block)) {
+            continue;
+        }
+
+        bool guaranteed = !exiting.empty();
+        for (auto exit: exiting) {
+            guaranteed = guaranteed && domTree.dominates(block, exit);
+        }
+
+        auto & insts = block->getInsts();
+        std::vector<Instruction *> remain;
+        for (auto inst: insts) {
+            if (!canHoist(inst, loop, guaranteed)) {
+                remain.push_back(inst);
+                continue;
+            }
+
+            preheader->insertBeforeTerminator(inst);
+            instBlock[inst] = preheader;
+            changed = true;
+        }
+        insts.swap(remain);
+    }
+
+    changed |= hoistGlobalAddrs(loop, preheader);
+
+    return changed;
+}
+
+///
+/// @brief 循环内以全局数组为基址的GEP改为使用前置块中取出的地址，地址在循环内可以保存在寄存器中
+/// @param loop 循环
+/// @param preheader 前置块
+/// @return true 有GEP被改写
+/// @return false 没有改变
+///
+bool LICM::hoistGlobalAddrs(Loop * loop, BasicBlock * preheader)
+{
+    auto & preInsts = preheader->getInsts();
+
+    // 内层循环的取地址指令已外提到前置块的，直接使用，同一数组的多条合并为一条
+    std::unordered_map<Value *, Instruction *> addrs;
+    std::vector<Instruction *> order;
+    std::vector<Instruction *> deadInsts;
+    for (auto inst: preInsts) {
+        if (inst->getOp() != IROP(ADDR)) {
+            continue;
+        }
+        auto result = addrs.emplace(inst->getOperand(0), inst);
+        if (result.second) {
+            order.push_back(inst);
+        } else {
+            inst->replaceAllUseWith(result.first->second);
+            deadInsts.push_back(inst);
+        }
+    }
+
+    bool changed = !deadInsts.empty();
+    std::vector<BasicBlock *> blocks = loop->getBlocks();
+    blocks.push_back(preheader);
+    for (auto block: blocks) {
+        for (auto inst: block->getInsts()) {
+            Value * base = inst->getOperandsNum() ? inst->getOperand(0) : nullptr;
+            if (inst->getOp() != IROP(GEP) || !dynamic_cast<GlobalValue *>(base)) {
+                continue;
+            }
+
+            Instruction *& addr = addrs[base];
+            if (!addr) {
+                addr = new AddrInstruction(preheader->getFunction(), base);
+                instBlock[addr] = preheader;
+                order.push_back(addr);
+            }
+            inst->setOperand(0, addr);
+            changed = true;
+        }
+    }
+
+    if (order.empty()) {
+        return changed;
+    }
+
+    // 取地址指令只依赖全局数组，都放到前置块的开头，先于前置块中使用它们的GEP
+    preInsts.erase(std::remove_if(preInsts.begin(),
+                                  preInsts.end(),
+                                  [](Instruction * inst) { return inst->getOp() == IROP(ADDR); }),
+                   preInsts.end());
+    preInsts.insert(preInsts.begin() + 1 + preheader->getPhis().size(), order.begin(), order.end());
+
+    for (auto inst: deadInsts) {
+        instBlock.erase(inst);
+        inst->clearOperands();
+        delete inst;
+    }
+
+    return changed;
+}
+
+///
+/// @brief 值在当前循环中是否不变
+/// @param val 值
+/// @param loop 循环
+/// @return true 不变
+/// @return false 可能改变
+///
+bool LICM::isInvariant(Value * val, Loop * loop)
+{
+    Instanceof(inst, Instruction *, val);
+    if (inst) {
+        auto iter = instBlock.find(inst);
+        return iter != instBlock.end() && !loop->contains(iter->second);
+    }
+
+    // 全局数组的地址不变，全局标量可能被调用的函数改变
+    if (dynamic_cast<GlobalValue *>(val)) {
+        return val->getType()->isArrayType() || (!hasCall && !loopAssigned.count(val));
+    }
+
+    if (dynamic_cast<Constant *>(val)) {
+        return true;
+    }
+
+    // 未提升的局部变量与形参
+    return !loopAssigned.count(val);
+}
+
+///
+/// @brief 指令能否外提到前置块
+/// @param inst 指令
+/// @param loop 循环
+/// @param guaranteed 指令是否每次迭代都执行
+/// @return true 能外提
+/// @return false 不能外提
+///
+bool LICM::canHoist(Instruction * inst, Loop * loop, bool guaranteed)
+{
+    if (!inst->hasResultValue() || inst->getType()->isInt1Byte()) {
+        return false;
+    }
+
+    switch (inst->getOp()) {
+        case IROP(IDIV):
+        case IROP(IMOD):
+            // 除数可能只在条件成立时才非0
+            if (!guaranteed) {
+                return false;
+            }
+            break;
+        case IROP(LOAD):
+            if (!guaranteed || hasStore || hasCall) {
+                return false;
+            }
+            break;
+        case IROP(ADDR):
+            break;
+        default:
+            if (!dynamic_cast<BinaryInstruction *>(inst) && !dynamic_cast<CastInstruction *>(inst)) {
+                return false;
+            }
+            break;
+    }
+
+    for (int32_t k = 0; k < inst->getOperandsNum(); k++) {
+        if (!isInvariant(inst->getOperand(k), loop)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,138 @@
+///
+/// @file LICM.h
+/// @brief 循环不变量外提
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "Pass.h"
+
+class Instruction;
+class BasicBlock;
+class Value;
+class Loop;
+class DominatorTree;
+
+///
+/// @brief 循环不变量外提(LICM)
+///
+/// 先保证每个循环都有前置块：循环头唯一的循环外前驱，且在线性序列中位于全部循环基本块之前，
+/// 没有时新建一个。然后由内层到外层，把操作数都是循环不变量的二元运算、数组元素寻址(GEP)、
+/// 类型转换移到前置块。循环内没有写内存和函数调用时，每次迭代必定执行的Load也外提。
+/// 除法与取余只外提每次迭代必定执行的，布尔值要紧挨着使用者，不外提。
+/// 循环内以全局数组为基址的GEP改为使用前置块中取出的地址，后端把地址保存在寄存器中。
+///
+class LICM : public FunctionPass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit LICM(Module * _module);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对一个函数进行循环不变量外提
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func, AnalysisManager & am) override;
+
+private:
+    ///
+    /// @brief 为没有合适前置块的循环新建前置块
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true 新建了前置块
+    /// @return false 控制流图没有改变
+    ///
+    bool insertPreheaders(Function * func, AnalysisManager & am);
+
+    ///
+    /// @brief 在循环的第一个基本块之前新建前置块，循环外的前驱都改为跳到前置块
+    /// @param func 函数
+    /// @param header 循环头
+    /// @param loopBlocks 循环的基本块
+    ///
+    void insertPreheader(Function * func, BasicBlock * header, const std::set<BasicBlock *> & loopBlocks);
+
+    ///
+    /// @brief 外提一个循环中的不变量
+    /// @param loop 循环
+    /// @param domTree 支配树
+    /// @return true 有指令外提
+    /// @return false 没有改变
+    ///
+    bool hoist(Loop * loop, DominatorTree & domTree);
+
+    ///
+    /// @brief 值在当前循环中是否不变
+    /// @param val 值
+    /// @param loop 循环
+    /// @return true 不变
+    /// @return false 可能改变
+    ///
+    bool isInvariant(Value * val, Loop * loop);
+
+    ///
+    /// @brief 指令能否外提到前置块
+    /// @param inst 指令
+    /// @param loop 循环
+    /// @param guaranteed 指令是否每次迭代都执行
+    /// @return true 能外提
+    /// @return false 不能外提
+    ///
+    bool canHoist(Instruction * inst, Loop * loop, bool guaranteed);
+
+    ///
+    /// @brief 循环内以全局数组为基址的GEP改为使用前置块中取出的地址
+    /// @param loop 循环
+    /// @param preheader 前置块
+    /// @return true 有GEP被改写
+    /// @return false 没有改变
+    ///
+    bool hoistGlobalAddrs(Loop * loop, BasicBlock * preheader);
+
+    ///
+    /// @brief 指令所在的基本块，外提时同步修改
+    ///
+    std::unordered_map<Instruction *, BasicBlock *> instBlock;
+
+    ///
+    /// @brief 当前循环内作为赋值目标的变量
+    ///
+    std::set<Value *> loopAssigned;
+
+    ///
+    /// @brief 当前循环内是否有函数调用
+    ///
+    bool hasCall = false;
+
+    ///
+    /// @brief 当前循环内是否有写内存
+    ///
+    bool hasStore = false;
+};
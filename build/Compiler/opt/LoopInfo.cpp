@@ -0,0 +1,294 @@
+///
+/// @file LoopInfo.cpp
+/// @brief 自然循环分析，得到循环嵌套森林
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+
+#include "LoopInfo.h"
+#include "DominatorTree.h"
+#include "Function.h"
+#include "BasicBlock.h"
+
+///
+/// @brief 构造函数
+/// @param _header 循环头
+/// @param blockNum 函数内基本块的个数
+///
+Loop::Loop(BasicBlock * _header, size_t blockNum) : header(_header), member(blockNum, false)
+{}
+
+///
+/// @brief 获取循环头
+/// @return BasicBlock* 循环头
+///
+BasicBlock * Loop::getHeader()
+{
+    return header;
+}
+
+///
+/// @brief 获取外层循环
+/// @return Loop* 外层循环，最外层循环为nullptr
+///
+Loop * Loop::getParent()
+{
+    return parent;
+}
+
+///
+/// @brief 获取直接内嵌的循环
+/// @return std::vector<Loop *>& 内层循环
+///
+std::vector<Loop *> & Loop::getSubLoops()
+{
+    return subLoops;
+}
+
+///
+/// @brief 获取循环内的基本块，含内层循环的基本块，第一个为循环头
+/// @return std::vector<BasicBlock *>& 基本块
+///
+std::vector<BasicBlock *> & Loop::getBlocks()
+{
+    return blocks;
+}
+
+///
+/// @brief 基本块是否在循环内
+/// @param block 基本块
+/// @return true 在循环内
+/// @return false 不在循环内
+///
+bool Loop::contains(BasicBlock * block)
+{
+    return member[block->getIndex()];
+}
+
+///
+/// @brief 获取回边的源基本块
+/// @return std::vector<BasicBlock *>& 回边源基本块
+///
+std::vector<BasicBlock *> & Loop::getLatches()
+{
+    return latches;
+}
+
+///
+/// @brief 获取有后继在循环外的循环内基本块
+/// @return std::vector<BasicBlock *> 出口基本块
+///
+std::vector<BasicBlock *> Loop::getExitingBlocks()
+{
+    std::vector<BasicBlock *> exiting;
+
+    for (auto block: blocks) {
+        for (auto succ: block->getSuccs()) {
+            if (!contains(succ)) {
+                exiting.push_back(block);
+                break;
+            }
+        }
+    }
+
+    return exiting;
+}
+
+///
+/// @brief 获取循环外的后继基本块，即跳出循环后到达的基本块
+/// @return std::vector<BasicBlock *> 循环外的后继基本块
+///
+std::vector<BasicBlock *> Loop::getExitBlocks()
+{
+    std::vector<BasicBlock *> exits;
+
+    for (auto block: blocks) {
+        for (auto succ: block->getSuccs()) {
+            if (!contains(succ) && std::find(exits.begin(), exits.end(), succ) == exits.end()) {
+                exits.push_back(succ);
+            }
+        }
+    }
+
+    return exits;
+}
+
+///
+/// @brief 获取前置基本块，即循环外唯一的前驱且其唯一的后继是循环头
+/// @return BasicBlock* 前置基本块，不存在时为nullptr
+///
+BasicBlock * Loop::getPreheader()
+{
+    BasicBlock * preheader = nullptr;
+
+    for (auto pred: header->getPreds()) {
+        if (contains(pred)) {
+            continue;
+        }
+        if (preheader) {
+            return nullptr;
+        }
+        preheader = pred;
+    }
+
+    if (preheader && preheader->getSuccs().size() != 1) {
+        return nullptr;
+    }
+
+    return preheader;
+}
+
+///
+/// @brief 获取嵌套深度，最外层循环为1
+/// @return int32_t 嵌套深度
+///
+int32_t Loop::getDepth()
+{
+    return depth;
+}
+
+///
+/// @brief 构造函数，进行循环分析
+/// @param _func 函数，要求已经划分了基本块
+/// @param domTree 函数的支配树
+///
+LoopInfo::LoopInfo(Function * _func, DominatorTree & domTree) : func(_func)
+{
+    size_t blockNum = func->getBlocks().size();
+    loopFor.assign(blockNum, nullptr);
+
+    // 支配树先序的逆序中，被支配的循环头（内层循环）先于支配它的循环头被处理
+    auto & preOrder = domTree.getPreOrder();
+    for (auto pIter = preOrder.rbegin(); pIter != preOrder.rend(); ++pIter) {
+        BasicBlock * header = *pIter;
+
+        std::vector<BasicBlock *> latches;
+        for (auto pred: header->getPreds()) {
+            if (domTree.contains(pred) && domTree.dominates(header, pred)) {
+                latches.push_back(pred);
+            }
+        }
+        if (latches.empty()) {
+            continue;
+        }
+
+        Loop * loop = new Loop(header, blockNum);
+        loop->latches = latches;
+        loop->blocks.push_back(header);
+        loopFor[header->getIndex()] = loop;
+        loops.push_back(loop);
+
+        // 从回边的源基本块出发逆向查找循环体，到循环头为止
+        std::vector<BasicBlock *> worklist = latches;
+        while (!worklist.empty()) {
+            BasicBlock * block = worklist.back();
+            worklist.pop_back();
+
+            Loop * inner = loopFor[block->getIndex()];
+            if (!inner) {
+                loopFor[block->getIndex()] = loop;
+                loop->blocks.push_back(block);
+                for (auto pred: block->getPreds()) {
+                    if (domTree.contains(pred)) {
+                        worklist.push_back(pred);
+                    }
+                }
+                continue;
+            }
+
+            // 已属于某个循环的基本块，其所在的最外层循环成为当前循环的内层循环
+            while (inner->parent) {
+                inner = inner->parent;
+            }
+            if (inner == loop) {
+                continue;
+            }
+            inner->parent = loop;
+            loop->subLoops.push_back(inner);
+            for (auto pred: inner->header->getPreds()) {
+                if (domTree.contains(pred)) {
+                    worklist.push_back(pred);
+                }
+            }
+        }
+    }
+
+    // 内层循环的基本块也属于外层循环，内层循环先建立，因此按建立的顺序合并
+    for (auto loop: loops) {
+        for (auto sub: loop->subLoops) {
+            loop->blocks.insert(loop->blocks.end(), sub->blocks.begin(), sub->blocks.end());
+        }
+        for (auto block: loop->blocks) {
+            loop->member[block->getIndex()] = true;
+        }
+    }
+
+    for (auto pIter = loops.rbegin(); pIter != loops.rend(); ++pIter) {
+        Loop * loop = *pIter;
+        if (loop->parent) {
+            loop->depth = loop->parent->depth + 1;
+        } else {
+            topLevelLoops.push_back(loop);
+        }
+    }
+}
+
+///
+/// @brief 析构函数
+///
+LoopInfo::~LoopInfo()
+{
+    for (auto loop: loops) {
+        delete loop;
+    }
+}
+
+///
+/// @brief 获取最外层的循环
+/// @return std::vector<Loop *>& 最外层循环
+///
+std::vector<Loop *> & LoopInfo::getTopLevelLoops()
+{
+    return topLevelLoops;
+}
+
+///
+/// @brief 获取全部循环，内层循环在外层循环之前
+/// @return std::vector<Loop *>& 全部循环
+///
+std::vector<Loop *> & LoopInfo::getLoops()
+{
+    return loops;
+}
+
+///
+/// @brief 获取包含基本块的最内层循环
+/// @param block 基本块
+/// @return Loop* 最内层循环，不在循环内时为nullptr
+///
+Loop * LoopInfo::getLoopFor(BasicBlock * block)
+{
+    return loopFor[block->getIndex()];
+}
+
+///
+/// @brief 获取基本块的循环嵌套深度
+/// @param block 基本块
+/// @return int32_t 嵌套深度，不在循环内时为0
+///
+int32_t LoopInfo::getLoopDepth(BasicBlock * block)
+{
+    Loop * loop = loopFor[block->getIndex()];
+    return loop ? loop->depth : 0;
+}
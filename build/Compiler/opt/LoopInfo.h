@@ -0,0 +1,208 @@
+///
+/// @file LoopInfo.h
+/// @brief 自然循环分析，得到循环嵌套森林
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Function;
+class BasicBlock;
+class DominatorTree;
+
+///
+/// @brief 自然循环，由循环头以及能不经过循环头到达回边的基本块组成
+///
+class Loop {
+
+    friend class LoopInfo;
+
+public:
+    ///
+    /// @brief 获取循环头
+    /// @return BasicBlock* 循环头
+    ///
+    BasicBlock * getHeader();
+
+    ///
+    /// @brief 获取外层循环
+    /// @return Loop* 外层循环，最外层循环为nullptr
+    ///
+    Loop * getParent();
+
+    ///
+    /// @brief 获取直接内嵌的循环
+    /// @return std::vector<Loop *>& 内层循环
+    ///
+    std::vector<Loop *> & getSubLoops();
+
+    ///
+    /// @brief 获取循环内的基本块，含内层循环的基本块，第一个为循环头
+    /// @return std::vector<BasicBlock *>& 基本块
+    ///
+    std::vector<BasicBlock *> & getBlocks();
+
+    ///
+    /// @brief 基本块是否在循环内
+    /// @param block 基本块
+    /// @return true 在循环内
+    /// @return false 不在循环内
+    ///
+    bool contains(BasicBlock * block);
+
+    ///
+    /// @brief 获取回边的源基本块
+    /// @return std::vector<BasicBlock *>& 回边源基本块
+    ///
+    std::vector<BasicBlock *> & getLatches();
+
+    ///
+    /// @brief 获取有后继在循环外的循环内基本块
+    /// @return std::vector<BasicBlock *> 出口基本块
+    ///
+    std::vector<BasicBlock *> getExitingBlocks();
+
+    ///
+    /// @brief 获取循环外的后继基本块，即跳出循环后到达的基本块
+    /// @return std::vector<BasicBlock *> 循环外的后继基本块
+    ///
+    std::vector<BasicBlock *> getExitBlocks();
+
+    ///
+    /// @brief 获取前置基本块，即循环外唯一的前驱且其唯一的后继是循环头
+    /// @return BasicBlock* 前置基本块，不存在时为nullptr
+    ///
+    BasicBlock * getPreheader();
+
+    ///
+    /// @brief 获取嵌套深度，最外层循环为1
+    /// @return int32_t 嵌套深度
+    ///
+    int32_t getDepth();
+
+private:
+    ///
+    /// @brief 构造函数
+    /// @param _header 循环头
+    /// @param blockNum 函数内基本块的个数
+    ///
+    Loop(BasicBlock * _header, size_t blockNum);
+
+    ///
+    /// @brief 循环头
+    ///
+    BasicBlock * header;
+
+    ///
+    /// @brief 外层循环
+    ///
+    Loop * parent = nullptr;
+
+    ///
+    /// @brief 直接内嵌的循环
+    ///
+    std::vector<Loop *> subLoops;
+
+    ///
+    /// @brief 循环内的基本块
+    ///
+    std::vector<BasicBlock *> blocks;
+
+    ///
+    /// @brief 基本块是否在循环内，按基本块编号索引
+    ///
+    std::vector<bool> member;
+
+    ///
+    /// @brief 回边的源基本块
+    ///
+    std::vector<BasicBlock *> latches;
+
+    ///
+    /// @brief 嵌套深度
+    ///
+    int32_t depth = 1;
+};
+
+///
+/// @brief 循环分析，根据支配树找出函数内全部的自然循环以及嵌套关系
+///
+/// 回边为B->H且H支配B，同一循环头的回边合并为一个循环。
+/// 按支配树先序的逆序处理循环头，内层循环先于外层循环建立，
+/// 建立外层循环时遇到已属于内层循环的基本块直接把该内层循环挂到外层循环之下。
+///
+class LoopInfo {
+
+public:
+    ///
+    /// @brief 构造函数，进行循环分析
+    /// @param _func 函数，要求已经划分了基本块
+    /// @param domTree 函数的支配树
+    ///
+    LoopInfo(Function * _func, DominatorTree & domTree);
+
+    ///
+    /// @brief 析构函数
+    ///
+    ~LoopInfo();
+
+    ///
+    /// @brief 获取最外层的循环
+    /// @return std::vector<Loop *>& 最外层循环
+    ///
+    std::vector<Loop *> & getTopLevelLoops();
+
+    ///
+    /// @brief 获取全部循环，内层循环在外层循环之前
+    /// @return std::vector<Loop *>& 全部循环
+    ///
+    std::vector<Loop *> & getLoops();
+
+    ///
+    /// @brief 获取包含基本块的最内层循环
+    /// @param block 基本块
+    /// @return Loop* 最内层循环，不在循环内时为nullptr
+    ///
+    Loop * getLoopFor(BasicBlock * block);
+
+    ///
+    /// @brief 获取基本块的循环嵌套深度
+    /// @param block 基本块
+    /// @return int32_t 嵌套深度，不在循环内时为0
+    ///
+    int32_t getLoopDepth(BasicBlock * block);
+
+private:
+    ///
+    /// @brief 函数
+    ///
+    Function * func;
+
+    ///
+    /// @brief 全部循环，内层在前
+    ///
+    std::vector<Loop *> loops;
+
+    ///
+    /// @brief 最外层循环
+    ///
+    std::vector<Loop *> topLevelLoops;
+
+    ///
+    /// @brief 基本块所在的最内层循环，按基本块编号索引
+    ///
+    std::vector<Loop *> loopFor;
+};
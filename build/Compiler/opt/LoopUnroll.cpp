@@ -0,0 +1,640 @@
+///
+/// @file LoopUnroll.cpp
+/// @brief 循环展开
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <climits>
+#include <set>
+
+#include "LoopUnroll.h"
+#include "InstCloner.h"
+#include "Module.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "Constant.h"
+#include "ConstInt.h"
+#include "FormalParam.h"
+#include "GlobalValue.h"
+#include "LoopInfo.h"
+#include "AnalysisManager.h"
+#include "BinaryInstruction.h"
+#include "GotoInstruction.h"
+#include "LabelInstruction.h"
+#include "PhiInstruction.h"
+
+/// @brief 完全展开的迭代次数上限
+static const int32_t MAX_FULL_TRIP = 16;
+
+/// @brief 完全展开后的指令条数上限
+static const int32_t MAX_FULL_SIZE = 160;
+
+/// @brief 部分展开的循环体指令条数上限
+static const int32_t MAX_PARTIAL_SIZE = 40;
+
+/// @brief 循环体不超过该条数时展开4次，否则展开2次
+static const int32_t SMALL_BODY_SIZE = 12;
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+LoopUnroll::LoopUnroll(Module * _module) : FunctionPass(_module)
+{}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string LoopUnroll::getName() const
+{
+    return "unroll";
+}
+
+///
+/// @brief 对一个函数进行循环展开
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool LoopUnroll::runOnFunction(Function * _func, AnalysisManager & am)
+{
+    func = _func;
+
+    bool changed = false;
+
+    // 已处理过的循环头，部分展开后新旧两个循环都不再展开
+    std::set<BasicBlock *> done;
+
+    // 每次展开都改变控制流图，重新进行循环分析后再找下一个
+    for (;;) {
+        bool unrolled = false;
+
+        for (auto loop: am.getLoopInfo(func).getLoops()) {
+            if (done.count(loop->getHeader())) {
+                continue;
+            }
+            done.insert(loop->getHeader());
+
+            LoopShape shape;
+            if (!analyze(loop, shape)) {
+                continue;
+            }
+
+            int32_t tripCount = getTripCount(shape, MAX_FULL_TRIP);
+            if (tripCount > 0 && tripCount * shape.size <= MAX_FULL_SIZE) {
+                unrollFully(shape, tripCount);
+            } else if (shape.size <= MAX_PARTIAL_SIZE && tripCount != 0) {
+                BasicBlock * newHeader = unrollPartially(shape, shape.size <= SMALL_BODY_SIZE ? 4 : 2);
+                if (!newHeader) {
+                    continue;
+                }
+                done.insert(newHeader);
+            } else {
+                continue;
+            }
+
+            am.invalidate(func);
+            unrolled = true;
+            break;
+        }
+
+        if (!unrolled) {
+            break;
+        }
+        changed = true;
+    }
+
+    func = nullptr;
+
+    return changed;
+}
+
+///
+/// @brief 检查循环是否是可展开的结构
+/// @param loop 循环
+/// @param shape 返回循环的结构
+/// @return true 可展开
+/// @return false 不可展开
+///
+bool LoopUnroll::analyze(Loop * loop, LoopShape & shape)
+{
+    if (!loop->getSubLoops().empty() || loop->getLatches().size() != 1) {
+        return false;
+    }
+
+    shape.header = loop->getHeader();
+    shape.preheader = loop->getPreheader();
+    shape.latch = loop->getLatches().front();
+    if (!shape.preheader || shape.header->getLeader()->getOp() != IROP(LABEL)) {
+        return false;
+    }
+
+    // 循环头是唯一的出口，条件成立进入循环体
+    auto exiting = loop->getExitingBlocks();
+    if (exiting.size() != 1 || exiting.front() != shape.header) {
+        return false;
+    }
+
+    Instanceof(branch, GotoInstruction *, shape.header->getTerminator());
+    if (!branch || !branch->getCondiValue() || !branch->iffalse) {
+        return false;
+    }
+    shape.branch = branch;
+    shape.exitLabel = branch->iffalse;
+
+    for (auto succ: shape.header->getSuccs()) {
+        if (succ->getLeader() == branch->iftrue && loop->contains(succ)) {
+            shape.bodyEntry = succ;
+        }
+    }
+    if (!shape.bodyEntry || shape.bodyEntry == shape.header) {
+        return false;
+    }
+
+    // 循环条件是循环头内归纳变量与循环不变量的比较
+    Instanceof(cond, Instruction *, branch->getCondiValue());
+    if (!cond || std::find(shape.header->getInsts().begin(), shape.header->getInsts().end(), cond) ==
+                     shape.header->getInsts().end()) {
+        return false;
+    }
+    switch (cond->getOp()) {
+        case IROP(ILT):
+        case IROP(ILE):
+        case IROP(IGT):
+        case IROP(IGE):
+            break;
+        default:
+            return false;
+    }
+    shape.cond = cond;
+
+    // 边界是循环外定值的指令、常量或者循环内没有赋值的变量，全局变量还要求循环内没有函数调用
+    Value * bound = cond->getOperand(1);
+    bool isConst = dynamic_cast<ConstInt *>(bound) != nullptr;
+    for (auto block: loop->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            if (isConst) {
+                break;
+            }
+            if (inst == bound || (inst->getOp() == IROP(ASSIGN) && inst->getOperand(0) == bound) ||
+                (inst->getOp() == IROP(FUNC_CALL) && dynamic_cast<GlobalValue *>(bound))) {
+                return false;
+            }
+        }
+    }
+
+    for (auto phi: shape.header->getPhis()) {
+        // 复制时Phi指令直接替换为其值，变量的值可能在迭代中改变
+        for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+            Value * val = phi->getIncomingValue(k);
+            if (!dynamic_cast<Instruction *>(val) && !dynamic_cast<Constant *>(val) &&
+                !dynamic_cast<FormalParam *>(val)) {
+                return false;
+            }
+        }
+
+        if (phi != cond->getOperand(0) || phi->getIncomingCount() != 2) {
+            continue;
+        }
+
+        int32_t latchPos = phi->getIncomingBlock(0) == shape.latch ? 0 : 1;
+        Instanceof(next, BinaryInstruction *, phi->getIncomingValue(latchPos));
+        if (!next || next->getOperand(0) != phi) {
+            continue;
+        }
+
+        Instanceof(step, ConstInt *, next->getOperand(1));
+        if (!step) {
+            continue;
+        }
+        if (next->getOp() == IROP(IADD)) {
+            shape.step = step->getVal();
+        } else if (next->getOp() == IROP(ISUB) && step->getVal() != INT_MIN) {
+            shape.step = -step->getVal();
+        }
+        if (shape.step != 0) {
+            shape.iv = phi;
+        }
+    }
+    if (!shape.iv) {
+        return false;
+    }
+
+    // 每次迭代都朝着边界前进
+    bool upward = cond->getOp() == IROP(ILT) || cond->getOp() == IROP(ILE);
+    if (upward != (shape.step > 0)) {
+        return false;
+    }
+
+    shape.first = shape.header->getIndex();
+    for (auto block: loop->getBlocks()) {
+        shape.first = std::min(shape.first, block->getIndex());
+        if (block != shape.header) {
+            shape.body.push_back(block);
+        }
+        for (auto inst: block->getInsts()) {
+            switch (inst->getOp()) {
+                case IROP(LABEL):
+                case IROP(PHI):
+                case IROP(GOTO):
+                    break;
+                default:
+                    shape.size++;
+                    break;
+            }
+        }
+    }
+    std::sort(shape.body.begin(), shape.body.end(), [](BasicBlock * a, BasicBlock * b) {
+        return a->getIndex() < b->getIndex();
+    });
+
+    return true;
+}
+
+///
+/// @brief 初值与边界都是常量时计算迭代次数
+/// @param shape 循环的结构
+/// @param limit 迭代次数的上限
+/// @return int32_t 迭代次数，不是常量或者超过上限时为-1
+///
+int32_t LoopUnroll::getTripCount(LoopShape & shape, int32_t limit)
+{
+    PhiInstruction * iv = shape.iv;
+    int32_t initPos = iv->getIncomingBlock(0) == shape.latch ? 1 : 0;
+
+    Instanceof(init, ConstInt *, iv->getIncomingValue(initPos));
+    Instanceof(bound, ConstInt *, shape.cond->getOperand(1));
+    if (!init || !bound) {
+        return -1;
+    }
+
+    int64_t val = init->getVal();
+    int64_t end = bound->getVal();
+    for (int32_t count = 0; count <= limit; count++) {
+        bool taken;
+        switch (shape.cond->getOp()) {
+            case IROP(ILT):
+                taken = val < end;
+                break;
+            case IROP(ILE):
+                taken = val <= end;
+                break;
+            case IROP(IGT):
+                taken = val > end;
+                break;
+            default:
+                taken = val >= end;
+                break;
+        }
+        if (!taken) {
+            return count;
+        }
+
+        // 归纳变量溢出时不展开
+        val += shape.step;
+        if (val < INT_MIN || val > INT_MAX) {
+            return -1;
+        }
+    }
+
+    return -1;
+}
+
+///
+/// @brief 复制一次迭代：循环头中Phi指令之外的指令与整个循环体
+/// @param shape 循环的结构
+/// @param vmap 原值到复制的值，调用前放入循环头Phi指令在本次迭代的值
+/// @param headerLabel 复制的循环头使用的Label指令
+/// @param backTarget 回边改为跳转到这里
+/// @param nextLabel 线性序列中紧跟在复制之后的Label指令，跳到这里时不需要跳转指令
+/// @param headerOnly 只复制循环头，条件不成立的最后一次检查，之后跳出循环
+/// @param latchClone 返回复制的回边源基本块
+/// @return std::vector<BasicBlock *> 复制的基本块，按线性次序排列
+///
+std::vector<BasicBlock *> LoopUnroll::cloneIteration(LoopShape & shape,
+                                                     std::unordered_map<Value *, Value *> & vmap,
+                                                     LabelInstruction * headerLabel,
+                                                     Instruction * backTarget,
+                                                     Instruction * nextLabel,
+                                                     bool headerOnly,
+                                                     BasicBlock *& latchClone)
+{
+    std::unordered_map<BasicBlock *, BasicBlock *> blockMap;
+    std::vector<BasicBlock *> origBlocks{shape.header};
+    std::vector<BasicBlock *> newBlocks;
+
+    if (!headerOnly) {
+        origBlocks.insert(origBlocks.end(), shape.body.begin(), shape.body.end());
+
+        // 跳到循环头的回边改为跳到backTarget
+        vmap[shape.header->getLeader()] = backTarget;
+    }
+
+    for (auto block: origBlocks) {
+        blockMap[block] = new BasicBlock(func);
+        newBlocks.push_back(blockMap[block]);
+    }
+    BasicBlock * headerClone = newBlocks.front();
+    headerClone->getInsts().push_back(headerLabel);
+
+    // 复制指令，比较的结果只用于跳转时不复制，复制的迭代中条件总是成立
+    std::vector<Instruction *> clones;
+    for (size_t k = 0; k < origBlocks.size(); k++) {
+        BasicBlock * orig = origBlocks[k];
+        BasicBlock * block = newBlocks[k];
+
+        for (auto inst: orig->getInsts()) {
+            if (orig == shape.header) {
+                if (inst == shape.header->getLeader() || inst->getOp() == IROP(PHI)) {
+                    continue;
+                }
+                if (inst == shape.cond && inst->getUseList().empty()) {
+                    continue;
+                }
+            }
+
+            Instruction * clone = cloneInstruction(func, inst, blockMap);
+            if (!clone) {
+                continue;
+            }
+            vmap[inst] = clone;
+            clones.push_back(clone);
+            block->getInsts().push_back(clone);
+        }
+    }
+
+    auto mapValue = [&vmap](Value * val) {
+        auto iter = vmap.find(val);
+        return iter == vmap.end() ? val : iter->second;
+    };
+
+    for (auto clone: clones) {
+        for (int32_t k = 0; k < clone->getOperandsNum(); k++) {
+            clone->setOperand(k, mapValue(clone->getOperand(k)));
+        }
+    }
+
+    // 跳转指令
+    auto appendGoto = [this](BasicBlock * block, Instruction * target, Instruction * layoutNext) {
+        if (target != layoutNext) {
+            block->getInsts().push_back(new GotoInstruction(func, target));
+        }
+    };
+
+    if (headerOnly) {
+        appendGoto(headerClone, shape.exitLabel, nextLabel);
+        latchClone = nullptr;
+        return newBlocks;
+    }
+
+    appendGoto(headerClone, static_cast<Instruction *>(mapValue(shape.bodyEntry->getLeader())), newBlocks[1]->getLeader());
+
+    for (size_t k = 0; k < shape.body.size(); k++) {
+        BasicBlock * orig = shape.body[k];
+        BasicBlock * clone = newBlocks[k + 1];
+        Instruction * layoutNext = k + 2 < newBlocks.size() ? newBlocks[k + 2]->getLeader() : nextLabel;
+
+        Instanceof(gotoInst, GotoInstruction *, orig->getTerminator());
+        if (gotoInst) {
+            auto iftrue = static_cast<Instruction *>(mapValue(gotoInst->iftrue));
+            if (gotoInst->getCondiValue()) {
+                auto iffalse = static_cast<Instruction *>(mapValue(gotoInst->iffalse));
+                clone->getInsts().push_back(new GotoInstruction(func, mapValue(gotoInst->getCondiValue()), iftrue, iffalse));
+            } else {
+                clone->getInsts().push_back(new GotoInstruction(func, iftrue));
+            }
+        } else if (!orig->getTerminator()) {
+            // 原来顺序执行到下一个基本块，复制后下一个基本块不一定紧随其后
+            auto target = static_cast<Instruction *>(mapValue(orig->getSuccs().front()->getLeader()));
+            appendGoto(clone, target, layoutNext);
+        }
+    }
+
+    latchClone = blockMap[shape.latch];
+
+    return newBlocks;
+}
+
+///
+/// @brief 下一次迭代循环头Phi指令的值
+/// @param shape 循环的结构
+/// @param vmap 本次迭代的值映射
+/// @return std::unordered_map<Value *, Value *> 下一次迭代的初始映射
+///
+std::unordered_map<Value *, Value *> LoopUnroll::nextIteration(LoopShape & shape,
+                                                               std::unordered_map<Value *, Value *> & vmap)
+{
+    std::unordered_map<Value *, Value *> next;
+
+    for (auto phi: shape.header->getPhis()) {
+        for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+            if (phi->getIncomingBlock(k) == shape.latch) {
+                Value * val = phi->getIncomingValue(k);
+                auto iter = vmap.find(val);
+                next[phi] = iter == vmap.end() ? val : iter->second;
+            }
+        }
+    }
+
+    return next;
+}
+
+///
+/// @brief 前置块改为跳转到新的循环入口
+/// @param shape 循环的结构
+/// @param label 新的循环入口，放在线性序列中原来循环的位置
+///
+void LoopUnroll::redirectPreheader(LoopShape & shape, LabelInstruction * label)
+{
+    Instanceof(gotoInst, GotoInstruction *, shape.preheader->getTerminator());
+    if (gotoInst) {
+        gotoInst->iftrue = label;
+    } else if (shape.preheader->getIndex() + 1 != shape.first) {
+        shape.preheader->getInsts().push_back(new GotoInstruction(func, label));
+    }
+}
+
+///
+/// @brief 完全展开
+/// @param shape 循环的结构
+/// @param tripCount 迭代次数
+///
+void LoopUnroll::unrollFully(LoopShape & shape, int32_t tripCount)
+{
+    auto & blocks = func->getBlocks();
+
+    // 循环的基本块在线性序列中连续时，紧随其后的基本块可以顺序执行到达
+    int32_t last = shape.first;
+    for (auto block: shape.body) {
+        last = std::max(last, block->getIndex());
+    }
+    last = std::max(last, shape.header->getIndex());
+    Instruction * following = nullptr;
+    if (last - shape.first == (int32_t) shape.body.size() && last + 1 < (int32_t) blocks.size()) {
+        following = blocks[last + 1]->getLeader();
+    }
+
+    std::vector<LabelInstruction *> labels;
+    for (int32_t k = 0; k <= tripCount; k++) {
+        labels.push_back(new LabelInstruction(func));
+    }
+
+    // 第一次迭代中Phi指令取来自前置块的值
+    std::unordered_map<Value *, Value *> vmap;
+    for (auto phi: shape.header->getPhis()) {
+        for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+            if (phi->getIncomingBlock(k) == shape.preheader) {
+                vmap[phi] = phi->getIncomingValue(k);
+            }
+        }
+    }
+
+    std::vector<BasicBlock *> newBlocks;
+    BasicBlock * latchClone;
+    for (int32_t k = 0; k < tripCount; k++) {
+        auto iteration = cloneIteration(shape, vmap, labels[k], labels[k + 1], labels[k + 1], false, latchClone);
+        newBlocks.insert(newBlocks.end(), iteration.begin(), iteration.end());
+        vmap = nextIteration(shape, vmap);
+    }
+
+    // 最后一次检查条件不成立，跳出循环
+    auto lastHeader = cloneIteration(shape, vmap, labels[tripCount], nullptr, following, true, latchClone);
+    newBlocks.insert(newBlocks.end(), lastHeader.begin(), lastHeader.end());
+
+    // 循环外对循环头中值的使用改为最后一次检查时的值
+    for (auto inst: shape.header->getInsts()) {
+        auto iter = vmap.find(inst);
+        if (iter != vmap.end() && iter->second != inst) {
+            inst->replaceAllUseWith(iter->second);
+        }
+    }
+    for (auto succ: shape.header->getSuccs()) {
+        for (auto phi: succ->getPhis()) {
+            for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                if (phi->getIncomingBlock(k) == shape.header) {
+                    phi->setIncomingBlock(k, lastHeader.front());
+                }
+            }
+        }
+    }
+
+    redirectPreheader(shape, labels.front());
+
+    // 删除原来的循环
+    std::vector<BasicBlock *> oldBlocks = shape.body;
+    oldBlocks.push_back(shape.header);
+    for (auto block: oldBlocks) {
+        for (auto inst: block->getInsts()) {
+            inst->clearOperands();
+        }
+    }
+    for (auto block: oldBlocks) {
+        for (auto inst: block->getInsts()) {
+            delete inst;
+        }
+        blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+        delete block;
+    }
+
+    blocks.insert(blocks.begin() + shape.first, newBlocks.begin(), newBlocks.end());
+
+    func->updateCFG();
+}
+
+///
+/// @brief 部分展开，原来的循环执行剩余的迭代
+/// @param shape 循环的结构
+/// @param factor 展开因子
+/// @return BasicBlock* 展开后新循环的循环头，边界调整后溢出时不展开，为nullptr
+///
+BasicBlock * LoopUnroll::unrollPartially(LoopShape & shape, int32_t factor)
+{
+    auto & blocks = func->getBlocks();
+
+    // 新循环的条件：iv + (factor - 1) * step仍满足原来的条件，即iv与bound - (factor - 1) * step比较
+    Value * bound = shape.cond->getOperand(1);
+    int64_t delta = (int64_t) (factor - 1) * shape.step;
+    if (delta < INT_MIN || delta > INT_MAX) {
+        return nullptr;
+    }
+    Value * newBound;
+    Instanceof(boundConst, ConstInt *, bound);
+    if (boundConst) {
+        int64_t val = (int64_t) boundConst->getVal() - delta;
+        if (val < INT_MIN || val > INT_MAX) {
+            return nullptr;
+        }
+        newBound = module->newConstInt((int32_t) val);
+    } else {
+        auto sub = new BinaryInstruction(func, IROP(ISUB), bound, module->newConstInt((int32_t) delta), bound->getType());
+        shape.preheader->insertBeforeTerminator(sub);
+        newBound = sub;
+    }
+
+    // 新循环头：Phi指令、比较与条件跳转，条件不成立时进入原来的循环
+    auto headerLabel = new LabelInstruction(func);
+    auto newHeader = new BasicBlock(func);
+    newHeader->getInsts().push_back(headerLabel);
+
+    std::unordered_map<Value *, Value *> vmap;
+    std::vector<std::pair<PhiInstruction *, PhiInstruction *>> phis;
+    for (auto phi: shape.header->getPhis()) {
+        auto newPhi = new PhiInstruction(func, phi->getType());
+        newHeader->getInsts().push_back(newPhi);
+        phis.emplace_back(phi, newPhi);
+        vmap[phi] = newPhi;
+    }
+
+    auto newCond = new BinaryInstruction(func, shape.cond->getOp(), vmap[shape.iv], newBound, shape.cond->getType());
+    newHeader->getInsts().push_back(newCond);
+
+    std::vector<LabelInstruction *> labels;
+    for (int32_t k = 0; k < factor; k++) {
+        labels.push_back(new LabelInstruction(func));
+    }
+    newHeader->getInsts().push_back(new GotoInstruction(func, newCond, labels.front(), shape.header->getLeader()));
+
+    std::vector<BasicBlock *> newBlocks{newHeader};
+    BasicBlock * latchClone = nullptr;
+    for (int32_t k = 0; k < factor; k++) {
+        Instruction * back = k + 1 < factor ? labels[k + 1] : headerLabel;
+        Instruction * next = k + 1 < factor ? labels[k + 1] : blocks[shape.first]->getLeader();
+        auto iteration = cloneIteration(shape, vmap, labels[k], back, next, false, latchClone);
+        newBlocks.insert(newBlocks.end(), iteration.begin(), iteration.end());
+        vmap = nextIteration(shape, vmap);
+    }
+
+    // 新循环的Phi指令：来自前置块的初值，来自最后一份复制的回边的值
+    for (auto & item: phis) {
+        PhiInstruction * phi = item.first;
+        for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+            if (phi->getIncomingBlock(k) == shape.preheader) {
+                item.second->addIncoming(phi->getIncomingValue(k), shape.preheader);
+                phi->setOperand(k, item.second);
+                phi->setIncomingBlock(k, newHeader);
+            }
+        }
+        item.second->addIncoming(vmap[phi], latchClone);
+    }
+
+    redirectPreheader(shape, headerLabel);
+
+    blocks.insert(blocks.begin() + shape.first, newBlocks.begin(), newBlocks.end());
+
+    func->updateCFG();
+
+    return newHeader;
+}
@@ -0,0 +1,179 @@
+///
+/// @file LoopUnroll.h
+/// @brief 循环展开
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Pass.h"
+
+class Instruction;
+class BasicBlock;
+class Value;
+class Loop;
+class PhiInstruction;
+class GotoInstruction;
+class LabelInstruction;
+
+///
+/// @brief 循环展开
+///
+/// 处理IRGenerator::ir_loop产生的、经过SSA构造后的最内层循环：循环头由Phi指令、
+/// 归纳变量与循环不变量的比较以及条件跳转组成，条件成立进入循环体，不成立跳出，
+/// 循环头是唯一的出口，只有一条回边。
+/// 初值与边界都是常量、迭代次数少且循环体小的循环完全展开；
+/// 其余的按循环体的规模选择展开因子部分展开，剩余的迭代由原来的循环完成。
+///
+class LoopUnroll : public FunctionPass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit LoopUnroll(Module * _module);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对一个函数进行循环展开
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func, AnalysisManager & am) override;
+
+private:
+    ///
+    /// @brief 可展开循环的结构
+    ///
+    struct LoopShape {
+
+        /// @brief 循环头
+        BasicBlock * header = nullptr;
+
+        /// @brief 前置块
+        BasicBlock * preheader = nullptr;
+
+        /// @brief 回边的源基本块
+        BasicBlock * latch = nullptr;
+
+        /// @brief 条件成立时进入的循环体基本块
+        BasicBlock * bodyEntry = nullptr;
+
+        /// @brief 循环头之外的基本块，按线性次序排列
+        std::vector<BasicBlock *> body;
+
+        /// @brief 循环的基本块在线性序列中的最小编号
+        int32_t first = 0;
+
+        /// @brief 跳出循环的Label指令
+        LabelInstruction * exitLabel = nullptr;
+
+        /// @brief 循环头的条件跳转
+        GotoInstruction * branch = nullptr;
+
+        /// @brief 循环条件，归纳变量与循环不变量的比较
+        Instruction * cond = nullptr;
+
+        /// @brief 基本归纳变量
+        PhiInstruction * iv = nullptr;
+
+        /// @brief 归纳变量每次迭代的增量
+        int32_t step = 0;
+
+        /// @brief 循环内的指令条数
+        int32_t size = 0;
+    };
+
+    ///
+    /// @brief 检查循环是否是可展开的结构
+    /// @param loop 循环
+    /// @param shape 返回循环的结构
+    /// @return true 可展开
+    /// @return false 不可展开
+    ///
+    bool analyze(Loop * loop, LoopShape & shape);
+
+    ///
+    /// @brief 初值与边界都是常量时计算迭代次数
+    /// @param shape 循环的结构
+    /// @param limit 迭代次数的上限
+    /// @return int32_t 迭代次数，不是常量或者超过上限时为-1
+    ///
+    int32_t getTripCount(LoopShape & shape, int32_t limit);
+
+    ///
+    /// @brief 复制一次迭代：循环头中Phi指令之外的指令与整个循环体
+    /// @param shape 循环的结构
+    /// @param vmap 原值到复制的值，调用前放入循环头Phi指令在本次迭代的值
+    /// @param headerLabel 复制的循环头使用的Label指令
+    /// @param backTarget 回边改为跳转到这里
+    /// @param nextLabel 线性序列中紧跟在复制之后的Label指令，跳到这里时不需要跳转指令
+    /// @param headerOnly 只复制循环头，条件不成立的最后一次检查，之后跳出循环
+    /// @param latchClone 返回复制的回边源基本块
+    /// @return std::vector<BasicBlock *> 复制的基本块，按线性次序排列
+    ///
+    std::vector<BasicBlock *> cloneIteration(LoopShape & shape,
+                                             std::unordered_map<Value *, Value *> & vmap,
+                                             LabelInstruction * headerLabel,
+                                             Instruction * backTarget,
+                                             Instruction * nextLabel,
+                                             bool headerOnly,
+                                             BasicBlock *& latchClone);
+
+    ///
+    /// @brief 下一次迭代循环头Phi指令的值
+    /// @param shape 循环的结构
+    /// @param vmap 本次迭代的值映射
+    /// @return std::unordered_map<Value *, Value *> 下一次迭代的初始映射
+    ///
+    std::unordered_map<Value *, Value *> nextIteration(LoopShape & shape, std::unordered_map<Value *, Value *> & vmap);
+
+    ///
+    /// @brief 前置块改为跳转到新的循环入口
+    /// @param shape 循环的结构
+    /// @param label 新的循环入口，放在线性序列中原来循环的位置
+    ///
+    void redirectPreheader(LoopShape & shape, LabelInstruction * label);
+
+    ///
+    /// @brief 完全展开
+    /// @param shape 循环的结构
+    /// @param tripCount 迭代次数
+    ///
+    void unrollFully(LoopShape & shape, int32_t tripCount);
+
+    ///
+    /// @brief 部分展开，原来的循环执行剩余的迭代
+    /// @param shape 循环的结构
+    /// @param factor 展开因子
+    /// @return BasicBlock* 展开后新循环的循环头，边界调整后溢出时不展开，为nullptr
+    ///
+    BasicBlock * unrollPartially(LoopShape & shape, int32_t factor);
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func = nullptr;
+};
@@ -0,0 +1,392 @@
+///
+/// @file Mem2Reg.cpp
+/// @brief 标量局部变量提升为SSA值（SSA构造）
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+
+#include "Mem2Reg.h"
+#include "Module.h"
+#include "Function.h"
+#include "Constant.h"
+#include "ConstFloat.h"
+#include "BasicBlock.h"
+#include "PhiInstruction.h"
+#include "AnalysisManager.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+Mem2Reg::Mem2Reg(Module * _module) : FunctionPass(_module)
+{}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string Mem2Reg::getName() const
+{
+    return "mem2reg";
+}
+
+///
+/// @brief 是否保持控制流图不变。删除不可达基本块时自行使分析结果失效，其余只改变基本块内的指令
+/// @return true 控制流图不变
+///
+bool Mem2Reg::preservesCFG() const
+{
+    return true;
+}
+
+///
+/// @brief 对一个函数进行SSA构造
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool Mem2Reg::runOnFunction(Function * func, AnalysisManager & am)
+{
+    infos.clear();
+    vars.clear();
+    varMap.clear();
+    promotable.clear();
+    valueStacks.clear();
+    deadMoves.clear();
+
+    bool removed = func->removeUnreachableBlocks();
+    if (removed) {
+        am.invalidate(func);
+    }
+
+    // 出口不可达的函数（如死循环）不处理
+    auto & blocks = func->getBlocks();
+    if (!blocks.back()->isReachable()) {
+        return removed;
+    }
+
+    collectVariables(func);
+    if (std::find(promotable.begin(), promotable.end(), true) == promotable.end()) {
+        return removed;
+    }
+
+    infos.resize(blocks.size());
+
+    // 插入Phi指令与重命名都不改变控制流图，支配树在整个过程中有效
+    domTree = &am.getDomTree(func);
+
+    insertPhis(func);
+
+    // 变量的初始值：形参为实参传入的值，局部变量未赋值时取0
+    valueStacks.resize(vars.size());
+    for (size_t v = 0; v < vars.size(); v++) {
+        Value * var = vars[v];
+        if (!promotable[v]) {
+            continue;
+        }
+        if (dynamic_cast<FormalParam *>(var)) {
+            valueStacks[v].push_back(var);
+        } else if (var->getType()->isFloatType()) {
+            valueStacks[v].push_back(module->newConstFloat(0));
+        } else {
+            valueStacks[v].push_back(module->newConstInt(0));
+        }
+    }
+
+    rename(blocks.front());
+
+    cleanup(func);
+
+    domTree = nullptr;
+
+    return true;
+}
+
+///
+/// @brief 查找可提升的变量
+/// @param func 函数
+///
+void Mem2Reg::collectVariables(Function * func)
+{
+    // 基本块内出现的标量局部变量与形参都是候选变量
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            for (auto & use: inst->getOperands()) {
+                Value * val = use->getUsee();
+                if (varMap.count(val) || val->getType()->isArrayType()) {
+                    continue;
+                }
+                if (dynamic_cast<LocalVariable *>(val) || dynamic_cast<FormalParam *>(val)) {
+                    varMap[val] = (int32_t) vars.size();
+                    vars.push_back(val);
+                }
+            }
+        }
+    }
+
+    promotable.assign(vars.size(), true);
+
+    // 赋值的源操作数必须是不会被改变的值，即指令的结果、常量或者可提升的变量
+    // 源操作数是全局变量等内存值时，提升后值可能被改变，因此不提升
+    std::vector<std::pair<int32_t, int32_t>> copies;
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            if (inst->getOp() != IRINST_OP_ASSIGN) {
+                continue;
+            }
+            int32_t dst = varIndex(inst->getOperand(0));
+            if (dst == -1) {
+                continue;
+            }
+            Value * src = inst->getOperand(1);
+            if (src->getType()->isFloatType() != vars[dst]->getType()->isFloatType()) {
+                promotable[dst] = false;
+            } else if (varMap.count(src)) {
+                copies.emplace_back(dst, varMap[src]);
+            } else if (!dynamic_cast<Instruction *>(src) && !dynamic_cast<Constant *>(src)) {
+                promotable[dst] = false;
+            }
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto & copy: copies) {
+            if (promotable[copy.first] && !promotable[copy.second]) {
+                promotable[copy.first] = false;
+                changed = true;
+            }
+        }
+    }
+}
+
+///
+/// @brief 根据支配边界放置Phi指令
+/// @param func 函数
+///
+void Mem2Reg::insertPhis(Function * func)
+{
+    int32_t varNum = (int32_t) vars.size();
+
+    // 每个变量的定值基本块，以及是否在某个基本块内先使用后定值（跨基本块活跃）
+    std::vector<std::vector<int32_t>> defBlocks(varNum);
+    std::vector<bool> global(varNum, false);
+    std::vector<int32_t> killedIn(varNum, -1);
+
+    auto & blocks = func->getBlocks();
+    for (auto block: func->getRPOBlocks()) {
+        int32_t bb = block->getIndex();
+        for (auto inst: block->getInsts()) {
+            int32_t dst = -1;
+            if (inst->getOp() == IRINST_OP_ASSIGN) {
+                dst = varIndex(inst->getOperand(0));
+            }
+            for (int32_t pos = (dst == -1) ? 0 : 1; pos < inst->getOperandsNum(); pos++) {
+                int32_t v = varIndex(inst->getOperand(pos));
+                if (v != -1 && killedIn[v] != bb) {
+                    global[v] = true;
+                }
+            }
+            if (dst != -1) {
+                killedIn[dst] = bb;
+                if (defBlocks[dst].empty() || defBlocks[dst].back() != bb) {
+                    defBlocks[dst].push_back(bb);
+                }
+            }
+        }
+    }
+
+    std::vector<int32_t> hasPhi(blocks.size(), -1);
+    std::vector<int32_t> inWork(blocks.size(), -1);
+    std::vector<int32_t> worklist;
+
+    for (int32_t v = 0; v < varNum; v++) {
+        if (!promotable[v] || !global[v]) {
+            continue;
+        }
+
+        // 入口处有初始值，也视为一次定值
+        worklist = defBlocks[v];
+        worklist.push_back(0);
+        for (auto bb: worklist) {
+            inWork[bb] = v;
+        }
+
+        while (!worklist.empty()) {
+            int32_t bb = worklist.back();
+            worklist.pop_back();
+            for (auto block: domTree->getFrontier(blocks[bb])) {
+                int32_t frontier = block->getIndex();
+                if (hasPhi[frontier] == v) {
+                    continue;
+                }
+                hasPhi[frontier] = v;
+                infos[frontier].phis.emplace_back(new PhiInstruction(func, vars[v]->getType()), v);
+                if (inWork[frontier] != v) {
+                    inWork[frontier] = v;
+                    worklist.push_back(frontier);
+                }
+            }
+        }
+    }
+}
+
+///
+/// @brief 沿支配树重命名变量
+/// @param block 基本块
+///
+void Mem2Reg::rename(BasicBlock * block)
+{
+    BlockInfo & info = infos[block->getIndex()];
+    std::vector<int32_t> pushed;
+
+    for (auto & phi: info.phis) {
+        valueStacks[phi.second].push_back(phi.first);
+        pushed.push_back(phi.second);
+    }
+
+    for (auto inst: block->getInsts()) {
+        if (inst->getOp() == IRINST_OP_ASSIGN) {
+            int32_t dst = varIndex(inst->getOperand(0));
+            if (dst != -1) {
+                // 变量赋值，源操作数成为变量的当前值，赋值指令删除
+                Value * src = inst->getOperand(1);
+                int32_t v = varIndex(src);
+                if (v != -1) {
+                    src = valueStacks[v].back();
+                }
+                valueStacks[dst].push_back(src);
+                pushed.push_back(dst);
+                deadMoves.push_back(inst);
+                continue;
+            }
+        }
+
+        for (int32_t pos = 0; pos < inst->getOperandsNum(); pos++) {
+            int32_t v = varIndex(inst->getOperand(pos));
+            if (v != -1) {
+                inst->setOperand(pos, valueStacks[v].back());
+            }
+        }
+    }
+
+    // 后继基本块中的Phi指令取当前基本块出口处的值
+    for (auto succ: block->getSuccs()) {
+        for (auto & phi: infos[succ->getIndex()].phis) {
+            phi.first->addIncoming(valueStacks[phi.second].back(), block);
+        }
+    }
+
+    for (auto child: domTree->getChildren(block)) {
+        rename(child);
+    }
+
+    for (auto v: pushed) {
+        valueStacks[v].pop_back();
+    }
+}
+
+///
+/// @brief 删除无用的Phi指令以及已经提升的变量
+/// @param func 函数
+///
+void Mem2Reg::cleanup(Function * func)
+{
+    // 被非Phi指令使用的Phi是有用的，有用的Phi的操作数中的Phi也是有用的
+    std::vector<PhiInstruction *> worklist;
+    std::unordered_map<PhiInstruction *, bool> live;
+    for (auto & info: infos) {
+        for (auto & phi: info.phis) {
+            live[phi.first] = false;
+            for (auto use: phi.first->getUseList()) {
+                if (!dynamic_cast<PhiInstruction *>(use->getUser())) {
+                    live[phi.first] = true;
+                    worklist.push_back(phi.first);
+                    break;
+                }
+            }
+        }
+    }
+    while (!worklist.empty()) {
+        PhiInstruction * phi = worklist.back();
+        worklist.pop_back();
+        for (int32_t pos = 0; pos < phi->getOperandsNum(); pos++) {
+            Instanceof(src, PhiInstruction *, phi->getOperand(pos));
+            if (src && live.count(src) && !live[src]) {
+                live[src] = true;
+                worklist.push_back(src);
+            }
+        }
+    }
+
+    // 有用的Phi指令放在基本块的开头，已提升变量的赋值指令删除
+    std::vector<Instruction *> deadInsts = deadMoves;
+    for (auto block: func->getBlocks()) {
+        auto & insts = block->getInsts();
+        std::vector<Instruction *> newInsts;
+        newInsts.push_back(insts.front());
+        for (auto & phi: infos[block->getIndex()].phis) {
+            if (live[phi.first]) {
+                newInsts.push_back(phi.first);
+            } else {
+                deadInsts.push_back(phi.first);
+            }
+        }
+        for (size_t k = 1; k < insts.size(); k++) {
+            Instruction * inst = insts[k];
+            if (!(inst->getOp() == IRINST_OP_ASSIGN && varIndex(inst->getOperand(0)) != -1)) {
+                newInsts.push_back(inst);
+            }
+        }
+        insts.swap(newInsts);
+    }
+
+    for (auto inst: deadInsts) {
+        inst->clearOperands();
+    }
+    for (auto inst: deadInsts) {
+        delete inst;
+    }
+
+    // 已提升的局部变量不再需要，形参仍作为入口值保留
+    auto & localVars = func->getVarValues();
+    for (auto pIter = localVars.begin(); pIter != localVars.end();) {
+        int32_t v = varIndex(*pIter);
+        if (v != -1 && (*pIter)->getUseList().empty()) {
+            if (*pIter == func->getReturnValue()) {
+                func->setReturnValue(nullptr);
+            }
+            delete *pIter;
+            pIter = localVars.erase(pIter);
+        } else {
+            ++pIter;
+        }
+    }
+}
+
+///
+/// @brief 获取变量的编号
+/// @param val 值
+/// @return int32_t 可提升变量的编号，-1表示不是可提升的变量
+///
+int32_t Mem2Reg::varIndex(Value * val)
+{
+    auto pIter = varMap.find(val);
+    if (pIter == varMap.end() || !promotable[pIter->second]) {
+        return -1;
+    }
+    return pIter->second;
+}
@@ -0,0 +1,143 @@
+///
+/// @file Mem2Reg.h
+/// @brief 标量局部变量提升为SSA值（SSA构造）
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Pass.h"
+
+class Instruction;
+class BasicBlock;
+class PhiInstruction;
+class DominatorTree;
+class Value;
+
+///
+/// @brief SSA构造：把通过Move指令反复赋值的标量局部变量与形参提升为SSA值
+///
+/// 算法基于支配边界放置Phi指令（半剪枝，只对跨基本块活跃的变量放置），
+/// 然后沿支配树对变量的使用进行重命名，最后删除无用的Phi指令以及变量的赋值指令。
+/// 数组变量以及值来自全局变量的变量不进行提升。
+///
+class Mem2Reg : public FunctionPass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit Mem2Reg(Module * _module);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对一个函数进行SSA构造
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func, AnalysisManager & am) override;
+
+    ///
+    /// @brief 是否保持控制流图不变。删除不可达基本块时自行使分析结果失效，其余只改变基本块内的指令
+    /// @return true 控制流图不变
+    ///
+    bool preservesCFG() const override;
+
+private:
+    ///
+    /// @brief 基本块放置的Phi指令，按基本块编号索引，只在SSA构造的过程中使用
+    ///
+    struct BlockInfo {
+
+        /// @brief 基本块开头的Phi指令以及对应的变量编号
+        std::vector<std::pair<PhiInstruction *, int32_t>> phis;
+    };
+
+    ///
+    /// @brief 查找可提升的变量
+    /// @param func 函数
+    ///
+    void collectVariables(Function * func);
+
+    ///
+    /// @brief 根据支配边界放置Phi指令
+    /// @param func 函数
+    ///
+    void insertPhis(Function * func);
+
+    ///
+    /// @brief 沿支配树重命名变量
+    /// @param block 基本块
+    ///
+    void rename(BasicBlock * block);
+
+    ///
+    /// @brief 删除无用的Phi指令以及已经提升的变量
+    /// @param func 函数
+    ///
+    void cleanup(Function * func);
+
+    ///
+    /// @brief 获取变量的编号
+    /// @param val 值
+    /// @return int32_t 可提升变量的编号，-1表示不是可提升的变量
+    ///
+    int32_t varIndex(Value * val);
+
+    ///
+    /// @brief 当前函数各基本块放置的Phi指令，按基本块编号索引
+    ///
+    std::vector<BlockInfo> infos;
+
+    ///
+    /// @brief 当前函数的支配树
+    ///
+    DominatorTree * domTree = nullptr;
+
+    ///
+    /// @brief 候选的变量，含局部变量与形参
+    ///
+    std::vector<Value *> vars;
+
+    ///
+    /// @brief 变量到编号的映射
+    ///
+    std::unordered_map<Value *, int32_t> varMap;
+
+    ///
+    /// @brief 变量是否可提升
+    ///
+    std::vector<bool> promotable;
+
+    ///
+    /// @brief 重命名时各变量的当前值栈
+    ///
+    std::vector<std::vector<Value *>> valueStacks;
+
+    ///
+    /// @brief 重命名后要删除的赋值指令
+    ///
+    std::vector<Instruction *> deadMoves;
+};
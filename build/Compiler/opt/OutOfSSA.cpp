@@ -0,0 +1,442 @@
+///
+/// @file OutOfSSA.cpp
+/// @brief SSA析构，把Phi指令变换为变量之间的复制
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+
+#include "OutOfSSA.h"
+#include "Module.h"
+#include "Function.h"
+#include "FormalParam.h"
+#include "BasicBlock.h"
+#include "GotoInstruction.h"
+#include "LabelInstruction.h"
+#include "MoveInstruction.h"
+#include "PhiInstruction.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+OutOfSSA::OutOfSSA(Module * _module) : module(_module)
+{}
+
+///
+/// @brief 对模块内所有的自定义函数进行SSA析构
+/// @return true 有Phi指令被消除
+/// @return false IR没有改变
+///
+bool OutOfSSA::run()
+{
+    bool changed = false;
+
+    for (auto func: module->getFunctionList()) {
+        if (!func->isBuiltin()) {
+            changed |= runOnFunction(func);
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief 对一个函数进行SSA析构
+/// @param func 函数
+/// @return true 有Phi指令被消除
+/// @return false IR没有改变
+///
+bool OutOfSSA::runOnFunction(Function * func)
+{
+    func->buildBlocks();
+
+    auto & blocks = func->getBlocks();
+    if (std::none_of(blocks.begin(), blocks.end(), [](BasicBlock * block) { return !block->getPhis().empty(); })) {
+        return false;
+    }
+
+    defBlock.clear();
+    parent.clear();
+    members.clear();
+    classVar.clear();
+    intTemp = nullptr;
+    floatTemp = nullptr;
+
+    splitCriticalEdges(func);
+
+    infos.clear();
+    infos.resize(blocks.size());
+
+    // 参与合并的值：形参以及Phi结果
+    for (auto param: func->getParams()) {
+        defBlock[param] = -1;
+    }
+    for (auto block: blocks) {
+        for (auto phi: block->getPhis()) {
+            defBlock[phi] = block->getIndex();
+        }
+    }
+    for (auto & item: defBlock) {
+        parent[item.first] = item.first;
+        members[item.first].push_back(item.first);
+    }
+
+    computeLiveness(func);
+
+    coalesce(func);
+
+    collectCopies(func);
+
+    rewrite(func);
+
+    return true;
+}
+
+///
+/// @brief 拆分条件跳转到含Phi指令的基本块的边
+/// @param func 函数
+///
+void OutOfSSA::splitCriticalEdges(Function * func)
+{
+    auto & blocks = func->getBlocks();
+
+    // 条件跳转所在的基本块若直接到含Phi的基本块，则在该边上插入新的基本块：
+    // 复制指令不能放在条件跳转之前，否则会影响另一个分支
+    std::vector<BasicBlock *> newBlocks;
+    bool changed = false;
+    for (auto block: blocks) {
+        newBlocks.push_back(block);
+
+        Instanceof(gotoInst, GotoInstruction *, block->getTerminator());
+        if (!gotoInst || !gotoInst->getCondiValue()) {
+            continue;
+        }
+
+        for (auto succ: block->getSuccs()) {
+            auto phis = succ->getPhis();
+            if (phis.empty()) {
+                continue;
+            }
+
+            // 新基本块放在跳转指令之后，跳转指令之后必然是新的基本块，不影响顺序执行
+            auto newBlock = new BasicBlock(func);
+            auto newLabel = new LabelInstruction(func);
+            newBlock->getInsts().push_back(newLabel);
+            newBlock->getInsts().push_back(new GotoInstruction(func, succ->getLeader()));
+            newBlocks.push_back(newBlock);
+
+            // 真假分支相同时共用一个新的基本块
+            if (gotoInst->iftrue == succ->getLeader()) {
+                gotoInst->iftrue = newLabel;
+            }
+            if (gotoInst->iffalse == succ->getLeader()) {
+                gotoInst->iffalse = newLabel;
+            }
+
+            for (auto phi: phis) {
+                for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                    if (phi->getIncomingBlock(k) == block) {
+                        phi->setIncomingBlock(k, newBlock);
+                    }
+                }
+            }
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        blocks.swap(newBlocks);
+        func->updateCFG();
+    }
+}
+
+///
+/// @brief 计算Phi结果与形参在基本块入口和出口的活跃性
+/// @param func 函数
+///
+void OutOfSSA::computeLiveness(Function * func)
+{
+    auto & blocks = func->getBlocks();
+    int32_t blockNum = (int32_t) blocks.size();
+
+    // 基本块内非Phi指令的使用，以及作为后继Phi操作数时在出口处的使用
+    // Phi结果与形参在基本块内不会被重新定值，因此非本块Phi结果的使用都是向上暴露的使用
+    std::vector<std::set<Value *>> uses(blockNum), phiUses(blockNum);
+    for (int32_t bb = 0; bb < blockNum; bb++) {
+        for (auto inst: blocks[bb]->getInsts()) {
+            if (inst->getOp() == IRINST_OP_PHI) {
+                auto phi = static_cast<PhiInstruction *>(inst);
+                for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                    Value * val = phi->getIncomingValue(k);
+                    if (defBlock.count(val)) {
+                        phiUses[phi->getIncomingBlock(k)->getIndex()].insert(val);
+                    }
+                }
+                continue;
+            }
+            for (auto val: inst->getOperandsValue()) {
+                auto iter = defBlock.find(val);
+                if (iter != defBlock.end() && iter->second != bb) {
+                    uses[bb].insert(val);
+                }
+            }
+        }
+    }
+
+    // 逆序迭代求不动点
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int32_t bb = blockNum - 1; bb >= 0; bb--) {
+            BlockInfo & info = infos[bb];
+
+            std::set<Value *> liveOut = phiUses[bb];
+            for (auto succ: blocks[bb]->getSuccs()) {
+                auto & succIn = infos[succ->getIndex()].liveIn;
+                liveOut.insert(succIn.begin(), succIn.end());
+            }
+
+            std::set<Value *> liveIn = uses[bb];
+            for (auto val: liveOut) {
+                if (defBlock[val] != bb) {
+                    liveIn.insert(val);
+                }
+            }
+
+            if (liveIn.size() != info.liveIn.size()) {
+                changed = true;
+            }
+            info.liveIn.swap(liveIn);
+            info.liveOut.swap(liveOut);
+        }
+    }
+}
+
+///
+/// @brief 两个值（Phi结果或形参）的活跃区间是否冲突
+/// @param a 值
+/// @param b 值
+/// @return true 冲突
+/// @return false 不冲突
+///
+bool OutOfSSA::interfere(Value * a, Value * b)
+{
+    int32_t blockA = defBlock[a], blockB = defBlock[b];
+
+    // 同一基本块的Phi结果同时定值，形参也同时定值，保守认为冲突
+    if (blockA == blockB) {
+        return true;
+    }
+
+    // 一个值在另一个值的定值点活跃则冲突，形参在入口前定值，Phi结果不可能在那里活跃
+    if (blockB >= 0 && infos[blockB].liveIn.count(a)) {
+        return true;
+    }
+    if (blockA >= 0 && infos[blockA].liveIn.count(b)) {
+        return true;
+    }
+
+    return false;
+}
+
+///
+/// @brief 查找合并集合的代表元
+/// @param val 值
+/// @return Value* 代表元
+///
+Value * OutOfSSA::find(Value * val)
+{
+    while (parent[val] != val) {
+        parent[val] = parent[parent[val]];
+        val = parent[val];
+    }
+    return val;
+}
+
+///
+/// @brief 合并互不冲突的Phi结果与其Phi/形参操作数
+/// @param func 函数
+///
+void OutOfSSA::coalesce(Function * func)
+{
+    for (auto block: func->getBlocks()) {
+        for (auto phi: block->getPhis()) {
+            for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                Value * val = phi->getIncomingValue(k);
+                if (!defBlock.count(val) || val->getType()->isFloatType() != phi->getType()->isFloatType()) {
+                    continue;
+                }
+
+                Value * rootPhi = find(phi);
+                Value * rootVal = find(val);
+                if (rootPhi == rootVal) {
+                    continue;
+                }
+
+                // 两个集合的成员两两不冲突才能合并为同一个变量
+                bool conflict = false;
+                for (auto a: members[rootPhi]) {
+                    for (auto b: members[rootVal]) {
+                        if (interfere(a, b)) {
+                            conflict = true;
+                            break;
+                        }
+                    }
+                    if (conflict) {
+                        break;
+                    }
+                }
+
+                if (!conflict) {
+                    parent[rootVal] = rootPhi;
+                    auto & from = members[rootVal];
+                    members[rootPhi].insert(members[rootPhi].end(), from.begin(), from.end());
+                    members.erase(rootVal);
+                }
+            }
+        }
+    }
+}
+
+///
+/// @brief 为每个合并后的集合确定变量，并在前驱基本块中生成并行复制
+/// @param func 函数
+///
+void OutOfSSA::collectCopies(Function * func)
+{
+    // 含形参的集合直接使用形参，否则新建一个局部变量
+    auto getVar = [&](Value * val) {
+        Value * root = find(val);
+        auto iter = classVar.find(root);
+        if (iter != classVar.end()) {
+            return iter->second;
+        }
+
+        Value * var = nullptr;
+        for (auto member: members[root]) {
+            if (defBlock[member] < 0) {
+                var = member;
+                break;
+            }
+        }
+        if (!var) {
+            var = func->newLocalVarValue(root->getType());
+        }
+        classVar[root] = var;
+        return var;
+    };
+
+    for (auto block: func->getBlocks()) {
+        for (auto phi: block->getPhis()) {
+            Value * var = getVar(phi);
+            for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                Value * val = phi->getIncomingValue(k);
+                Value * src = defBlock.count(val) ? getVar(val) : val;
+                if (src != var) {
+                    infos[phi->getIncomingBlock(k)->getIndex()].copies.emplace_back(var, src);
+                }
+            }
+        }
+    }
+}
+
+///
+/// @brief 删除Phi指令，把并行复制串行化后插入到前驱基本块的末尾
+/// @param func 函数
+///
+void OutOfSSA::rewrite(Function * func)
+{
+    std::vector<PhiInstruction *> phis;
+    for (auto block: func->getBlocks()) {
+        auto blockPhis = block->getPhis();
+        phis.insert(phis.end(), blockPhis.begin(), blockPhis.end());
+    }
+
+    // Phi结果的使用全部替换为对应的变量
+    for (auto phi: phis) {
+        phi->replaceAllUseWith(classVar[find(phi)]);
+    }
+
+    for (auto block: func->getBlocks()) {
+
+        // 删除Phi指令
+        auto & insts = block->getInsts();
+        insts.erase(std::remove_if(insts.begin(),
+                                   insts.end(),
+                                   [](Instruction * inst) { return inst->getOp() == IRINST_OP_PHI; }),
+                    insts.end());
+
+        // 复制放在基本块末尾的跳转指令之前，顺序执行到下一块时放在最后
+        std::vector<Instruction *> moves;
+        sequentialize(func, infos[block->getIndex()].copies, moves);
+        for (auto move: moves) {
+            block->insertBeforeTerminator(move);
+        }
+    }
+
+    for (auto phi: phis) {
+        phi->clearOperands();
+    }
+    for (auto phi: phis) {
+        delete phi;
+    }
+}
+
+///
+/// @brief 把并行复制串行化为Move指令
+/// @param func 函数
+/// @param copies 并行复制，first为目的变量，second为源值
+/// @param out 生成的Move指令
+///
+void OutOfSSA::sequentialize(Function * func,
+                             std::vector<std::pair<Value *, Value *>> copies,
+                             std::vector<Instruction *> & out)
+{
+    while (!copies.empty()) {
+
+        // 目的变量不再被其它复制读取的复制可以先执行
+        bool emitted = false;
+        for (size_t i = 0; i < copies.size(); i++) {
+            Value * dst = copies[i].first;
+            bool blocked = false;
+            for (size_t j = 0; j < copies.size(); j++) {
+                if (j != i && copies[j].second == dst) {
+                    blocked = true;
+                    break;
+                }
+            }
+            if (!blocked) {
+                out.push_back(new MoveInstruction(func, dst, copies[i].second));
+                copies.erase(copies.begin() + (int64_t) i);
+                emitted = true;
+                break;
+            }
+        }
+
+        if (!emitted) {
+            // 剩下的复制都在环上，把一个目的变量的旧值保存到临时变量后环就被打破
+            Value * dst = copies.front().first;
+            Value *& temp = dst->getType()->isFloatType() ? floatTemp : intTemp;
+            if (!temp) {
+                temp = func->newLocalVarValue(dst->getType());
+            }
+            out.push_back(new MoveInstruction(func, temp, dst));
+            for (auto & copy: copies) {
+                if (copy.second == dst) {
+                    copy.second = temp;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,172 @@
+///
+/// @file OutOfSSA.h
+/// @brief SSA析构，把Phi指令变换为变量之间的复制
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Module;
+class Function;
+class Instruction;
+class BasicBlock;
+class PhiInstruction;
+class Value;
+
+///
+/// @brief SSA析构：在后端指令选择之前消除所有的Phi指令
+///
+/// 处理步骤如下：
+/// 1) 条件跳转到含Phi指令的基本块时拆分该边，保证复制指令有地方放置；
+/// 2) 计算Phi指令与形参的活跃性，把互不冲突的Phi结果与其Phi/形参操作数合并为同一个变量（复制合并）；
+/// 3) 每个前驱基本块末尾的复制是并行复制，按依赖关系串行化，出现环时借助临时变量打破；
+/// 4) Phi指令的使用替换为合并后的变量，删除Phi指令。
+///
+class OutOfSSA {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit OutOfSSA(Module * _module);
+
+    ///
+    /// @brief 对模块内所有的自定义函数进行SSA析构
+    /// @return true 有Phi指令被消除
+    /// @return false IR没有改变
+    ///
+    bool run();
+
+    ///
+    /// @brief 对一个函数进行SSA析构
+    /// @param func 函数
+    /// @return true 有Phi指令被消除
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func);
+
+private:
+    ///
+    /// @brief 基本块的活跃信息以及复制，按基本块编号索引，只在SSA析构的过程中使用
+    ///
+    struct BlockInfo {
+
+        /// @brief 入口处活跃的Phi结果与形参，不含本块的Phi结果
+        std::set<Value *> liveIn;
+
+        /// @brief 出口处活跃的Phi结果与形参
+        std::set<Value *> liveOut;
+
+        /// @brief 从该前驱基本块出来时要进行的并行复制，first为目的变量，second为源值
+        std::vector<std::pair<Value *, Value *>> copies;
+    };
+
+    ///
+    /// @brief 拆分条件跳转到含Phi指令的基本块的边
+    /// @param func 函数
+    ///
+    void splitCriticalEdges(Function * func);
+
+    ///
+    /// @brief 计算Phi结果与形参在基本块入口和出口的活跃性
+    /// @param func 函数
+    ///
+    void computeLiveness(Function * func);
+
+    ///
+    /// @brief 合并互不冲突的Phi结果与其Phi/形参操作数
+    /// @param func 函数
+    ///
+    void coalesce(Function * func);
+
+    ///
+    /// @brief 为每个合并后的集合确定变量，并在前驱基本块中生成并行复制
+    /// @param func 函数
+    ///
+    void collectCopies(Function * func);
+
+    ///
+    /// @brief 删除Phi指令，把并行复制串行化后插入到前驱基本块的末尾
+    /// @param func 函数
+    ///
+    void rewrite(Function * func);
+
+    ///
+    /// @brief 把并行复制串行化为Move指令
+    /// @param func 函数
+    /// @param copies 并行复制，first为目的变量，second为源值
+    /// @param out 生成的Move指令
+    ///
+    void sequentialize(Function * func,
+                       std::vector<std::pair<Value *, Value *>> copies,
+                       std::vector<Instruction *> & out);
+
+    ///
+    /// @brief 两个值（Phi结果或形参）的活跃区间是否冲突
+    /// @param a 值
+    /// @param b 值
+    /// @return true 冲突
+    /// @return false 不冲突
+    ///
+    bool interfere(Value * a, Value * b);
+
+    ///
+    /// @brief 查找合并集合的代表元
+    /// @param val 值
+    /// @return Value* 代表元
+    ///
+    Value * find(Value * val);
+
+    ///
+    /// @brief 模块
+    ///
+    Module * module;
+
+    ///
+    /// @brief 当前函数各基本块的活跃信息以及复制，按基本块编号索引
+    ///
+    std::vector<BlockInfo> infos;
+
+    ///
+    /// @brief Phi结果所在的基本块编号，形参为-1
+    ///
+    std::unordered_map<Value *, int32_t> defBlock;
+
+    ///
+    /// @brief 并查集的父节点
+    ///
+    std::unordered_map<Value *, Value *> parent;
+
+    ///
+    /// @brief 代表元对应集合的全部成员
+    ///
+    std::unordered_map<Value *, std::vector<Value *>> members;
+
+    ///
+    /// @brief 代表元对应的变量
+    ///
+    std::unordered_map<Value *, Value *> classVar;
+
+    ///
+    /// @brief 打破复制环用的临时变量，按整数与浮点分开
+    ///
+    Value * intTemp = nullptr;
+    Value * floatTemp = nullptr;
+};
@@ -0,0 +1,48 @@
+///
+/// @file Pass.cpp
+/// @brief 优化遍的基类
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "Pass.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+Pass::Pass(Module * _module) : module(_module)
+{}
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+ModulePass::ModulePass(Module * _module) : Pass(_module)
+{}
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+FunctionPass::FunctionPass(Module * _module) : Pass(_module)
+{}
+
+///
+/// @brief 是否保持控制流图不变，默认认为会改变
+/// @return true 控制流图不变
+/// @return false 可能改变控制流图
+///
+bool FunctionPass::preservesCFG() const
+{
+    return false;
+}
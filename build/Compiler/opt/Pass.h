@@ -0,0 +1,104 @@
+///
+/// @file Pass.h
+/// @brief 优化遍的基类
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <string>
+
+class Module;
+class Function;
+class AnalysisManager;
+
+///
+/// @brief 优化遍的基类，由PassManager按顺序调度
+///
+class Pass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit Pass(Module * _module);
+
+    ///
+    /// @brief 析构函数
+    ///
+    virtual ~Pass() = default;
+
+    ///
+    /// @brief 获取遍的名字，即-passes=选项中使用的名字
+    /// @return std::string 名字
+    ///
+    virtual std::string getName() const = 0;
+
+protected:
+    ///
+    /// @brief 模块
+    ///
+    Module * module;
+};
+
+///
+/// @brief 模块级的遍，一次处理整个模块
+///
+class ModulePass : public Pass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit ModulePass(Module * _module);
+
+    ///
+    /// @brief 对模块进行变换
+    /// @param am 分析管理器
+    /// @return true IR有改变，PassManager将使全部函数的分析结果失效
+    /// @return false IR没有改变
+    ///
+    virtual bool runOnModule(AnalysisManager & am) = 0;
+};
+
+///
+/// @brief 函数级的遍，对模块内的自定义函数逐个处理
+///
+class FunctionPass : public Pass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit FunctionPass(Module * _module);
+
+    ///
+    /// @brief 对一个函数进行变换，调用前函数已划分基本块
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    virtual bool runOnFunction(Function * func, AnalysisManager & am) = 0;
+
+    ///
+    /// @brief 是否保持控制流图不变。只改变基本块内指令的遍返回true，
+    /// 此时即使IR有改变，函数的支配树、循环等分析结果仍然有效
+    /// @return true 控制流图不变
+    /// @return false 可能改变控制流图
+    ///
+    virtual bool preservesCFG() const;
+};
@@ -0,0 +1,243 @@
+///
+/// @file PassManager.cpp
+/// @brief 优化遍的管理与调度
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include "PassManager.h"
+#include "Pass.h"
+#include "Module.h"
+#include "Function.h"
+#include "Mem2Reg.h"
+#include "SCCP.h"
+#include "GVN.h"
+#include "LICM.h"
+#include "StrengthReduce.h"
+#include "Inliner.h"
+#include "LoopUnroll.h"
+#include "SimplifyCFG.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+/// @param _optLevel 优化级别，部分遍的阈值由其确定
+///
+PassManager::PassManager(Module * _module, int32_t _optLevel) : module(_module), optLevel(_optLevel)
+{}
+
+///
+/// @brief 析构函数，释放全部的遍
+///
+PassManager::~PassManager()
+{
+    for (auto pass: passes) {
+        delete pass;
+    }
+}
+
+///
+/// @brief 在末尾追加一个遍，遍由PassManager负责释放
+/// @param pass 遍
+///
+void PassManager::addPass(Pass * pass)
+{
+    passes.push_back(pass);
+}
+
+///
+/// @brief 按名字追加一个遍
+/// @param name 遍的名字
+/// @return true 成功
+/// @return false 没有该名字的遍
+///
+bool PassManager::addPass(const std::string & name)
+{
+    Pass * pass = createPass(name);
+    if (!pass) {
+        return false;
+    }
+
+    addPass(pass);
+
+    return true;
+}
+
+///
+/// @brief 根据名字创建遍
+/// @param name 遍的名字
+/// @return Pass* 遍，名字不认识时为nullptr
+///
+Pass * PassManager::createPass(const std::string & name)
+{
+    if (name == "mem2reg") {
+        return new Mem2Reg(module);
+    }
+    if (name == "sccp") {
+        return new SCCP(module);
+    }
+    if (name == "simplifycfg") {
+        return new SimplifyCFG(module);
+    }
+    if (name == "gvn") {
+        return new GVN(module);
+    }
+    if (name == "licm") {
+        return new LICM(module);
+    }
+    if (name == "lsr") {
+        return new StrengthReduce(module);
+    }
+    if (name == "inline") {
+        return new Inliner(module, optLevel);
+    }
+    if (name == "unroll") {
+        return new LoopUnroll(module);
+    }
+
+    return nullptr;
+}
+
+///
+/// @brief 建立优化级别对应的遍序列
+/// @param level 优化级别，即-O后面的数字
+///
+void PassManager::buildPipeline(int level)
+{
+    // -O0不进行任何优化
+    if (level <= 0) {
+        return;
+    }
+
+    // -O1：SSA构造，函数内联，常量传播，公共子表达式删除，循环不变量外提
+    addPass("mem2reg");
+    addPass("inline");
+    addPass("sccp");
+    addPass("gvn");
+    addPass("licm");
+
+    // -O2及以上：在-O1的基础上追加代价较高的优化，强度削弱与循环展开
+    if (level >= 2) {
+        addPass("lsr");
+        addPass("unroll");
+    }
+
+    // 分支剪枝会删除只有跳转的前置块，循环优化都要用到前置块，因此放在最后
+    addPass("simplifycfg");
+}
+
+///
+/// @brief 按逗号分隔的名字建立遍序列，即-passes=选项的内容
+/// @param pipeline 逗号分隔的遍名字
+/// @param badName 出错时返回不认识的遍名字
+/// @return true 成功
+/// @return false 有不认识的遍名字
+///
+bool PassManager::parsePipeline(const std::string & pipeline, std::string & badName)
+{
+    std::string::size_type start = 0;
+
+    while (start <= pipeline.size()) {
+        std::string::size_type end = pipeline.find(',', start);
+        if (end == std::string::npos) {
+            end = pipeline.size();
+        }
+
+        std::string name = pipeline.substr(start, end - start);
+        if (!name.empty() && !addPass(name)) {
+            badName = name;
+            return false;
+        }
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+///
+/// @brief 遍序列是否为空
+/// @return true 空，不进行任何优化
+/// @return false 非空
+///
+bool PassManager::empty()
+{
+    return passes.empty();
+}
+
+///
+/// @brief 按顺序执行全部的遍
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool PassManager::run()
+{
+    bool changed = false;
+
+    for (auto pass: passes) {
+        changed |= runPass(pass);
+    }
+
+    return changed;
+}
+
+///
+/// @brief 执行一个遍
+/// @param pass 遍
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool PassManager::runPass(Pass * pass)
+{
+    Instanceof(modulePass, ModulePass *, pass);
+    if (modulePass) {
+        // 模块级的遍可能改变任意函数，有改变时全部分析结果失效
+        if (!modulePass->runOnModule(analysisManager)) {
+            return false;
+        }
+        analysisManager.clear();
+        return true;
+    }
+
+    Instanceof(functionPass, FunctionPass *, pass);
+    if (!functionPass) {
+        return false;
+    }
+
+    bool changed = false;
+    for (auto func: module->getFunctionList()) {
+        if (func->isBuiltin()) {
+            continue;
+        }
+
+        // 函数级的遍都在基本块上进行
+        func->buildBlocks();
+
+        if (functionPass->runOnFunction(func, analysisManager)) {
+            changed = true;
+            if (!functionPass->preservesCFG()) {
+                analysisManager.invalidate(func);
+            }
+        }
+    }
+
+    return changed;
+}
+
+///
+/// @brief 获取分析管理器
+/// @return AnalysisManager& 分析管理器
+///
+AnalysisManager & PassManager::getAnalysisManager()
+{
+    return analysisManager;
+}
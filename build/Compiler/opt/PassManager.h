@@ -0,0 +1,134 @@
+///
+/// @file PassManager.h
+/// @brief 优化遍的管理与调度
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AnalysisManager.h"
+
+class Module;
+class Pass;
+
+///
+/// @brief 遍管理器，按顺序执行模块级与函数级的优化遍
+///
+/// 遍的序列可以由优化级别(-O)确定，也可以由-passes=a,b,c选项直接指定。
+/// 分析结果由内部的AnalysisManager缓存，遍改变了IR时才使相应函数的分析结果失效，
+/// 声明保持控制流图不变的函数级遍不会使分析结果失效。
+///
+class PassManager {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    /// @param _optLevel 优化级别，部分遍的阈值由其确定
+    ///
+    explicit PassManager(Module * _module, int32_t _optLevel = 0);
+
+    ///
+    /// @brief 析构函数，释放全部的遍
+    ///
+    ~PassManager();
+
+    ///
+    /// @brief 在末尾追加一个遍，遍由PassManager负责释放
+    /// @param pass 遍
+    ///
+    void addPass(Pass * pass);
+
+    ///
+    /// @brief 按名字追加一个遍
+    /// @param name 遍的名字
+    /// @return true 成功
+    /// @return false 没有该名字的遍
+    ///
+    bool addPass(const std::string & name);
+
+    ///
+    /// @brief 建立优化级别对应的遍序列
+    /// @param level 优化级别，即-O后面的数字
+    ///
+    void buildPipeline(int level);
+
+    ///
+    /// @brief 按逗号分隔的名字建立遍序列，即-passes=选项的内容
+    /// @param pipeline 逗号分隔的遍名字
+    /// @param badName 出错时返回不认识的遍名字
+    /// @return true 成功
+    /// @return false 有不认识的遍名字
+    ///
+    bool parsePipeline(const std::string & pipeline, std::string & badName);
+
+    ///
+    /// @brief 遍序列是否为空
+    /// @return true 空，不进行任何优化
+    /// @return false 非空
+    ///
+    bool empty();
+
+    ///
+    /// @brief 按顺序执行全部的遍
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool run();
+
+    ///
+    /// @brief 获取分析管理器
+    /// @return AnalysisManager& 分析管理器
+    ///
+    AnalysisManager & getAnalysisManager();
+
+private:
+    ///
+    /// @brief 根据名字创建遍
+    /// @param name 遍的名字
+    /// @return Pass* 遍，名字不认识时为nullptr
+    ///
+    Pass * createPass(const std::string & name);
+
+    ///
+    /// @brief 执行一个遍
+    /// @param pass 遍
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runPass(Pass * pass);
+
+    ///
+    /// @brief 模块
+    ///
+    Module * module;
+
+    ///
+    /// @brief 优化级别
+    ///
+    int32_t optLevel;
+
+    ///
+    /// @brief 遍序列
+    ///
+    std::vector<Pass *> passes;
+
+    ///
+    /// @brief 分析管理器
+    ///
+    AnalysisManager analysisManager;
+};
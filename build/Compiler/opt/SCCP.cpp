@@ -0,0 +1,574 @@
+///
+/// @file SCCP.cpp
+/// @brief 稀疏条件常量传播
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "SCCP.h"
+#include "Module.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "ConstInt.h"
+#include "ConstFloat.h"
+#include "CastInstruction.h"
+#include "GotoInstruction.h"
+#include "PhiInstruction.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+SCCP::SCCP(Module * _module) : FunctionPass(_module)
+{}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string SCCP::getName() const
+{
+    return "sccp";
+}
+
+///
+/// @brief 对一个函数进行稀疏条件常量传播
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool SCCP::runOnFunction(Function * func, AnalysisManager & am)
+{
+    (void) am;
+
+    values.clear();
+    instBlock.clear();
+    labelBlock.clear();
+    condUsers.clear();
+    executableEdges.clear();
+    flowWorklist.clear();
+    ssaWorklist.clear();
+
+    auto & blocks = func->getBlocks();
+    executable.assign(blocks.size(), false);
+
+    for (auto block: blocks) {
+        for (auto inst: block->getInsts()) {
+            instBlock[inst] = block;
+            if (inst->getOp() == IRINST_OP_LABEL) {
+                labelBlock[inst] = block;
+            } else if (inst->getOp() == IRINST_OP_GOTO) {
+                Value * cond = static_cast<GotoInstruction *>(inst)->getCondiValue();
+                if (cond) {
+                    condUsers[cond].push_back(inst);
+                }
+            }
+        }
+    }
+
+    flowWorklist.emplace_back(nullptr, blocks.front());
+    while (!flowWorklist.empty() || !ssaWorklist.empty()) {
+
+        while (!flowWorklist.empty()) {
+            auto edge = flowWorklist.back();
+            flowWorklist.pop_back();
+            markEdge(edge.first, edge.second);
+        }
+
+        while (!ssaWorklist.empty()) {
+            Instruction * inst = ssaWorklist.back();
+            ssaWorklist.pop_back();
+
+            // 值有变化时其使用者重新求值，不可执行基本块中的使用者等变为可执行时再求值
+            for (auto use: inst->getUseList()) {
+                Instanceof(user, Instruction *, use->getUser());
+                if (user && executable[instBlock[user]->getIndex()]) {
+                    visit(user);
+                }
+            }
+            auto iter = condUsers.find(inst);
+            if (iter != condUsers.end()) {
+                for (auto gotoInst: iter->second) {
+                    if (executable[instBlock[gotoInst]->getIndex()]) {
+                        visit(gotoInst);
+                    }
+                }
+            }
+        }
+    }
+
+    return rewrite(func);
+}
+
+///
+/// @brief 获取值在格上的值，常量为常量，非指令的值为非常量
+/// @param val 值
+/// @return Lattice 格上的值
+///
+SCCP::Lattice SCCP::getLattice(Value * val)
+{
+    Lattice lat;
+
+    Instanceof(constInt, ConstInt *, val);
+    if (constInt) {
+        lat.state = Lattice::CONSTANT;
+        lat.intVal = constInt->getVal();
+        return lat;
+    }
+
+    Instanceof(constFloat, ConstFloat *, val);
+    if (constFloat) {
+        lat.state = Lattice::CONSTANT;
+        lat.isFloat = true;
+        lat.floatVal = constFloat->getVal();
+        return lat;
+    }
+
+    // 尚未求值的指令为未知，变量、形参等其它的值都是非常量
+    if (!dynamic_cast<Instruction *>(val)) {
+        lat.state = Lattice::OVERDEF;
+        return lat;
+    }
+
+    auto iter = values.find(val);
+    if (iter != values.end()) {
+        return iter->second;
+    }
+
+    return lat;
+}
+
+///
+/// @brief 更新指令在格上的值，只能沿格往下走
+/// @param inst 指令
+/// @param lat 新的值
+///
+void SCCP::update(Instruction * inst, const Lattice & lat)
+{
+    Lattice & old = values[inst];
+
+    if (old.state == lat.state) {
+        if (lat.state != Lattice::CONSTANT) {
+            return;
+        }
+        if (old.isFloat == lat.isFloat && (lat.isFloat ? old.floatVal == lat.floatVal : old.intVal == lat.intVal)) {
+            return;
+        }
+    }
+
+    // 常量变为另一个不同的常量时直接降为非常量，保证迭代终止
+    if (old.state == Lattice::CONSTANT && lat.state == Lattice::CONSTANT) {
+        old.state = Lattice::OVERDEF;
+    } else if (old.state == Lattice::OVERDEF) {
+        return;
+    } else {
+        old = lat;
+    }
+
+    ssaWorklist.push_back(inst);
+}
+
+///
+/// @brief 标记控制流边可执行
+/// @param from 源基本块，入口时为nullptr
+/// @param to 目的基本块
+///
+void SCCP::markEdge(BasicBlock * from, BasicBlock * to)
+{
+    if (from && !executableEdges.insert({from->getIndex(), to->getIndex()}).second) {
+        return;
+    }
+
+    if (executable[to->getIndex()]) {
+        // 已可执行的基本块多了一条可执行的入边，只有Phi指令需要重新求值
+        for (auto phi: to->getPhis()) {
+            visitPhi(phi);
+        }
+        return;
+    }
+
+    executable[to->getIndex()] = true;
+    for (auto inst: to->getInsts()) {
+        visit(inst);
+    }
+
+    // 没有跳转指令的基本块顺序执行到下一个基本块
+    if (!to->getTerminator() && !to->getSuccs().empty()) {
+        flowWorklist.emplace_back(to, to->getSuccs().front());
+    }
+}
+
+///
+/// @brief 对指令求值
+/// @param inst 指令
+///
+void SCCP::visit(Instruction * inst)
+{
+    switch (inst->getOp()) {
+        case IRINST_OP_PHI:
+            visitPhi(inst);
+            break;
+        case IRINST_OP_GOTO:
+            visitGoto(inst);
+            break;
+        case IRINST_OP_IADD:
+        case IRINST_OP_ISUB:
+        case IRINST_OP_IMUL:
+        case IRINST_OP_IDIV:
+        case IRINST_OP_IMOD:
+        case IRINST_OP_IEQ:
+        case IRINST_OP_INE:
+        case IRINST_OP_IGT:
+        case IRINST_OP_ILE:
+        case IRINST_OP_IGE:
+        case IRINST_OP_ILT:
+        case IRINST_OP_FADD:
+        case IRINST_OP_FSUB:
+        case IRINST_OP_FMUL:
+        case IRINST_OP_FDIV:
+        case IRINST_OP_FMOD:
+        case IRINST_OP_FEQ:
+        case IRINST_OP_FNE:
+        case IRINST_OP_FGT:
+        case IRINST_OP_FGE:
+        case IRINST_OP_FLT:
+        case IRINST_OP_FLE:
+        case IRINST_OP_XOR:
+            update(inst, foldBinary(inst));
+            break;
+        case IRINST_OP_CAST:
+            update(inst, foldCast(inst));
+            break;
+        default:
+            // 函数调用、载入等有结果的指令都是非常量
+            if (!inst->getType()->isVoidType()) {
+                Lattice lat;
+                lat.state = Lattice::OVERDEF;
+                update(inst, lat);
+            }
+            break;
+    }
+}
+
+///
+/// @brief 对Phi指令求值，只考虑可执行边上的值
+/// @param inst Phi指令
+///
+void SCCP::visitPhi(Instruction * inst)
+{
+    auto phi = static_cast<PhiInstruction *>(inst);
+    BasicBlock * block = instBlock[inst];
+
+    Lattice result;
+    for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+        if (!executableEdges.count({phi->getIncomingBlock(k)->getIndex(), block->getIndex()})) {
+            continue;
+        }
+
+        Lattice lat = getLattice(phi->getIncomingValue(k));
+        if (lat.state == Lattice::UNKNOWN) {
+            continue;
+        }
+        if (lat.state == Lattice::OVERDEF) {
+            result.state = Lattice::OVERDEF;
+            break;
+        }
+        if (result.state == Lattice::UNKNOWN) {
+            result = lat;
+        } else if (result.isFloat != lat.isFloat ||
+                   (lat.isFloat ? result.floatVal != lat.floatVal : result.intVal != lat.intVal)) {
+            result.state = Lattice::OVERDEF;
+            break;
+        }
+    }
+
+    update(inst, result);
+}
+
+///
+/// @brief 对跳转指令求值，确定可执行的后继
+/// @param inst 跳转指令
+///
+void SCCP::visitGoto(Instruction * inst)
+{
+    auto gotoInst = static_cast<GotoInstruction *>(inst);
+    BasicBlock * block = instBlock[inst];
+
+    Value * cond = gotoInst->getCondiValue();
+    if (!cond) {
+        flowWorklist.emplace_back(block, labelBlock[gotoInst->iftrue]);
+        return;
+    }
+
+    Lattice lat = getLattice(cond);
+    if (lat.state == Lattice::UNKNOWN) {
+        return;
+    }
+
+    if (lat.state == Lattice::CONSTANT) {
+        bool taken = lat.isFloat ? lat.floatVal != 0 : lat.intVal != 0;
+        flowWorklist.emplace_back(block, labelBlock[taken ? gotoInst->iftrue : gotoInst->iffalse]);
+    } else {
+        flowWorklist.emplace_back(block, labelBlock[gotoInst->iftrue]);
+        flowWorklist.emplace_back(block, labelBlock[gotoInst->iffalse]);
+    }
+}
+
+///
+/// @brief 对二元运算指令求值
+/// @param inst 指令
+/// @return Lattice 格上的值
+///
+SCCP::Lattice SCCP::foldBinary(Instruction * inst)
+{
+    Lattice a = getLattice(inst->getOperand(0));
+    Lattice b = getLattice(inst->getOperand(1));
+
+    Lattice result;
+    if (a.state == Lattice::OVERDEF || b.state == Lattice::OVERDEF) {
+        result.state = Lattice::OVERDEF;
+        return result;
+    }
+    if (a.state == Lattice::UNKNOWN || b.state == Lattice::UNKNOWN) {
+        return result;
+    }
+
+    result.state = Lattice::CONSTANT;
+
+    if (inst->getOp() >= IRINST_OP_FADD && inst->getOp() <= IRINST_OP_FLE) {
+        float x = a.isFloat ? a.floatVal : (float) a.intVal;
+        float y = b.isFloat ? b.floatVal : (float) b.intVal;
+        result.isFloat = true;
+        switch (inst->getOp()) {
+            case IRINST_OP_FADD:
+                result.floatVal = x + y;
+                break;
+            case IRINST_OP_FSUB:
+                result.floatVal = x - y;
+                break;
+            case IRINST_OP_FMUL:
+                result.floatVal = x * y;
+                break;
+            case IRINST_OP_FDIV:
+                result.floatVal = x / y;
+                break;
+            case IRINST_OP_FMOD:
+                result.floatVal = std::fmod(x, y);
+                break;
+            default:
+                // 浮点比较的结果是整数
+                result.isFloat = false;
+                switch (inst->getOp()) {
+                    case IRINST_OP_FEQ:
+                        result.intVal = x == y;
+                        break;
+                    case IRINST_OP_FNE:
+                        result.intVal = x != y;
+                        break;
+                    case IRINST_OP_FGT:
+                        result.intVal = x > y;
+                        break;
+                    case IRINST_OP_FGE:
+                        result.intVal = x >= y;
+                        break;
+                    case IRINST_OP_FLT:
+                        result.intVal = x < y;
+                        break;
+                    default:
+                        result.intVal = x <= y;
+                        break;
+                }
+                break;
+        }
+        return result;
+    }
+
+    if (a.isFloat || b.isFloat) {
+        result.state = Lattice::OVERDEF;
+        return result;
+    }
+
+    // 加减乘按32位补码回绕，与目标机器的运算结果一致
+    int32_t x = a.intVal, y = b.intVal;
+    switch (inst->getOp()) {
+        case IRINST_OP_IADD:
+            result.intVal = (int32_t) ((uint32_t) x + (uint32_t) y);
+            break;
+        case IRINST_OP_ISUB:
+            result.intVal = (int32_t) ((uint32_t) x - (uint32_t) y);
+            break;
+        case IRINST_OP_IMUL:
+            result.intVal = (int32_t) ((uint32_t) x * (uint32_t) y);
+            break;
+        case IRINST_OP_IDIV:
+        case IRINST_OP_IMOD:
+            // 除数为0以及溢出的情况保留到运行时
+            if (y == 0 || (x == INT32_MIN && y == -1)) {
+                result.state = Lattice::OVERDEF;
+            } else {
+                result.intVal = inst->getOp() == IRINST_OP_IDIV ? x / y : x % y;
+            }
+            break;
+        case IRINST_OP_IEQ:
+            result.intVal = x == y;
+            break;
+        case IRINST_OP_INE:
+            result.intVal = x != y;
+            break;
+        case IRINST_OP_IGT:
+            result.intVal = x > y;
+            break;
+        case IRINST_OP_ILE:
+            result.intVal = x <= y;
+            break;
+        case IRINST_OP_IGE:
+            result.intVal = x >= y;
+            break;
+        case IRINST_OP_ILT:
+            result.intVal = x < y;
+            break;
+        case IRINST_OP_XOR:
+            result.intVal = x ^ y;
+            break;
+        default:
+            result.state = Lattice::OVERDEF;
+            break;
+    }
+
+    return result;
+}
+
+///
+/// @brief 对类型转换指令求值
+/// @param inst 指令
+/// @return Lattice 格上的值
+///
+SCCP::Lattice SCCP::foldCast(Instruction * inst)
+{
+    Lattice src = getLattice(inst->getOperand(0));
+    if (src.state != Lattice::CONSTANT) {
+        return src;
+    }
+
+    Lattice result;
+    result.state = Lattice::CONSTANT;
+
+    switch (static_cast<CastInstruction *>(inst)->getCastType()) {
+        case CastInstruction::INT_TO_FLOAT:
+            result.isFloat = true;
+            result.floatVal = src.isFloat ? src.floatVal : (float) src.intVal;
+            break;
+        case CastInstruction::FLOAT_TO_INT: {
+            float val = src.isFloat ? src.floatVal : (float) src.intVal;
+            // 超出整数范围的转换保留到运行时
+            if (!(val > -2147483904.0f && val < 2147483648.0f)) {
+                result.state = Lattice::OVERDEF;
+            } else {
+                result.intVal = (int32_t) val;
+            }
+            break;
+        }
+        case CastInstruction::BOOL_TO_INT:
+        case CastInstruction::INT_TO_BOOL:
+            result.intVal = src.isFloat ? src.floatVal != 0 : src.intVal != 0;
+            break;
+    }
+
+    return result;
+}
+
+///
+/// @brief 根据求解结果改写函数
+/// @param func 函数
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool SCCP::rewrite(Function * func)
+{
+    bool changed = false;
+    std::vector<Instruction *> deadInsts;
+
+    for (auto block: func->getBlocks()) {
+        if (!executable[block->getIndex()]) {
+            continue;
+        }
+
+        auto & insts = block->getInsts();
+        std::vector<Instruction *> newInsts;
+        for (auto inst: insts) {
+            auto iter = values.find(inst);
+            if (iter == values.end() || iter->second.state != Lattice::CONSTANT) {
+                newInsts.push_back(inst);
+                continue;
+            }
+
+            // 常量替换指令的全部使用，指令删除
+            Lattice & lat = iter->second;
+            Value * constVal;
+            if (lat.isFloat) {
+                constVal = module->newConstFloat(lat.floatVal);
+            } else {
+                constVal = module->newConstInt(lat.intVal);
+            }
+            inst->replaceAllUseWith(constVal);
+            deadInsts.push_back(inst);
+            changed = true;
+        }
+
+        // 条件为常量的分支改为无条件跳转
+        Instanceof(gotoInst, GotoInstruction *, block->getTerminator());
+        if (gotoInst && gotoInst->getCondiValue()) {
+            Lattice lat = getLattice(gotoInst->getCondiValue());
+            if (lat.state == Lattice::CONSTANT) {
+                bool taken = lat.isFloat ? lat.floatVal != 0 : lat.intVal != 0;
+                newInsts.back() = new GotoInstruction(func, taken ? gotoInst->iftrue : gotoInst->iffalse);
+                deadInsts.push_back(gotoInst);
+                changed = true;
+            }
+        }
+
+        insts.swap(newInsts);
+    }
+
+    for (auto inst: deadInsts) {
+        inst->clearOperands();
+    }
+    for (auto inst: deadInsts) {
+        delete inst;
+    }
+
+    if (!changed) {
+        return false;
+    }
+
+    // 分支改变后，Phi指令去掉不再存在的入边上的值
+    func->updateCFG();
+    for (auto block: func->getBlocks()) {
+        auto & preds = block->getPreds();
+        for (auto phi: block->getPhis()) {
+            for (int32_t k = phi->getIncomingCount() - 1; k >= 0; k--) {
+                if (std::find(preds.begin(), preds.end(), phi->getIncomingBlock(k)) == preds.end()) {
+                    phi->removeIncoming(k);
+                }
+            }
+        }
+    }
+
+    func->removeUnreachableBlocks();
+
+    return true;
+}
@@ -0,0 +1,189 @@
+///
+/// @file SCCP.h
+/// @brief 稀疏条件常量传播
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Pass.h"
+
+class Instruction;
+class BasicBlock;
+class Value;
+
+///
+/// @brief 稀疏条件常量传播(Wegman-Zadeck)
+///
+/// 在SSA值的常量格上迭代：未知 -> 常量 -> 非常量，同时只沿可执行的控制流边传播，
+/// 条件为常量的分支只有一个后继可执行。求解后常量值替换其全部使用，
+/// 条件为常量的分支改为无条件跳转，删除不可达的基本块。
+/// 只对二元运算、类型转换以及Phi指令求值，变量、访存以及函数调用的结果都视为非常量。
+///
+class SCCP : public FunctionPass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit SCCP(Module * _module);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对一个函数进行稀疏条件常量传播
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func, AnalysisManager & am) override;
+
+private:
+    ///
+    /// @brief 常量格上的值
+    ///
+    struct Lattice {
+
+        /// @brief 格的状态
+        enum State {
+            UNKNOWN,  ///< 尚未确定，格的顶
+            CONSTANT, ///< 常量
+            OVERDEF,  ///< 非常量，格的底
+        };
+
+        /// @brief 状态
+        State state = UNKNOWN;
+
+        /// @brief 是否是浮点常量
+        bool isFloat = false;
+
+        /// @brief 整数常量值，比较的结果也是整数
+        int32_t intVal = 0;
+
+        /// @brief 浮点常量值
+        float floatVal = 0;
+    };
+
+    ///
+    /// @brief 获取值在格上的值，常量为常量，非指令的值为非常量
+    /// @param val 值
+    /// @return Lattice 格上的值
+    ///
+    Lattice getLattice(Value * val);
+
+    ///
+    /// @brief 更新指令在格上的值，只能沿格往下走
+    /// @param inst 指令
+    /// @param lat 新的值
+    ///
+    void update(Instruction * inst, const Lattice & lat);
+
+    ///
+    /// @brief 标记控制流边可执行
+    /// @param from 源基本块，入口时为nullptr
+    /// @param to 目的基本块
+    ///
+    void markEdge(BasicBlock * from, BasicBlock * to);
+
+    ///
+    /// @brief 对指令求值
+    /// @param inst 指令
+    ///
+    void visit(Instruction * inst);
+
+    ///
+    /// @brief 对Phi指令求值，只考虑可执行边上的值
+    /// @param inst Phi指令
+    ///
+    void visitPhi(Instruction * inst);
+
+    ///
+    /// @brief 对跳转指令求值，确定可执行的后继
+    /// @param inst 跳转指令
+    ///
+    void visitGoto(Instruction * inst);
+
+    ///
+    /// @brief 对二元运算指令求值
+    /// @param inst 指令
+    /// @return Lattice 格上的值
+    ///
+    Lattice foldBinary(Instruction * inst);
+
+    ///
+    /// @brief 对类型转换指令求值
+    /// @param inst 指令
+    /// @return Lattice 格上的值
+    ///
+    Lattice foldCast(Instruction * inst);
+
+    ///
+    /// @brief 根据求解结果改写函数
+    /// @param func 函数
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool rewrite(Function * func);
+
+    ///
+    /// @brief 指令在格上的值
+    ///
+    std::unordered_map<Value *, Lattice> values;
+
+    ///
+    /// @brief 指令所在的基本块
+    ///
+    std::unordered_map<Instruction *, BasicBlock *> instBlock;
+
+    ///
+    /// @brief Label指令所在的基本块
+    ///
+    std::unordered_map<Instruction *, BasicBlock *> labelBlock;
+
+    ///
+    /// @brief 以值为条件的跳转指令，条件不是跳转指令的操作数，需要单独记录
+    ///
+    std::unordered_map<Value *, std::vector<Instruction *>> condUsers;
+
+    ///
+    /// @brief 基本块是否可执行，按基本块编号索引
+    ///
+    std::vector<bool> executable;
+
+    ///
+    /// @brief 可执行的控制流边，按基本块编号记录
+    ///
+    std::set<std::pair<int32_t, int32_t>> executableEdges;
+
+    ///
+    /// @brief 控制流边的工作表
+    ///
+    std::vector<std::pair<BasicBlock *, BasicBlock *>> flowWorklist;
+
+    ///
+    /// @brief 格上的值有变化的指令，其使用者要重新求值
+    ///
+    std::vector<Instruction *> ssaWorklist;
+};
@@ -0,0 +1,440 @@
+///
+/// @file SimplifyCFG.cpp
+/// @brief 控制流图化简与分支剪枝
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <vector>
+
+#include "SimplifyCFG.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "ConstInt.h"
+#include "ConstFloat.h"
+#include "GotoInstruction.h"
+#include "LabelInstruction.h"
+#include "PhiInstruction.h"
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+SimplifyCFG::SimplifyCFG(Module * _module) : FunctionPass(_module)
+{}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string SimplifyCFG::getName() const
+{
+    return "simplifycfg";
+}
+
+///
+/// @brief 对一个函数进行控制流图化简
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool SimplifyCFG::runOnFunction(Function * _func, AnalysisManager & am)
+{
+    (void) am;
+
+    func = _func;
+
+    bool changed = false;
+
+    // 每种变换都可能为别的变换创造机会，反复进行直到不再变化
+    for (;;) {
+        bool local = foldBranches();
+        local |= func->removeUnreachableBlocks();
+        local |= threadJumps();
+        local |= mergeBlocks();
+        local |= removeFallthroughGotos();
+        local |= foldPhis();
+        if (!local) {
+            break;
+        }
+        changed = true;
+    }
+
+    func = nullptr;
+
+    return changed;
+}
+
+///
+/// @brief 从基本块中删除一条指令并释放
+/// @param block 基本块
+/// @param inst 指令
+///
+void SimplifyCFG::eraseInst(BasicBlock * block, Instruction * inst)
+{
+    auto & insts = block->getInsts();
+    insts.erase(std::find(insts.begin(), insts.end(), inst));
+    inst->clearOperands();
+    delete inst;
+}
+
+///
+/// @brief 从函数中删除基本块并释放，基本块内剩余的指令一并释放
+/// @param block 基本块
+///
+void SimplifyCFG::eraseBlock(BasicBlock * block)
+{
+    for (auto inst: block->getInsts()) {
+        inst->clearOperands();
+    }
+    for (auto inst: block->getInsts()) {
+        delete inst;
+    }
+
+    auto & blocks = func->getBlocks();
+    blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+    delete block;
+}
+
+///
+/// @brief 条件为常量或者真假目标相同的条件跳转改为无条件跳转
+/// @return true 有改变
+/// @return false 没有改变
+///
+bool SimplifyCFG::foldBranches()
+{
+    bool changed = false;
+
+    for (auto block: func->getBlocks()) {
+        Instanceof(gotoInst, GotoInstruction *, block->getTerminator());
+        if (!gotoInst || !gotoInst->getCondiValue() || !gotoInst->iffalse) {
+            continue;
+        }
+
+        Value * cond = gotoInst->getCondiValue();
+        Instanceof(intCond, ConstInt *, cond);
+        Instanceof(floatCond, ConstFloat *, cond);
+        LabelInstruction * target;
+        if (gotoInst->iftrue == gotoInst->iffalse) {
+            target = gotoInst->iftrue;
+        } else if (intCond) {
+            target = intCond->getVal() ? gotoInst->iftrue : gotoInst->iffalse;
+        } else if (floatCond) {
+            target = floatCond->getVal() != 0 ? gotoInst->iftrue : gotoInst->iffalse;
+        } else {
+            continue;
+        }
+
+        // 不再跳转到的后继中Phi指令去掉来自本基本块的值
+        LabelInstruction * untaken = target == gotoInst->iftrue ? gotoInst->iffalse : gotoInst->iftrue;
+        if (untaken != target) {
+            for (auto succ: block->getSuccs()) {
+                if (succ->getLeader() != untaken) {
+                    continue;
+                }
+                for (auto phi: succ->getPhis()) {
+                    for (int32_t k = phi->getIncomingCount() - 1; k >= 0; k--) {
+                        if (phi->getIncomingBlock(k) == block) {
+                            phi->removeIncoming(k);
+                        }
+                    }
+                }
+            }
+        }
+
+        auto & insts = block->getInsts();
+        insts.back() = new GotoInstruction(func, target);
+        delete gotoInst;
+
+        // 比较的结果只用于跳转时一并删除，否则指令选择时比较的标志会被后面的条件跳转误用
+        Instanceof(condInst, Instruction *, cond);
+        if (condInst && condInst->getUseList().empty() &&
+            std::find(insts.begin(), insts.end(), condInst) != insts.end()) {
+            eraseInst(block, condInst);
+        }
+
+        changed = true;
+    }
+
+    if (changed) {
+        func->updateCFG();
+    }
+
+    return changed;
+}
+
+///
+/// @brief 空基本块的前驱直接跳转到空基本块的后继，空基本块删除
+/// @return true 有改变
+/// @return false 没有改变
+///
+bool SimplifyCFG::threadJumps()
+{
+    bool changed = false;
+
+    // 入口基本块不处理；每删除一个基本块都要更新控制流图，因此先取出候选再逐个处理
+    std::vector<BasicBlock *> candidates;
+    auto & blocks = func->getBlocks();
+    for (size_t k = 1; k < blocks.size(); k++) {
+        auto & insts = blocks[k]->getInsts();
+        if (insts.size() == 1 ||
+            (insts.size() == 2 && insts[1]->getOp() == IRInstOperator::IRINST_OP_GOTO &&
+             !static_cast<GotoInstruction *>(insts[1])->getCondiValue())) {
+            candidates.push_back(blocks[k]);
+        }
+    }
+
+    for (auto block: candidates) {
+        changed |= threadBlock(block);
+    }
+
+    return changed;
+}
+
+///
+/// @brief 尝试把空基本块的前驱改为直接跳转到其后继
+/// @param block 只有Label指令以及可能的一条无条件跳转指令的基本块
+/// @return true 成功，基本块已删除
+/// @return false 不满足条件，没有改变
+///
+bool SimplifyCFG::threadBlock(BasicBlock * block)
+{
+    // 顺序执行的空基本块的后继是线性序列中的下一个基本块
+    if (block->getSuccs().size() != 1 || block->getPreds().empty()) {
+        return false;
+    }
+    BasicBlock * target = block->getSuccs().front();
+    if (target == block) {
+        return false;
+    }
+    bool fallthrough = block->getTerminator() == nullptr;
+
+    // 寄存器分配按线性序列中回边跳转的目标到回边之间的范围识别循环，
+    // 回边跳转的目标不能后移到别的基本块之后，否则中间的基本块不再被视为在循环内
+    if (target->getIndex() > block->getIndex() + 1) {
+        for (auto pred: block->getPreds()) {
+            if (pred->getIndex() >= block->getIndex()) {
+                return false;
+            }
+        }
+    }
+
+    // 后继有Phi指令时，条件跳转进入的空基本块正好用来放置SSA销毁时的复制指令，
+    // 删除后OutOfSSA拆分关键边时还要再插入一个，且位置更差
+    auto targetPhis = target->getPhis();
+    for (auto pred: block->getPreds()) {
+        Instanceof(gotoInst, GotoInstruction *, pred->getTerminator());
+        if (!targetPhis.empty() && gotoInst && gotoInst->getCondiValue()) {
+            return false;
+        }
+    }
+
+    // 前驱也是后继的前驱时，后继的Phi指令在两条边上的值必须相同
+    auto & targetPreds = target->getPreds();
+    for (auto pred: block->getPreds()) {
+        if (std::find(targetPreds.begin(), targetPreds.end(), pred) == targetPreds.end()) {
+            continue;
+        }
+        for (auto phi: targetPhis) {
+            Value * fromBlock = nullptr;
+            Value * fromPred = nullptr;
+            for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                if (phi->getIncomingBlock(k) == block) {
+                    fromBlock = phi->getIncomingValue(k);
+                } else if (phi->getIncomingBlock(k) == pred) {
+                    fromPred = phi->getIncomingValue(k);
+                }
+            }
+            if (fromBlock != fromPred) {
+                return false;
+            }
+        }
+    }
+
+    // 后继的Phi指令把来自本基本块的值改为来自各个前驱
+    for (auto phi: targetPhis) {
+        Value * val = nullptr;
+        for (int32_t k = phi->getIncomingCount() - 1; k >= 0; k--) {
+            if (phi->getIncomingBlock(k) == block) {
+                val = phi->getIncomingValue(k);
+                phi->removeIncoming(k);
+            }
+        }
+        for (auto pred: block->getPreds()) {
+            if (std::find(targetPreds.begin(), targetPreds.end(), pred) == targetPreds.end()) {
+                phi->addIncoming(val, pred);
+            }
+        }
+    }
+
+    // 前驱的跳转改为跳转到后继，顺序执行进入本基本块的前驱删除本基本块后要跳转过去
+    LabelInstruction * targetLabel = static_cast<LabelInstruction *>(target->getLeader());
+    for (auto pred: block->getPreds()) {
+        Instanceof(gotoInst, GotoInstruction *, pred->getTerminator());
+        if (gotoInst) {
+            if (gotoInst->iftrue == block->getLeader()) {
+                gotoInst->iftrue = targetLabel;
+            }
+            if (gotoInst->iffalse == block->getLeader()) {
+                gotoInst->iffalse = targetLabel;
+            }
+        } else if (!fallthrough) {
+            pred->getInsts().push_back(new GotoInstruction(func, targetLabel));
+        }
+    }
+
+    eraseBlock(block);
+    func->updateCFG();
+
+    return true;
+}
+
+///
+/// @brief 唯一后继的唯一前驱是自己时，后继合并到自己
+/// @return true 有改变
+/// @return false 没有改变
+///
+bool SimplifyCFG::mergeBlocks()
+{
+    bool changed = false;
+    auto & blocks = func->getBlocks();
+
+    for (size_t k = 0; k < blocks.size(); k++) {
+        BasicBlock * block = blocks[k];
+
+        // 只能由无条件跳转或者顺序执行进入唯一的后继
+        Instruction * last = block->getTerminator();
+        if (last && (last->getOp() != IRInstOperator::IRINST_OP_GOTO ||
+                     static_cast<GotoInstruction *>(last)->getCondiValue())) {
+            continue;
+        }
+        if (block->getSuccs().size() != 1) {
+            continue;
+        }
+        BasicBlock * succ = block->getSuccs().front();
+        // 后继只能在线性序列的后面，保持循环在线性序列中的范围不变
+        if (succ->getIndex() <= block->getIndex() || succ->getPreds().size() != 1) {
+            continue;
+        }
+
+        // 只有一个前驱的Phi指令就是其唯一的值
+        for (auto phi: succ->getPhis()) {
+            phi->replaceAllUseWith(phi->getIncomingValue(0));
+            eraseInst(succ, phi);
+        }
+
+        // 后继原来顺序执行到的基本块，合并后不一定紧随其后
+        BasicBlock * succNext = nullptr;
+        if (!succ->getTerminator() && !succ->getSuccs().empty()) {
+            succNext = succ->getSuccs().front();
+        }
+
+        // 后继的后继中Phi指令的入边改为来自合并后的基本块
+        for (auto next: succ->getSuccs()) {
+            for (auto phi: next->getPhis()) {
+                for (int32_t i = 0; i < phi->getIncomingCount(); i++) {
+                    if (phi->getIncomingBlock(i) == succ) {
+                        phi->setIncomingBlock(i, block);
+                    }
+                }
+            }
+        }
+
+        if (last) {
+            eraseInst(block, last);
+        }
+
+        auto & insts = block->getInsts();
+        auto & succInsts = succ->getInsts();
+        insts.insert(insts.end(), succInsts.begin() + 1, succInsts.end());
+        succInsts.erase(succInsts.begin() + 1, succInsts.end());
+
+        bool adjacent = succ->getIndex() == block->getIndex() + 1;
+        eraseBlock(succ);
+        if (succNext && !adjacent) {
+            insts.push_back(new GotoInstruction(func, succNext->getLeader()));
+        }
+
+        func->updateCFG();
+        changed = true;
+
+        // 合并后的基本块可能还能继续合并
+        k--;
+    }
+
+    return changed;
+}
+
+///
+/// @brief 删除跳转到线性序列中下一个基本块的无条件跳转
+/// @return true 有改变
+/// @return false 没有改变
+///
+bool SimplifyCFG::removeFallthroughGotos()
+{
+    bool changed = false;
+    auto & blocks = func->getBlocks();
+
+    for (size_t k = 0; k + 1 < blocks.size(); k++) {
+        Instanceof(gotoInst, GotoInstruction *, blocks[k]->getTerminator());
+        if (gotoInst && !gotoInst->getCondiValue() && gotoInst->iftrue == blocks[k + 1]->getLeader()) {
+            eraseInst(blocks[k], gotoInst);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        func->updateCFG();
+    }
+
+    return changed;
+}
+
+///
+/// @brief 删除全部入边上的值都相同的Phi指令，跳转改写后常出现这样的Phi指令
+/// @return true 有改变
+/// @return false 没有改变
+///
+bool SimplifyCFG::foldPhis()
+{
+    bool changed = false;
+
+    for (auto block: func->getBlocks()) {
+        for (auto phi: block->getPhis()) {
+            // 循环中的Phi指令可能以自己为值，忽略
+            Value * same = nullptr;
+            bool trivial = true;
+            for (int32_t k = 0; k < phi->getIncomingCount(); k++) {
+                Value * val = phi->getIncomingValue(k);
+                if (val == phi || val == same) {
+                    continue;
+                }
+                if (same) {
+                    trivial = false;
+                    break;
+                }
+                same = val;
+            }
+            if (!trivial || !same) {
+                continue;
+            }
+
+            phi->replaceAllUseWith(same);
+            eraseInst(block, phi);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,118 @@
+///
+/// @file SimplifyCFG.h
+/// @brief 控制流图化简与分支剪枝
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include "Pass.h"
+
+class BasicBlock;
+class Instruction;
+
+///
+/// @brief 控制流图化简与分支剪枝
+///
+/// IRGenerator产生大量只有Label指令的基本块、只有一条无条件跳转的基本块，
+/// 以及跳转到紧随其后的Label指令的跳转。本遍反复进行以下变换直到不再变化：
+/// 条件为常量或者真假目标相同的条件跳转改为无条件跳转，删除不可达的基本块，
+/// 跳转到空基本块的跳转直接改为跳转到其目标，唯一前驱与唯一后继之间的基本块合并，
+/// 跳转到线性序列中下一个基本块的无条件跳转删除，全部入边上的值都相同的Phi指令删除。
+///
+class SimplifyCFG : public FunctionPass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit SimplifyCFG(Module * _module);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对一个函数进行控制流图化简
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func, AnalysisManager & am) override;
+
+private:
+    ///
+    /// @brief 条件为常量或者真假目标相同的条件跳转改为无条件跳转
+    /// @return true 有改变
+    /// @return false 没有改变
+    ///
+    bool foldBranches();
+
+    ///
+    /// @brief 空基本块的前驱直接跳转到空基本块的后继，空基本块删除
+    /// @return true 有改变
+    /// @return false 没有改变
+    ///
+    bool threadJumps();
+
+    ///
+    /// @brief 尝试把空基本块的前驱改为直接跳转到其后继
+    /// @param block 只有Label指令以及可能的一条无条件跳转指令的基本块
+    /// @return true 成功，基本块已删除
+    /// @return false 不满足条件，没有改变
+    ///
+    bool threadBlock(BasicBlock * block);
+
+    ///
+    /// @brief 唯一后继的唯一前驱是自己时，后继合并到自己
+    /// @return true 有改变
+    /// @return false 没有改变
+    ///
+    bool mergeBlocks();
+
+    ///
+    /// @brief 删除跳转到线性序列中下一个基本块的无条件跳转
+    /// @return true 有改变
+    /// @return false 没有改变
+    ///
+    bool removeFallthroughGotos();
+
+    ///
+    /// @brief 删除全部入边上的值都相同的Phi指令，跳转改写后常出现这样的Phi指令
+    /// @return true 有改变
+    /// @return false 没有改变
+    ///
+    bool foldPhis();
+
+    ///
+    /// @brief 从基本块中删除一条指令并释放
+    /// @param block 基本块
+    /// @param inst 指令
+    ///
+    void eraseInst(BasicBlock * block, Instruction * inst);
+
+    ///
+    /// @brief 从函数中删除基本块并释放，基本块内剩余的指令一并释放
+    /// @param block 基本块
+    ///
+    void eraseBlock(BasicBlock * block);
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func = nullptr;
+};
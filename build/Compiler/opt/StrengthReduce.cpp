@@ -0,0 +1,459 @@
+///
+/// @file StrengthReduce.cpp
+/// @brief 循环归纳变量的强度削弱
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#include <algorithm>
+#include <climits>
+#include <tuple>
+
+#include "StrengthReduce.h"
+#include "Module.h"
+#include "Function.h"
+#include "BasicBlock.h"
+#include "ConstInt.h"
+#include "LoopInfo.h"
+#include "AnalysisManager.h"
+#include "BinaryInstruction.h"
+#include "PhiInstruction.h"
+#include "IntegerType.h"
+#include "ArrayType.h"
+
+///
+/// @brief 按32位补码回绕的乘法
+/// @param a 乘数
+/// @param b 乘数
+/// @return int32_t 积
+///
+static int32_t wrapMul(int32_t a, int32_t b)
+{
+    return (int32_t) ((uint32_t) a * (uint32_t) b);
+}
+
+///
+/// @brief 构造函数
+/// @param _module 模块
+///
+StrengthReduce::StrengthReduce(Module * _module) : FunctionPass(_module)
+{}
+
+///
+/// @brief 获取遍的名字
+/// @return std::string 名字
+///
+std::string StrengthReduce::getName() const
+{
+    return "lsr";
+}
+
+///
+/// @brief 只增删基本块内的指令，不改变控制流图
+/// @return true 控制流图不变
+///
+bool StrengthReduce::preservesCFG() const
+{
+    return true;
+}
+
+///
+/// @brief 对一个函数进行强度削弱
+/// @param func 函数
+/// @param am 分析管理器
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool StrengthReduce::runOnFunction(Function * _func, AnalysisManager & am)
+{
+    func = _func;
+
+    instBlock.clear();
+    for (auto block: func->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            instBlock[inst] = block;
+        }
+    }
+
+    bool changed = false;
+    std::vector<Instruction *> deadInsts;
+
+    for (auto loop: am.getLoopInfo(func).getLoops()) {
+        // 新的初值放在前置块，没有前置块的循环不处理，前置块由licm建立
+        BasicBlock * preheader = loop->getPreheader();
+        if (!preheader) {
+            continue;
+        }
+
+        findInductionVars(loop, preheader);
+        if (ivs.empty()) {
+            continue;
+        }
+
+        // 先找出全部的i * k，再改写，改写时要在循环的基本块内插入指令
+        std::vector<std::tuple<Instruction *, size_t, int32_t>> muls;
+        for (auto block: loop->getBlocks()) {
+            for (auto inst: block->getInsts()) {
+                if (inst->getOp() != IROP(IMUL)) {
+                    continue;
+                }
+
+                for (size_t v = 0; v < ivs.size(); v++) {
+                    Value * lhs = inst->getOperand(0);
+                    Value * rhs = inst->getOperand(1);
+                    if (rhs == ivs[v].phi) {
+                        std::swap(lhs, rhs);
+                    }
+
+                    Instanceof(factor, ConstInt *, rhs);
+                    if (lhs == ivs[v].phi && factor && factor->getVal() != 0 && factor->getVal() != 1) {
+                        muls.emplace_back(inst, v, factor->getVal());
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (auto & item: muls) {
+            Instruction * mul = std::get<0>(item);
+            PhiInstruction * derived = getDerived(ivs[std::get<1>(item)], std::get<2>(item), preheader);
+
+            mul->replaceAllUseWith(derived);
+            mul->clearOperands();
+
+            auto & insts = instBlock[mul]->getInsts();
+            insts.erase(std::find(insts.begin(), insts.end(), mul));
+            deadInsts.push_back(mul);
+            changed = true;
+        }
+
+        if (flattenRows(loop, preheader, deadInsts)) {
+            changed = true;
+        }
+
+        for (auto & iv: ivs) {
+            if (replaceExitTest(iv, loop)) {
+                deadInsts.push_back(iv.phi);
+                deadInsts.push_back(iv.next);
+                changed = true;
+            }
+        }
+    }
+
+    for (auto inst: deadInsts) {
+        inst->clearOperands();
+    }
+    for (auto inst: deadInsts) {
+        delete inst;
+    }
+
+    ivs.clear();
+    instBlock.clear();
+    func = nullptr;
+
+    return changed;
+}
+
+///
+/// @brief 识别循环的基本归纳变量
+/// @param loop 循环
+/// @param preheader 前置块
+///
+void StrengthReduce::findInductionVars(Loop * loop, BasicBlock * preheader)
+{
+    ivs.clear();
+
+    for (auto phi: loop->getHeader()->getPhis()) {
+        if (!phi->getType()->isInt32Type() || phi->getIncomingCount() != 2) {
+            continue;
+        }
+
+        // 一个入边来自前置块，另一个来自循环内的回边
+        int32_t initPos = phi->getIncomingBlock(0) == preheader ? 0 : 1;
+        if (phi->getIncomingBlock(initPos) != preheader || !loop->contains(phi->getIncomingBlock(1 - initPos))) {
+            continue;
+        }
+
+        Instanceof(next, BinaryInstruction *, phi->getIncomingValue(1 - initPos));
+        if (!next) {
+            continue;
+        }
+
+        // 回边上的值为phi + c、c + phi或者phi - c
+        Value * lhs = next->getOperand(0);
+        Value * rhs = next->getOperand(1);
+        if (next->getOp() == IROP(IADD) && rhs == phi) {
+            std::swap(lhs, rhs);
+        }
+
+        Instanceof(step, ConstInt *, rhs);
+        if (lhs != phi || !step) {
+            continue;
+        }
+
+        InductionVar iv;
+        if (next->getOp() == IROP(IADD)) {
+            iv.step = step->getVal();
+        } else if (next->getOp() == IROP(ISUB) && step->getVal() != INT_MIN) {
+            iv.step = -step->getVal();
+        } else {
+            continue;
+        }
+
+        iv.phi = phi;
+        iv.init = phi->getIncomingValue(initPos);
+        iv.next = next;
+        iv.latch = phi->getIncomingBlock(1 - initPos);
+        ivs.push_back(iv);
+    }
+}
+
+///
+/// @brief 获取归纳变量乘以常量再加偏移的导出归纳变量，没有时新建
+/// @param iv 基本归纳变量
+/// @param factor 常量系数
+/// @param preheader 前置块
+/// @param offset 循环不变的偏移，没有时为空
+/// @return PhiInstruction* 导出归纳变量
+///
+PhiInstruction * StrengthReduce::getDerived(InductionVar & iv, int32_t factor, BasicBlock * preheader, Value * offset)
+{
+    auto iter = iv.derived.find({factor, offset});
+    if (iter != iv.derived.end()) {
+        return iter->second;
+    }
+
+    Type * intType = IntegerType::getTypeInt();
+
+    // 初值在前置块计算
+    Value * init;
+    Instanceof(initConst, ConstInt *, iv.init);
+    Instanceof(offsetConst, ConstInt *, offset);
+    if (initConst && (!offset || offsetConst)) {
+        int32_t val = wrapMul(initConst->getVal(), factor);
+        init = module->newConstInt(offset ? (int32_t) ((uint32_t) val + (uint32_t) offsetConst->getVal()) : val);
+    } else {
+        if (initConst) {
+            init = module->newConstInt(wrapMul(initConst->getVal(), factor));
+        } else {
+            auto initInst = new BinaryInstruction(func, IROP(IMUL), iv.init, module->newConstInt(factor), intType);
+            preheader->insertBeforeTerminator(initInst);
+            instBlock[initInst] = preheader;
+            init = initInst;
+        }
+        if (offset) {
+            auto addInst = new BinaryInstruction(func, IROP(IADD), init, offset, intType);
+            preheader->insertBeforeTerminator(addInst);
+            instBlock[addInst] = preheader;
+            init = addInst;
+        }
+    }
+
+    // 新的Phi指令放在循环头已有的Phi指令之后
+    BasicBlock * header = instBlock[iv.phi];
+    auto phi = new PhiInstruction(func, intType);
+    auto & headerInsts = header->getInsts();
+    headerInsts.insert(headerInsts.begin() + 1 + header->getPhis().size(), phi);
+    instBlock[phi] = header;
+
+    // 增量紧跟在基本归纳变量的增量之后
+    auto inc = new BinaryInstruction(func, IROP(IADD), phi, module->newConstInt(wrapMul(iv.step, factor)), intType);
+    auto & nextInsts = instBlock[iv.next]->getInsts();
+    nextInsts.insert(std::find(nextInsts.begin(), nextInsts.end(), iv.next) + 1, inc);
+    instBlock[inc] = instBlock[iv.next];
+
+    phi->addIncoming(init, preheader);
+    phi->addIncoming(inc, iv.latch);
+
+    iv.derived[{factor, offset}] = phi;
+
+    return phi;
+}
+
+///
+/// @brief 以归纳变量为行下标、列下标循环不变的数组寻址展平为导出归纳变量作下标
+/// @param loop 循环
+/// @param preheader 前置块
+/// @param deadInsts 删除的指令
+/// @return true IR有改变
+/// @return false IR没有改变
+///
+bool StrengthReduce::flattenRows(Loop * loop, BasicBlock * preheader, std::vector<Instruction *> & deadInsts)
+{
+    // 找出a[i][j]，即基址为GEP a[i]的GEP，a与j循环不变，i为基本归纳变量。
+    // j为常量时a[i]的地址加上常量偏移即可寻址，a[i][0]、a[i][1]共用a[i]的寄存器，展平反而多了归纳变量
+    std::vector<std::pair<Instruction *, size_t>> geps;
+    for (auto block: loop->getBlocks()) {
+        for (auto inst: block->getInsts()) {
+            if (inst->getOp() != IROP(GEP) || dynamic_cast<ConstInt *>(inst->getOperand(1))) {
+                continue;
+            }
+
+            Instanceof(row, Instruction *, inst->getOperand(0));
+            if (!row || row->getOp() != IROP(GEP) || !isInvariant(row->getOperand(0), loop)
+                || !isInvariant(inst->getOperand(1), loop)) {
+                continue;
+            }
+
+            for (size_t v = 0; v < ivs.size(); v++) {
+                if (row->getOperand(1) == ivs[v].phi) {
+                    geps.emplace_back(inst, v);
+                    break;
+                }
+            }
+        }
+    }
+
+    // GEP的类型是被寻址的数组，a[i][j]是n个元素的一行，a[i]是m行，展平后为m * n个元素的数组
+    std::vector<Instruction *> rows;
+    for (auto & item: geps) {
+        Instruction * gep = item.first;
+        Instruction * row = static_cast<Instruction *>(gep->getOperand(0));
+        auto rowType = static_cast<const ArrayType *>(gep->getType());
+        auto outerType = static_cast<const ArrayType *>(row->getType());
+
+        int32_t factor = (int32_t) rowType->getNumElements();
+        PhiInstruction * index = getDerived(ivs[item.second], factor, preheader, gep->getOperand(1));
+        auto flatType = ArrayType::get(const_cast<Type *>(rowType->getElementType()),
+                                       outerType->getNumElements() * rowType->getNumElements());
+        auto flat = new BinaryInstruction(func, IROP(GEP), row->getOperand(0), index, (Type *) flatType);
+
+        auto & insts = instBlock[gep]->getInsts();
+        insts.insert(std::find(insts.begin(), insts.end(), gep), flat);
+        instBlock[flat] = instBlock[gep];
+
+        gep->replaceAllUseWith(flat);
+        gep->clearOperands();
+        insts.erase(std::find(insts.begin(), insts.end(), gep));
+        deadInsts.push_back(gep);
+
+        if (std::find(rows.begin(), rows.end(), row) == rows.end()) {
+            rows.push_back(row);
+        }
+    }
+
+    // 行地址不再使用时删除，归纳变量少了一个使用，线性函数测试替换后可能也被删除
+    for (auto row: rows) {
+        if (row->getUseList().empty()) {
+            row->clearOperands();
+            auto & insts = instBlock[row]->getInsts();
+            insts.erase(std::find(insts.begin(), insts.end(), row));
+            deadInsts.push_back(row);
+        }
+    }
+
+    return !geps.empty();
+}
+
+///
+/// @brief 值是否在循环内不变，即常量、数组或者循环外定义的指令
+/// @param val 值
+/// @param loop 循环
+/// @return true 不变
+/// @return false 可能改变
+///
+bool StrengthReduce::isInvariant(Value * val, Loop * loop)
+{
+    if (dynamic_cast<ConstInt *>(val) || val->getType()->isArrayType()) {
+        // 数组变量不会被赋值，其地址不变
+        return !dynamic_cast<Instruction *>(val) || !loop->contains(instBlock[static_cast<Instruction *>(val)]);
+    }
+
+    Instanceof(inst, Instruction *, val);
+    return inst && !loop->contains(instBlock[inst]);
+}
+
+///
+/// @brief 循环条件改为导出归纳变量的比较
+/// @param iv 基本归纳变量
+/// @param loop 循环
+/// @return true 进行了替换
+/// @return false 没有改变
+///
+bool StrengthReduce::replaceExitTest(InductionVar & iv, Loop * loop)
+{
+    Instanceof(initConst, ConstInt *, iv.init);
+    if (iv.derived.empty() || !initConst) {
+        return false;
+    }
+
+    // 归纳变量只用于自增与一个比较，增量只用于Phi指令时，替换比较后两者都可删除
+    if (iv.next->getUseList().size() != 1 || iv.phi->getUseList().size() != 2) {
+        return false;
+    }
+
+    Instruction * cmp = nullptr;
+    for (auto use: iv.phi->getUseList()) {
+        auto user = static_cast<Instruction *>(use->getUser());
+        if (user != iv.next) {
+            cmp = user;
+        }
+    }
+
+    if (!cmp || !loop->contains(instBlock[cmp]) || cmp->getOperand(0) != iv.phi) {
+        return false;
+    }
+
+    // 只处理朝着边界前进的有序比较
+    Instanceof(bound, ConstInt *, cmp->getOperand(1));
+    if (!bound) {
+        return false;
+    }
+    switch (cmp->getOp()) {
+        case IROP(ILT):
+        case IROP(ILE):
+            if (iv.step <= 0) {
+                return false;
+            }
+            break;
+        case IROP(IGT):
+        case IROP(IGE):
+            if (iv.step >= 0) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    // 取没有偏移的最小正系数，归纳变量的取值在初值与越过边界一步之间，乘以系数后都不能溢出
+    int32_t factor = 0;
+    for (auto & item: iv.derived) {
+        if (item.first.first > 0 && !item.first.second) {
+            factor = item.first.first;
+            break;
+        }
+    }
+    if (factor == 0) {
+        return false;
+    }
+
+    int64_t init = initConst->getVal();
+    int64_t last = (int64_t) bound->getVal() + iv.step;
+    for (int64_t val: {init, last, (int64_t) bound->getVal()}) {
+        int64_t product = val * factor;
+        if (product < INT_MIN || product > INT_MAX) {
+            return false;
+        }
+    }
+
+    cmp->setOperand(0, iv.derived[{factor, nullptr}]);
+    cmp->setOperand(1, module->newConstInt(bound->getVal() * factor));
+
+    // 原来的归纳变量只剩下相互使用，删除
+    auto & phiInsts = instBlock[iv.phi]->getInsts();
+    phiInsts.erase(std::find(phiInsts.begin(), phiInsts.end(), iv.phi));
+    auto & nextInsts = instBlock[iv.next]->getInsts();
+    nextInsts.erase(std::find(nextInsts.begin(), nextInsts.end(), iv.next));
+
+    return true;
+}
@@ -0,0 +1,157 @@
+///
+/// @file StrengthReduce.h
+/// @brief 循环归纳变量的强度削弱
+///
+/// @author zenglj (zenglj@live.com)
+/// @version 1.0
+/// @date 2026-10-16
+///
+/// @copyright Copyright (c) 2024
+///
+/// @par 修改日志:
+/// <table>
+/// <tr><th>Date       <th>Version <th>Author  <th>Description
+/// <tr><td>2026-10-16 <td>1.0     <td>zenglj  <td>新建
+/// </table>
+///
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Pass.h"
+
+class Instruction;
+class BasicBlock;
+class Value;
+class Loop;
+class PhiInstruction;
+
+///
+/// @brief 循环归纳变量的强度削弱
+///
+/// 基本归纳变量是循环头上形如i = phi [init, 前置块], [i + s, 回边]的Phi指令，s为常量。
+/// 循环内的i * k(k为常量)是导出归纳变量，改为一个初值为init * k、每次迭代加s * k的新Phi指令，
+/// 下标表达式a[i * n + j]中的乘法因此变为加法。
+/// 以i为行下标的数组寻址a[i][j](j为循环不变的变量)同样展平为a[i * n + j]，n为每行的元素个数，
+/// i * n + j是初值为init * n + j、每次迭代加s * n的导出归纳变量，IR没有指针的加法，以此代替指针的递增。
+/// 循环条件是i与常量比较时，进行线性函数测试替换，改为导出归纳变量与常量的比较，
+/// 原来的归纳变量不再使用时删除。
+///
+class StrengthReduce : public FunctionPass {
+
+public:
+    ///
+    /// @brief 构造函数
+    /// @param _module 模块
+    ///
+    explicit StrengthReduce(Module * _module);
+
+    ///
+    /// @brief 获取遍的名字
+    /// @return std::string 名字
+    ///
+    std::string getName() const override;
+
+    ///
+    /// @brief 对一个函数进行强度削弱
+    /// @param func 函数
+    /// @param am 分析管理器
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool runOnFunction(Function * func, AnalysisManager & am) override;
+
+    ///
+    /// @brief 只增删基本块内的指令，不改变控制流图
+    /// @return true 控制流图不变
+    ///
+    bool preservesCFG() const override;
+
+private:
+    ///
+    /// @brief 基本归纳变量
+    ///
+    struct InductionVar {
+
+        /// @brief 循环头上的Phi指令
+        PhiInstruction * phi = nullptr;
+
+        /// @brief 进入循环时的初值
+        Value * init = nullptr;
+
+        /// @brief 每次迭代的增量
+        int32_t step = 0;
+
+        /// @brief 回边上的值，即phi + step
+        Instruction * next = nullptr;
+
+        /// @brief 回边的源基本块
+        BasicBlock * latch = nullptr;
+
+        /// @brief 导出归纳变量，常量系数与循环不变的偏移(没有时为空)到新的Phi指令
+        std::map<std::pair<int32_t, Value *>, PhiInstruction *> derived;
+    };
+
+    ///
+    /// @brief 识别循环的基本归纳变量
+    /// @param loop 循环
+    /// @param preheader 前置块
+    ///
+    void findInductionVars(Loop * loop, BasicBlock * preheader);
+
+    ///
+    /// @brief 获取归纳变量乘以常量再加偏移的导出归纳变量，没有时新建
+    /// @param iv 基本归纳变量
+    /// @param factor 常量系数
+    /// @param preheader 前置块
+    /// @param offset 循环不变的偏移，没有时为空
+    /// @return PhiInstruction* 导出归纳变量
+    ///
+    PhiInstruction * getDerived(InductionVar & iv, int32_t factor, BasicBlock * preheader, Value * offset = nullptr);
+
+    ///
+    /// @brief 以归纳变量为行下标、列下标循环不变的数组寻址展平为导出归纳变量作下标
+    /// @param loop 循环
+    /// @param preheader 前置块
+    /// @param deadInsts 删除的指令
+    /// @return true IR有改变
+    /// @return false IR没有改变
+    ///
+    bool flattenRows(Loop * loop, BasicBlock * preheader, std::vector<Instruction *> & deadInsts);
+
+    ///
+    /// @brief 值是否在循环内不变，即常量、数组或者循环外定义的指令
+    /// @param val 值
+    /// @param loop 循环
+    /// @return true 不变
+    /// @return false 可能改变
+    ///
+    bool isInvariant(Value * val, Loop * loop);
+
+    ///
+    /// @brief 循环条件改为导出归纳变量的比较
+    /// @param iv 基本归纳变量
+    /// @param loop 循环
+    /// @return true 进行了替换
+    /// @return false 没有改变
+    ///
+    bool replaceExitTest(InductionVar & iv, Loop * loop);
+
+    ///
+    /// @brief 函数
+    ///
+    Function * func = nullptr;
+
+    ///
+    /// @brief 当前循环的基本归纳变量
+    ///
+    std::vector<InductionVar> ivs;
+
+    ///
+    /// @brief 指令所在的基本块
+    ///
+    std::map<Instruction *, BasicBlock *> instBlock;
+};
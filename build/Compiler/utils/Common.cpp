@@ -44,4 +44,39 @@ void minic_log_common(int level, const char * content)
         puts(content);
     }
 }
+
+/// @brief 有符号32位整数除以常量时乘法代替除法用的魔数与移位数，商为(x*magic)>>(32+shift)再向0修正
+/// @param d 除数的绝对值，要求不小于2
+/// @param magic 魔数，大于INT32_MAX时为其减去2^32的值
+/// @param shift 移位数
+void signedDivMagic(int32_t d, int32_t * magic, int32_t * shift)
+{
+    // 见Hacker's Delight第10章，找最小的p使得2^p/d的误差不影响商
+    const uint32_t two31 = 0x80000000u;
+    uint32_t ad = (uint32_t) d;
+    uint32_t anc = two31 - 1 - two31 % ad;
+    uint32_t q1 = two31 / anc, r1 = two31 - q1 * anc;
+    uint32_t q2 = two31 / ad, r2 = two31 - q2 * ad;
+    uint32_t delta;
+    int32_t p = 31;
+    do {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad) {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    *magic = (int32_t) (q2 + 1);
+    *shift = p - 32;
+}
 }
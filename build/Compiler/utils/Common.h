@@ -15,6 +15,8 @@
 ///
 #pragma once
 
+#include <stdint.h>
+
 /// @brief 整数变字符串
 /// @param num 无符号数
 /// @return 字符串
@@ -36,6 +38,12 @@ bool isLetterUnderLine(char ch);
 
 void minic_log_common(int level, const char * content);
 
+/// @brief 有符号32位整数除以常量时乘法代替除法用的魔数与移位数，商为(x*magic)>>(32+shift)再向0修正
+/// @param d 除数的绝对值，要求不小于2
+/// @param magic 魔数，大于INT32_MAX时为其减去2^32的值
+/// @param shift 移位数
+void signedDivMagic(int32_t d, int32_t * magic, int32_t * shift);
+
 #define minic_log(level, fmt, args...)                                                                                 \
     do {                                                                                                               \
         char max_buf[1024];                                                                                            \
@@ -0,0 +1,36 @@
+const int N = 3, M = N * 2 - 1;
+const float SCALE = 2.5;
+int a[N + 2 * 4 - 99 / 99] = {1, 2, 33, 4, 5, 6, 7, 8, 9, 10};
+int b[N][M] = {{1, 2}, {3, 4, 5, 6, 7}, 8};
+int guard = 12345;
+float c[N * 2][2] = {{SCALE, -SCALE}, {N / 2, M % 3}};
+int d[M - N][N + 1];
+int e[N] = {M, -M * N, M / N + 1};
+
+int main() {
+    const int K = N + M;
+    int local[K][N - 1] = {{K}, {a[9], b[1][4]}};
+    int i = 0, sum = 0;
+    while (i < N + 2 * 4 - 99 / 99) {
+        sum = sum + a[i];
+        i = i + 1;
+    }
+    putint(sum); putch(10);
+    i = 0;
+    while (i < N) {
+        int j = 0;
+        while (j < M) {
+            putint(b[i][j]); putch(32);
+            d[i % 2][j % 4] = d[i % 2][j % 4] + b[i][j];
+            j = j + 1;
+        }
+        putch(10);
+        i = i + 1;
+    }
+    putint(guard); putch(10);
+    putfloat(c[0][0]); putch(32); putfloat(c[0][1]); putch(32);
+    putfloat(c[1][0]); putch(32); putfloat(c[1][1]); putch(32); putfloat(c[5][1]); putch(10);
+    putint(d[0][0] + d[1][3]); putch(32); putint(e[0] + e[1] + e[2]); putch(10);
+    putint(local[0][0] + local[1][0] + local[1][1] + local[7][1]); putch(10);
+    return K;
+}
@@ -0,0 +1,30 @@
+int a[20][30];
+int b[20][30];
+
+int main()
+{
+    int i = 0;
+    while (i < 20) {
+        int j = 0;
+        while (j < 30) {
+            a[i][j] = i * j;
+            b[i][j] = i + j;
+            j = j + 1;
+        }
+        i = i + 1;
+    }
+
+    int sum = 0;
+    i = 0;
+    while (i < 20) {
+        int j = 0;
+        while (j < 30) {
+            a[i][j] = a[i][j] + b[i][j] * 2;
+            sum = sum + a[i][j];
+            j = j + 1;
+        }
+        i = i + 1;
+    }
+    putint(sum);
+    return sum % 256;
+}
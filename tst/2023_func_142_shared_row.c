@@ -0,0 +1,11 @@
+int c[10][10];
+int f(int i, int j, int k)
+{
+    c[i][j] = c[i][j] + c[i][k] * c[k][j];
+    return c[i][j];
+}
+int main()
+{
+    c[2][3] = 4; c[2][5] = 6; c[5][3] = 7;
+    return f(2, 3, 5);
+}
@@ -0,0 +1,21 @@
+int m[6][5] = {{1, 2, 3, 4, 5}, {6, 7, 8, 9, 10}, {11, 12, 13, 14, 15},
+               {16, 17, 18, 19, 20}, {21, 22, 23, 24, 25}, {26, 27, 28, 29, 30}};
+
+int main()
+{
+    int sum = 0;
+    int j = 0;
+    while (j < 5) {
+        int col = 0;
+        int k = 0;
+        while (k < 6) {
+            col = col + m[k][j] * (k + 1);
+            k = k + 1;
+        }
+        putint(col);
+        putch(10);
+        sum = sum + col;
+        j = j + 1;
+    }
+    return sum % 256;
+}
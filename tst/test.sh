@@ -40,6 +40,17 @@ ls *.c | (
         (qemu-aarch64-static $TMPD/$NAME < $INPUT; echo "\n$?")\
             | awk NF \
             | diff $NAME.out /dev/stdin
+        # 生成代码的检查：每行为“个数 正则式”，-O2的汇编中匹配的行数须相符
+        if [ -f $NAME.chk ]; then
+            ../build/compiler -S -O2 -o $TMPD/$NAME.s $NAME.c
+            while read -r COUNT PATTERN;
+            do
+                FOUND=`grep -cE "$PATTERN" $TMPD/$NAME.s`
+                if [ "$FOUND" != "$COUNT" ]; then
+                    echo " \033[31m$PATTERN: $FOUND != $COUNT\033[0m"
+                fi
+            done < $NAME.chk
+        fi
         echo ' \e[32mOK\e[0m'
     done
 )